@@ -1,13 +1,11 @@
 #!/bin/bash
 
-cp ../../sparse_matrix/coo2csr_lib.f90 .
 cp ../../solver/pardiso/libpardiso600-MACOS-X86-64.dylib .
 cp ../../solver/pardiso/pardiso.lic .
 cp ../../seisfem/seisfem.c .
-gfortran -c coo2csr_lib.f90
 gcc -fopenmp -c seisfem.c -lm
-gcc  -o seisfem seisfem.o coo2csr_lib.o -L /Users/haipeng/Desktop/seisfem/solver/pardiso/lib/ -lpardiso600-MACOS-X86-64 -I/Users/haipeng/Desktop/seisfem/solver/SuperLU_5.2.1/SRC/ /Users/haipeng/Desktop/seisfem/solver/SuperLU_5.2.1/lib/libsuperlu_5.2.1.a /Users/haipeng/Desktop/seisfem/solver/SuperLU_5.2.1/lib/libblas.a -fopenmp -lgfortran -lm
-#  -lgfortran and -lm link math packages
+gcc  -o seisfem seisfem.o -L /Users/haipeng/Desktop/seisfem/solver/pardiso/lib/ -lpardiso600-MACOS-X86-64 -I/Users/haipeng/Desktop/seisfem/solver/SuperLU_5.2.1/SRC/ /Users/haipeng/Desktop/seisfem/solver/SuperLU_5.2.1/lib/libsuperlu_5.2.1.a /Users/haipeng/Desktop/seisfem/solver/SuperLU_5.2.1/lib/libblas.a -fopenmp -lm
+#  -lm links the math package
 
 
 if [ $? -ne 0 ]; then
@@ -19,8 +17,5 @@ fi
 
 rm seisfem.c
 rm seisfem.o
-rm coo2csr_lib.o
-rm coo2csr_lib.f90
-rm coo2csr_lib.mod
 rm libpardiso600-MACOS-X86-64.dylib
 rm pardiso.lic
@@ -4,6 +4,8 @@
 #include "../shape/shape_q4.c"
 #include "../shape/shape_q9.c"
 #include "../shape/shape_q16.c"
+#include "../shape/shape_table.c"
+#include "../shape/quadrature_rule.c"
 #include "mass_sparse_t3.c"
 #include "mass_sparse_t6.c"
 #include "mass_sparse_t10.c"
@@ -11,13 +13,15 @@
 #include "mass_sparse_q9.c"
 #include "mass_sparse_q16.c"
 void mass_sparse_all(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, double *rho, 
-                     int *mass_coo_i, int *mass_coo_j, double *mass_coo_x, int lumpflag)
+                     int csr_size, int *scatter_map, double *mass_csr_x, int lumpflag)
 
 /******************************************************************************/
 /*
   Purpose:
 
-   mass_sparse_all computes the mass matrix, store the matrix in the coo format (i, j, x), according to the element type
+   mass_sparse_all computes the mass matrix in the csr pattern given by csr_pattern, according to the element type.
+   scatter_map (from csr_scatter_map) gives the csr position of every element matrix entry.
+   With lumpflag = 1 the lumped (diagonal) mass of size node_num is returned instead.
 
   List:
 
@@ -35,27 +39,27 @@ void mass_sparse_all(char *type, int node_num, int element_num, int element_orde
 
   if (strcmp(type, "T3") == 0)
   {
-    mass_sparse_t3(node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, lumpflag);
+    mass_sparse_t3(node_num, element_num, element_order, element_node, node_xy, rho, csr_size, scatter_map, mass_csr_x, lumpflag);
   }
   else if (strcmp(type, "T6") == 0)
   {
-    mass_sparse_t6(node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, lumpflag);
+    mass_sparse_t6(node_num, element_num, element_order, element_node, node_xy, rho, csr_size, scatter_map, mass_csr_x, lumpflag);
   }
   else if (strcmp(type, "T10") == 0)
   {
-    mass_sparse_t10(node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, lumpflag);
+    mass_sparse_t10(node_num, element_num, element_order, element_node, node_xy, rho, csr_size, scatter_map, mass_csr_x, lumpflag);
   }
   else if (strcmp(type, "Q4") == 0)
   {
-    mass_sparse_q4(node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, lumpflag);
+    mass_sparse_q4(node_num, element_num, element_order, element_node, node_xy, rho, csr_size, scatter_map, mass_csr_x, lumpflag);
   }
   else if (strcmp(type, "Q9") == 0)
   {
-    mass_sparse_q9(node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, lumpflag);
+    mass_sparse_q9(node_num, element_num, element_order, element_node, node_xy, rho, csr_size, scatter_map, mass_csr_x, lumpflag);
   }
   else if (strcmp(type, "Q16") == 0)
   {
-    mass_sparse_q16(node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, lumpflag);
+    mass_sparse_q16(node_num, element_num, element_order, element_node, node_xy, rho, csr_size, scatter_map, mass_csr_x, lumpflag);
   }
   else
   {
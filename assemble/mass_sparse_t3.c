@@ -1,7 +1,6 @@
+void mass_sparse_t3(int node_num, int element_num, int element_order, int *element_node, double **node_xy, double *rho, int csr_size, int *scatter_map, double *mass, int lumpflag)
 
-void mass_sparse_t3(int node_num, int element_num, int element_order, int *element_node, double **node_xy, double *rho, int *mi, int *mj, double *mass, int lumpflag)
-
-/* mass_sparse_t3 computes the mass matrix, store the matrix in the coo format (i,j,value), using 3-node triangles, 3 ponits quadrature rule.
+/* mass_sparse_t3 computes the mass matrix, add the element matrices into the csr values through scatter_map (see csr_scatter_map), using 3-node triangles, 3 points quadrature rule (exact for phi * phi).
 
   Reference Element T3:
 
@@ -20,85 +19,37 @@ void mass_sparse_t3(int node_num, int element_num, int element_order, int *eleme
 
 */
 {
-    int quad_num = 12;
-    int i, j, iq, jq, ip, jp, element, quad, coo_index;
+    int quad_num;
+    int i, iq, jq, ip, jp, element, quad, map_index;
     int p1, p2, p3;
-    double r, s;
     double rtab[12], stab[12], weight[12];
-    double w[3], dwdr[3], dwds[3];
-    double phi[3], dphidx[3], dphidy[3];
+    double phi_tab[12 * 3], dwdr_tab[12 * 3], dwds_tab[12 * 3];
+    double *phi;
+    double mass_local[3 * 3];
     double x1, x2, x3, y1, y2, y3;
-    double area, det;
-    double drdx, drdy, dsdx, dsdy;
-    double a, b, c, d, e, f, g, uu, vv, ww;
+    double area, wq;
     double mass_sum = 0.0;
     double diag_sum = 0.0;
 
-    a = 0.87382197101699600;
-    b = 0.06308901449150200;
-    c = 0.50142650965817900;
-    d = 0.24928674517091000;
-    e = 0.63650249912139900;
-    f = 0.31035245103378500;
-    g = 0.05314504984481600;
-    uu = 0.05084490637020700;
-    vv = 0.11678627572637900;
-    ww = 0.08285107561837400;
-
-    rtab[0] = a;
-    rtab[1] = b;
-    rtab[2] = b;
-    rtab[3] = c;
-    rtab[4] = d;
-    rtab[5] = d;
-    rtab[6] = e;
-    rtab[7] = e;
-    rtab[8] = f;
-    rtab[9] = f;
-    rtab[10] = g;
-    rtab[11] = g;
-
-    stab[0] = b;
-    stab[1] = a;
-    stab[2] = b;
-    stab[3] = d;
-    stab[4] = c;
-    stab[5] = d;
-    stab[6] = f;
-    stab[7] = g;
-    stab[8] = e;
-    stab[9] = g;
-    stab[10] = e;
-    stab[11] = f;
-
-    weight[0] = uu;
-    weight[1] = uu;
-    weight[2] = uu;
-    weight[3] = vv;
-    weight[4] = vv;
-    weight[5] = vv;
-    weight[6] = ww;
-    weight[7] = ww;
-    weight[8] = ww;
-    weight[9] = ww;
-    weight[10] = ww;
-    weight[11] = ww;
-
-    coo_index = 0; // for coo format sparse matrix index
+    // phi * phi is of degree 2, tabulate the reference shape functions once
+    quad_num = quadrature_rule("T3", 2, rtab, stab, weight);
+    shape_table("T3", element_order, quad_num, rtab, stab, phi_tab, dwdr_tab, dwds_tab);
 
-    for (i = 0; i < element_num * element_order * element_order; i++)
+    if (lumpflag == 1)
     {
-        mi[i] = 0;
-        mj[i] = 0;
-        mass[i] = 0.0;
+        for (i = 0; i < node_num; i++)
+            mass[i] = 0.0;
+    }
+    else
+    {
+        for (i = 0; i < csr_size; i++)
+            mass[i] = 0.0;
     }
-
     for (element = 0; element < element_num * element_order; element = element + element_order)
     {
         p1 = element_node[0 + element] - 1;
         p2 = element_node[1 + element] - 1;
         p3 = element_node[2 + element] - 1;
-
         x1 = node_xy[0][p1];
         y1 = node_xy[1][p1];
         x2 = node_xy[0][p2];
@@ -115,30 +66,14 @@ void mass_sparse_t3(int node_num, int element_num, int element_order, int *eleme
             exit(1);
         }
 
-        det = (x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1);
-        drdx = (y3 - y1) / det;
-        drdy = (x1 - x3) / det;
-        dsdx = (y1 - y2) / det;
-        dsdy = (x2 - x1) / det;
+        for (i = 0; i < element_order * element_order; i++)
+            mass_local[i] = 0.0;
 
         // For each quadrature point in the element...
         for (quad = 0; quad < quad_num; quad++)
         {
-            r = rtab[quad];
-            s = stab[quad];
-            shape_t3(r, s, w, dwdr, dwds);
-
-            phi[0] = w[0];
-            phi[1] = w[1];
-            phi[2] = w[2];
-
-            dphidx[0] = dwdr[0] * drdx + dwds[0] * dsdx;
-            dphidx[1] = dwdr[1] * drdx + dwds[1] * dsdx;
-            dphidx[2] = dwdr[2] * drdx + dwds[2] * dsdx;
-
-            dphidy[0] = dwdr[0] * drdy + dwds[0] * dsdy;
-            dphidy[1] = dwdr[1] * drdy + dwds[1] * dsdy;
-            dphidy[2] = dwdr[2] * drdy + dwds[2] * dsdy;
+            phi = phi_tab + quad * element_order;
+            wq = area * weight[quad];
 
             for (iq = 0; iq < element_order; iq++)
             {
@@ -148,25 +83,29 @@ void mass_sparse_t3(int node_num, int element_num, int element_order, int *eleme
                     jp = element_node[jq + element] - 1; // c array from 0
                     if (lumpflag == 1)
                     {
-                        mass_sum = mass_sum + area * weight[quad] * rho[ip] * phi[iq] * phi[jq];
+                        mass_sum = mass_sum + wq * rho[ip] * phi[iq] * phi[jq];
                         if (ip == jp)
                         {
-                            diag_sum = diag_sum + area * weight[quad] * rho[ip] * phi[iq] * phi[jq];
-                            mass[ip] = mass[ip] + area * weight[quad] * rho[ip] * phi[iq] * phi[jq]; 
+                            diag_sum = diag_sum + wq * rho[ip] * phi[iq] * phi[jq];
+                            mass[ip] = mass[ip] + wq * rho[ip] * phi[iq] * phi[jq];
                         }
                     }
                     else
                     {
-                        coo_index = element * element_order + iq * element_order + jq;
-                        mi[coo_index] = ip;
-                        mj[coo_index] = jp;
-                        mass[coo_index] = mass[coo_index] + area * weight[quad] * rho[ip] * phi[iq] * phi[jq];
+                        mass_local[iq * element_order + jq] = mass_local[iq * element_order + jq] + wq * rho[ip] * phi[iq] * phi[jq];
                     }
                 }
             }
         }
-    }
 
+        if (lumpflag != 1)
+        {
+            // element already counts element_order, so this is element_index * element_order^2
+            map_index = element * element_order;
+            for (i = 0; i < element_order * element_order; i++)
+                mass[scatter_map[map_index + i]] = mass[scatter_map[map_index + i]] + mass_local[i];
+        }
+    }
     if (lumpflag == 1)
     {
         for (i = 0; i < node_num; i++)
@@ -0,0 +1,45 @@
+void mass_sparse_update(int node_num, int *csr_p, int *csr_j, double *mass_unit_x, double *rho, double *mass_csr_x, double *mass_lump)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mass_sparse_update refreshes the mass matrix and the lumped mass for a new density, without
+    going through the elements again.
+
+    The element mass is rho[ip] * phi[iq] * phi[jq] with ip the row node, so every row of the
+    mass matrix is the same row of the unit density mass (mass_unit_x, from elastic_operator)
+    times rho of that row. The lumped mass keeps the row diagonal scaled by mass_sum / diag_sum,
+    as in mass_sparse_t3 ... mass_sparse_q16 with lumpflag = 1.
+
+  Input:
+    csr_p, csr_j : csr pattern
+    mass_unit_x  : mass matrix with rho = 1
+    rho          : density, size node_num
+
+  Output:
+    mass_csr_x   : mass matrix, same pattern
+    mass_lump    : lumped mass, size node_num
+*/
+{
+    int i, k;
+    double mass_sum = 0.0;
+    double diag_sum = 0.0;
+
+    #pragma omp parallel for private(i, k) reduction(+ : mass_sum, diag_sum)
+    for (i = 0; i < node_num; i++)
+    {
+        mass_lump[i] = 0.0;
+        for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+        {
+            mass_csr_x[k] = rho[i] * mass_unit_x[k];
+            mass_sum = mass_sum + mass_csr_x[k];
+            if (csr_j[k] == i)
+                mass_lump[i] = mass_csr_x[k];
+        }
+        diag_sum = diag_sum + mass_lump[i];
+    }
+
+    #pragma omp parallel for private(i)
+    for (i = 0; i < node_num; i++)
+        mass_lump[i] = mass_lump[i] * mass_sum / diag_sum;
+}
@@ -5,13 +5,14 @@
 #include "stiffness_sparse_q9.c"
 #include "stiffness_sparse_q16.c"
 
-void stif_sparse_all(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, int *stiffi, int *stiffj, double *stiffness, int stif_type)
+void stif_sparse_all(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, int csr_size, int *scatter_map, double *stiffness, int stif_type)
 
 /******************************************************************************/
 /*
   Purpose:
 
-   stiffness_sparse_all computes the stiffness matrix, store the matrix in the coo format (i,j,value), according to the element type
+   stiffness_sparse_all computes the stiffness matrix in the csr pattern given by csr_pattern, according to the element type.
+   scatter_map (from csr_scatter_map) gives the csr position of every element matrix entry.
 
   List:
 
@@ -29,27 +30,27 @@ void stif_sparse_all(char *type, int node_num, int element_num, int element_orde
 
   if (strcmp(type, "T3") == 0)
   {
-    stiffness_sparse_t3(node_num, element_num, element_order, element_node, node_xy, stiffi, stiffj, stiffness, stif_type);
+    stiffness_sparse_t3(node_num, element_num, element_order, element_node, node_xy, csr_size, scatter_map, stiffness, stif_type);
   }
   else if (strcmp(type, "T6") == 0)
   {
-    stiffness_sparse_t6(node_num, element_num, element_order, element_node, node_xy, stiffi, stiffj, stiffness, stif_type);
+    stiffness_sparse_t6(node_num, element_num, element_order, element_node, node_xy, csr_size, scatter_map, stiffness, stif_type);
   }
   else if (strcmp(type, "T10") == 0)
   {
-    stiffness_sparse_t10(node_num, element_num, element_order, element_node, node_xy, stiffi, stiffj, stiffness, stif_type);
+    stiffness_sparse_t10(node_num, element_num, element_order, element_node, node_xy, csr_size, scatter_map, stiffness, stif_type);
   }
   else if (strcmp(type, "Q4") == 0)
   {
-    stiffness_sparse_q4(node_num, element_num, element_order, element_node, node_xy, stiffi, stiffj, stiffness, stif_type);
+    stiffness_sparse_q4(node_num, element_num, element_order, element_node, node_xy, csr_size, scatter_map, stiffness, stif_type);
   }
   else if (strcmp(type, "Q9") == 0)
   {
-    stiffness_sparse_q9(node_num, element_num, element_order, element_node, node_xy, stiffi, stiffj, stiffness, stif_type);
+    stiffness_sparse_q9(node_num, element_num, element_order, element_node, node_xy, csr_size, scatter_map, stiffness, stif_type);
   }
   else if (strcmp(type, "Q16") == 0)
   {
-    stiffness_sparse_q16(node_num, element_num, element_order, element_node, node_xy, stiffi, stiffj, stiffness, stif_type);
+    stiffness_sparse_q16(node_num, element_num, element_order, element_node, node_xy, csr_size, scatter_map, stiffness, stif_type);
   }
   else
   {
@@ -0,0 +1,19 @@
+unsigned long long fnv1a_hash(unsigned long long hash, const void *data, size_t size)
+/******************************************************************************/
+/*
+  Purpose:
+
+    fnv1a_hash adds size bytes of data to the 64 bit FNV-1a hash. Start from
+    hash = 14695981039346656037ULL and chain the calls to hash several arrays.
+*/
+{
+  size_t i;
+  const unsigned char *byte = (const unsigned char *)data;
+
+  for (i = 0; i < size; i++)
+  {
+    hash = hash ^ byte[i];
+    hash = hash * 1099511628211ULL;
+  }
+  return hash;
+}
@@ -0,0 +1,46 @@
+size_t operator_cache_layout(int node_num, int csr_size, size_t *offset)
+/******************************************************************************/
+/*
+  Purpose:
+
+    operator_cache_layout gives the byte offset of every section of an operator cache file
+    and returns the file size. Every section starts on a 64 byte boundary, so the file can
+    be mapped with mmap and the arrays used in place.
+
+  Layout:
+
+    I   SECTION          TYPE     SIZE
+    --  ---------------  -------  ------------
+    -   header           long     8
+    0   csr_p            int      node_num + 1
+    1   csr_j            int      csr_size
+    2   mass_unit_x      double   csr_size
+    3   mass_csr_x       double   csr_size
+    4   stif1-6_csr_x    double   6 * csr_size
+    10  mass_lump        double   node_num
+    11  mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy
+                         double   6 * node_num
+
+    header: magic, version, key, node_num, csr_size, file size, 0, 0
+*/
+{
+  int k;
+  size_t size[17];
+  size_t pos;
+
+  size[0] = (size_t)(node_num + 1) * sizeof(int);
+  size[1] = (size_t)csr_size * sizeof(int);
+  for (k = 2; k < 10; k++)
+    size[k] = (size_t)csr_size * sizeof(double);
+  for (k = 10; k < 17; k++)
+    size[k] = (size_t)node_num * sizeof(double);
+
+  pos = 8 * sizeof(long long);
+  for (k = 0; k < 17; k++)
+  {
+    pos = (pos + 63) / 64 * 64;
+    offset[k] = pos;
+    pos = pos + size[k];
+  }
+  return pos;
+}
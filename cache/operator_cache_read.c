@@ -0,0 +1,63 @@
+void *operator_cache_read(char *filename, unsigned long long key, int node_num, int *csr_size, size_t *map_size, int **csr_p, int **csr_j,
+                          double **mass_unit_x, double **mass_csr_x, double **stif_csr_x, double **mass_lump,
+                          double **mpml_dx, double **mpml_dy, double **mpml_dxx, double **mpml_dyy, double **mpml_dxx_pyx, double **mpml_dyy_pxy)
+/******************************************************************************/
+/*
+  Purpose:
+
+    operator_cache_read maps an operator cache file written by operator_cache_write and points
+    the arrays into the mapping, nothing is copied or assembled. The mapping is private, so the
+    arrays can still be changed in memory (e.g. by mass_sparse_update) without touching the file.
+
+    Return the mapping, to be released with munmap(map, map_size) instead of freeing the arrays,
+    or NULL when the file does not exist or does not match key and node_num.
+*/
+{
+  int k;
+  int fd;
+  long long *header;
+  size_t offset[17];
+  size_t file_size;
+  struct stat file_stat;
+  char *map;
+
+  if ((fd = open(filename, O_RDONLY)) < 0)
+    return NULL;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size < (off_t)(8 * sizeof(long long)))
+  {
+    close(fd);
+    return NULL;
+  }
+  map = (char *)mmap(NULL, (size_t)file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+    return NULL;
+
+  header = (long long *)map;
+  file_size = operator_cache_layout(node_num, (int)header[4], offset);
+  if (header[0] != 0x3143504f4d454653LL || header[1] != 1 || (unsigned long long)header[2] != key || header[3] != node_num ||
+      header[5] != (long long)file_size || (size_t)file_stat.st_size != file_size)
+  {
+    printf("\n operator cache %s does not match this run, it is rebuilt\n", filename);
+    munmap(map, (size_t)file_stat.st_size);
+    return NULL;
+  }
+
+  *csr_size = (int)header[4];
+  *map_size = file_size;
+  *csr_p = (int *)(map + offset[0]);
+  *csr_j = (int *)(map + offset[1]);
+  *mass_unit_x = (double *)(map + offset[2]);
+  *mass_csr_x = (double *)(map + offset[3]);
+  for (k = 0; k < 6; k++)
+    stif_csr_x[k] = (double *)(map + offset[4 + k]);
+  *mass_lump = (double *)(map + offset[10]);
+  *mpml_dx = (double *)(map + offset[11]);
+  *mpml_dy = (double *)(map + offset[12]);
+  *mpml_dxx = (double *)(map + offset[13]);
+  *mpml_dyy = (double *)(map + offset[14]);
+  *mpml_dxx_pyx = (double *)(map + offset[15]);
+  *mpml_dyy_pxy = (double *)(map + offset[16]);
+
+  return map;
+}
@@ -0,0 +1,75 @@
+void operator_cache_write(char *filename, unsigned long long key, int node_num, int csr_size, int *csr_p, int *csr_j,
+                          double *mass_unit_x, double *mass_csr_x, double **stif_csr_x, double *mass_lump,
+                          double *mpml_dx, double *mpml_dy, double *mpml_dxx, double *mpml_dyy, double *mpml_dxx_pyx, double *mpml_dyy_pxy)
+/******************************************************************************/
+/*
+  Purpose:
+
+    operator_cache_write saves the assembled operator, the lumped mass and the mpml profiles
+    in the binary layout of operator_cache_layout, so the next run with the same key can map
+    them with operator_cache_read instead of assembling again.
+
+    The file is written to filename.tmp and renamed at the end, so a run that stops half way
+    never leaves a broken cache behind.
+*/
+{
+  int k;
+  long long header[8];
+  size_t offset[17];
+  size_t file_size;
+  char filename_temp[256];
+  void *section[17];
+  FILE *fp_cache;
+
+  file_size = operator_cache_layout(node_num, csr_size, offset);
+
+  header[0] = 0x3143504f4d454653LL; // "SFEMOPC1"
+  header[1] = 1;
+  header[2] = (long long)key;
+  header[3] = node_num;
+  header[4] = csr_size;
+  header[5] = (long long)file_size;
+  header[6] = 0;
+  header[7] = 0;
+
+  section[0] = csr_p;
+  section[1] = csr_j;
+  section[2] = mass_unit_x;
+  section[3] = mass_csr_x;
+  for (k = 0; k < 6; k++)
+    section[4 + k] = stif_csr_x[k];
+  section[10] = mass_lump;
+  section[11] = mpml_dx;
+  section[12] = mpml_dy;
+  section[13] = mpml_dxx;
+  section[14] = mpml_dyy;
+  section[15] = mpml_dxx_pyx;
+  section[16] = mpml_dyy_pxy;
+
+  sprintf(filename_temp, "%s.tmp", filename);
+  if ((fp_cache = fopen(filename_temp, "wb")) == NULL)
+  {
+    printf("\n operator cache %s cannot open, the operator is not cached\n", filename_temp);
+    return;
+  }
+  fwrite(header, sizeof(long long), 8, fp_cache);
+  for (k = 0; k < 17; k++)
+  {
+    // zero padding up to the 64 byte boundary of the section
+    while (ftell(fp_cache) < (long)offset[k])
+      fputc(0, fp_cache);
+    if (k < 2)
+      fwrite(section[k], sizeof(int), (k == 0) ? node_num + 1 : csr_size, fp_cache);
+    else
+      fwrite(section[k], sizeof(double), (k < 10) ? csr_size : node_num, fp_cache);
+  }
+  if (ftell(fp_cache) != (long)file_size)
+  {
+    fclose(fp_cache);
+    remove(filename_temp);
+    printf("\n operator cache %s is not complete, the operator is not cached\n", filename_temp);
+    return;
+  }
+  fclose(fp_cache);
+  rename(filename_temp, filename);
+}
@@ -0,0 +1,41 @@
+unsigned long long operator_hash(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy,
+                                 double *rho, double *vp, double *vs, double **c, int pml_nx, int pml_ny, double edge_size,
+                                 int edge_num, int *edge_tag, int pml_profile)
+/******************************************************************************/
+/*
+  Purpose:
+
+    operator_hash returns the key of the operator cache: a hash of everything the cached arrays
+    depend on, i.e. the mesh (type, element_node, node_xy), the model (rho, vp, vs, c11, c13,
+    c33, c44) and the mpml settings (the boundary edge tags of mesh_boundary_tag and
+    pml_profile included). Sources, receivers, f0, dt and step are not part of it.
+*/
+{
+  int i;
+  int head[5];
+  double pml_par[1];
+  unsigned long long hash = 14695981039346656037ULL;
+
+  head[0] = node_num;
+  head[1] = element_num;
+  head[2] = element_order;
+  head[3] = pml_nx;
+  head[4] = pml_ny;
+  pml_par[0] = edge_size;
+
+  hash = fnv1a_hash(hash, type, strlen(type));
+  hash = fnv1a_hash(hash, head, sizeof(head));
+  hash = fnv1a_hash(hash, pml_par, sizeof(pml_par));
+  hash = fnv1a_hash(hash, edge_tag, (size_t)edge_num * sizeof(int));
+  hash = fnv1a_hash(hash, &pml_profile, sizeof(int));
+  hash = fnv1a_hash(hash, element_node, (size_t)element_num * element_order * sizeof(int));
+  hash = fnv1a_hash(hash, node_xy[0], (size_t)node_num * sizeof(double));
+  hash = fnv1a_hash(hash, node_xy[1], (size_t)node_num * sizeof(double));
+  hash = fnv1a_hash(hash, rho, (size_t)node_num * sizeof(double));
+  hash = fnv1a_hash(hash, vp, (size_t)node_num * sizeof(double));
+  hash = fnv1a_hash(hash, vs, (size_t)node_num * sizeof(double));
+  for (i = 0; i < 4; i++)
+    hash = fnv1a_hash(hash, c[i], (size_t)node_num * sizeof(double));
+
+  return hash;
+}
@@ -0,0 +1,61 @@
+int element_vertex(char *type, int *vertex)
+/******************************************************************************/
+/*
+  Purpose:
+
+    element_vertex gives the local index of the corner nodes of an element, the ones the
+    assembly takes for the geometry of the element (straight sided, affine for T*,
+    bilinear for Q*), and returns their number (3 or 4).
+
+  List:
+
+    ELEMENT_TYPE   VERTEX
+    ------------   -----------
+    T3, T6         0, 1, 2
+    T10            0, 3, 6        (node order of mesh_element_t10)
+    Q4, Q9         0, 1, 2, 3
+    Q16            0, 3, 15, 12
+*/
+{
+  int vertex_num;
+
+  if (strcmp(type, "T3") == 0 || strcmp(type, "T6") == 0)
+  {
+    vertex_num = 3;
+    vertex[0] = 0;
+    vertex[1] = 1;
+    vertex[2] = 2;
+  }
+  else if (strcmp(type, "T10") == 0)
+  {
+    vertex_num = 3;
+    vertex[0] = 0;
+    vertex[1] = 3;
+    vertex[2] = 6;
+  }
+  else if (strcmp(type, "Q4") == 0 || strcmp(type, "Q9") == 0)
+  {
+    vertex_num = 4;
+    vertex[0] = 0;
+    vertex[1] = 1;
+    vertex[2] = 2;
+    vertex[3] = 3;
+  }
+  else if (strcmp(type, "Q16") == 0)
+  {
+    vertex_num = 4;
+    vertex[0] = 0;
+    vertex[1] = 3;
+    vertex[2] = 15;
+    vertex[3] = 12;
+  }
+  else
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "ELEMENT_VERTEX - Fatal error!\n");
+    fprintf(stderr, "  Illegal value of type = \"%s\".\n", type);
+    exit(1);
+  }
+
+  return vertex_num;
+}
@@ -0,0 +1,21 @@
+int gmsh_element_node_num(int gmsh_type)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_element_node_num returns the number of nodes of a Gmsh element type, used to
+    read (or skip) the elements of any dimension. An unknown type is a fatal error.
+*/
+{
+  static const int node_num[38] = {0, 2, 3, 4, 4, 8, 6, 5, 3, 6, 9, 10, 27, 18, 14, 1, 8, 20, 15, 13,
+                                   9, 10, 12, 15, 15, 21, 4, 5, 6, 20, 35, 56, 0, 0, 0, 0, 16, 25};
+
+  if (gmsh_type < 1 || gmsh_type > 37 || node_num[gmsh_type] == 0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "GMSH_ELEMENT_NODE_NUM - Fatal error!\n");
+    fprintf(stderr, "  Gmsh element type %d is not supported.\n", gmsh_type);
+    exit(1);
+  }
+  return node_num[gmsh_type];
+}
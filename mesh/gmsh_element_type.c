@@ -0,0 +1,72 @@
+int gmsh_element_type(int gmsh_type, int *node_order)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_element_type returns the seisfem type_code of a Gmsh 2D element type (0 for a type
+    seisfem does not have) and node_order, the node ordering from Gmsh to the reference
+    elements used by the assembly: seisfem node i is Gmsh node node_order[i].
+
+  List:
+
+    GMSH  TYPE_CODE  ELEMENT_TYPE
+    ----  ---------  ------------
+    2     1          T3     vertices
+    9     2          T6     vertices, edge midpoints 1-2, 2-3, 3-1: same order
+    21    3          T10    Gmsh: vertices, 2 nodes on each edge, centre;
+                            seisfem: edge by edge as mesh_element_t10, i.e. vertices 1, 2, 3
+                            at 0, 3, 6 and the centre last
+    3     4          Q4     vertices
+    10    5          Q9     vertices, edge midpoints, centre: same order
+    36    6          Q16    Gmsh: vertices, 2 nodes on each edge, 4 inner nodes;
+                            seisfem: row by row from the 1-2 edge (see shape_q16)
+*/
+{
+  int i;
+  int type_code = 0;
+  int element_order = 0;
+  static const int order_t10[10] = {0, 3, 4, 1, 5, 6, 2, 7, 8, 9};
+  static const int order_q16[16] = {0, 4, 5, 1, 11, 12, 13, 6, 10, 15, 14, 7, 3, 9, 8, 2};
+
+  if (gmsh_type == 2)
+  {
+    type_code = 1;
+    element_order = 3;
+  }
+  else if (gmsh_type == 9)
+  {
+    type_code = 2;
+    element_order = 6;
+  }
+  else if (gmsh_type == 21)
+  {
+    type_code = 3;
+    element_order = 10;
+  }
+  else if (gmsh_type == 3)
+  {
+    type_code = 4;
+    element_order = 4;
+  }
+  else if (gmsh_type == 10)
+  {
+    type_code = 5;
+    element_order = 9;
+  }
+  else if (gmsh_type == 36)
+  {
+    type_code = 6;
+    element_order = 16;
+  }
+
+  for (i = 0; i < element_order; i++)
+  {
+    if (type_code == 3)
+      node_order[i] = order_t10[i];
+    else if (type_code == 6)
+      node_order[i] = order_q16[i];
+    else
+      node_order[i] = i;
+  }
+  return type_code;
+}
@@ -0,0 +1,329 @@
+int gmsh_read(char *filename, int *node_num, int *element_num, int **element_node, double **node_xy,
+              int *edge_num, int **edge_node, int **edge_physical, int *physical_num, int **physical_tag, char ***physical_name)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_read reads a Gmsh mesh file of format 4.1, ascii or binary, and returns the
+    seisfem type_code of its 2D elements (T3, T6, T10, Q4, Q9, Q16, see gmsh_element_type).
+    The file is read as a stream, section after section; only the arrays below are kept.
+
+    - the 2D elements become element_node, in the node order of the shape/ elements;
+    - the nodes of the 2D elements are numbered in the order of $Nodes, from 1, z is dropped;
+    - the 1D elements of the curves that have a physical group become boundary edges:
+      edge_node (the 2 end nodes, from 1) and edge_physical (the physical tag of the curve);
+    - $PhysicalNames gives physical_tag and physical_name.
+
+    Other sections and other elements (points, volumes) are skipped. Mixed 2D element types
+    are a fatal error. All the output arrays are allocated here, free them after use.
+
+  Input:
+    filename      : e.g. ./mesh/mesh.msh
+
+  Output:
+    node_num, element_num, element_node, node_xy[0..1]
+    edge_num, edge_node, edge_physical
+    physical_num, physical_tag, physical_name
+*/
+{
+  int i, j, c, binary = 0, data_size = 0, one = 0;
+  int dim, tag, type, parametric, phys, gmsh_order = 0, type_code = 0, element_order = 0;
+  int node_order[16];
+  int curve_num = 0, element_count = 0, edge_count = 0;
+  int *curve_tag = NULL, *curve_physical = NULL;
+  int *tag_index = NULL;
+  size_t k, n, b, block_num, count, tag_max = 0, node_count = 0, element_max = 0, edge_max = 0;
+  size_t entity_num[4], bound_num;
+  size_t *node_sequence = NULL, *element_tag_node = NULL, *edge_tag_node = NULL;
+  size_t node_tag[64];
+  double version = 0.0;
+  double *tag_x = NULL, *tag_y = NULL;
+  char section[64], name[128];
+  FILE *fp;
+
+  if ((fp = fopen(filename, "rb")) == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "GMSH_READ - Fatal error!\n");
+    fprintf(stderr, "  Can not open %s.\n", filename);
+    exit(1);
+  }
+  *physical_num = 0;
+  *physical_tag = NULL;
+  *physical_name = NULL;
+
+  while (fscanf(fp, " %63s", section) == 1)
+  {
+    // the data of a section starts on the next line
+    while ((c = fgetc(fp)) != '\n' && c != EOF)
+      ;
+
+    if (strcmp(section, "$MeshFormat") == 0)
+    {
+      if (fscanf(fp, "%lf %d %d", &version, &binary, &data_size) != 3 || version < 4.1 || version >= 5.0)
+      {
+        fprintf(stderr, "\n");
+        fprintf(stderr, "GMSH_READ - Fatal error!\n");
+        fprintf(stderr, "  %s is not a mesh of format 4.1, save it with Gmsh 4 (Mesh.MshFileVersion = 4.1).\n", filename);
+        exit(1);
+      }
+      if (binary == 1)
+      {
+        while ((c = fgetc(fp)) != '\n' && c != EOF)
+          ;
+        if (data_size != (int)sizeof(size_t) || fread(&one, sizeof(int), 1, fp) != 1 || one != 1)
+        {
+          fprintf(stderr, "\n");
+          fprintf(stderr, "GMSH_READ - Fatal error!\n");
+          fprintf(stderr, "  %s is a binary mesh of another size_t size or byte order.\n", filename);
+          exit(1);
+        }
+      }
+    }
+    else if (strcmp(section, "$PhysicalNames") == 0)
+    {
+      // always ascii: dim tag "name"
+      if (fscanf(fp, "%d", physical_num) != 1)
+        *physical_num = 0;
+      *physical_tag = (int *)malloc((*physical_num + 1) * sizeof(int));
+      *physical_name = (char **)malloc((*physical_num + 1) * sizeof(char *));
+      for (i = 0; i < *physical_num; i++)
+      {
+        name[0] = '\0';
+        if (fscanf(fp, "%d %d \"%127[^\"]\"", &dim, &(*physical_tag)[i], name) < 2)
+        {
+          fprintf(stderr, "\n");
+          fprintf(stderr, "GMSH_READ - Fatal error!\n");
+          fprintf(stderr, "  Bad line %d of $PhysicalNames in %s.\n", i + 1, filename);
+          exit(1);
+        }
+        (*physical_name)[i] = (char *)malloc(strlen(name) + 1);
+        strcpy((*physical_name)[i], name);
+      }
+    }
+    else if (strcmp(section, "$Entities") == 0)
+    {
+      for (i = 0; i < 4; i++)
+        entity_num[i] = gmsh_read_size(fp, binary);
+      curve_tag = (int *)malloc((entity_num[1] + 1) * sizeof(int));
+      curve_physical = (int *)malloc((entity_num[1] + 1) * sizeof(int));
+      for (i = 0; i < 4; i++)
+      {
+        for (k = 0; k < entity_num[i]; k++)
+        {
+          tag = gmsh_read_int(fp, binary);
+          // points: x y z, curves, surfaces and volumes: bounding box
+          for (j = 0; j < ((i == 0) ? 3 : 6); j++)
+            gmsh_read_double(fp, binary);
+          count = gmsh_read_size(fp, binary);
+          phys = 0;
+          for (n = 0; n < count; n++)
+          {
+            j = gmsh_read_int(fp, binary);
+            if (n == 0)
+              phys = j;
+          }
+          if (i > 0)
+          {
+            bound_num = gmsh_read_size(fp, binary);
+            for (n = 0; n < bound_num; n++)
+              gmsh_read_int(fp, binary);
+          }
+          if (i == 1)
+          {
+            curve_tag[curve_num] = tag;
+            curve_physical[curve_num] = phys;
+            curve_num++;
+          }
+        }
+      }
+    }
+    else if (strcmp(section, "$Nodes") == 0)
+    {
+      block_num = gmsh_read_size(fp, binary);
+      count = gmsh_read_size(fp, binary);
+      gmsh_read_size(fp, binary); // min tag
+      tag_max = gmsh_read_size(fp, binary);
+      tag_x = (double *)malloc((tag_max + 1) * sizeof(double));
+      tag_y = (double *)malloc((tag_max + 1) * sizeof(double));
+      tag_index = (int *)malloc((tag_max + 1) * sizeof(int));
+      node_sequence = (size_t *)malloc((count + 1) * sizeof(size_t));
+      if (tag_x == NULL || tag_y == NULL || tag_index == NULL || node_sequence == NULL)
+      {
+        fprintf(stderr, "\n");
+        fprintf(stderr, "GMSH_READ - Fatal error!\n");
+        fprintf(stderr, "  Can not allocate the nodes, max node tag = %zu.\n", tag_max);
+        exit(1);
+      }
+      for (k = 0; k <= tag_max; k++)
+        tag_index[k] = -2; // not in $Nodes
+      for (b = 0; b < block_num; b++)
+      {
+        dim = gmsh_read_int(fp, binary);
+        gmsh_read_int(fp, binary); // entity tag
+        parametric = gmsh_read_int(fp, binary);
+        count = gmsh_read_size(fp, binary);
+        for (k = 0; k < count; k++)
+        {
+          node_sequence[node_count + k] = gmsh_read_size(fp, binary);
+          if (node_sequence[node_count + k] > tag_max)
+          {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "GMSH_READ - Fatal error!\n");
+            fprintf(stderr, "  Node tag %zu is larger than the max node tag %zu.\n", node_sequence[node_count + k], tag_max);
+            exit(1);
+          }
+        }
+        for (k = 0; k < count; k++)
+        {
+          n = node_sequence[node_count + k];
+          tag_x[n] = gmsh_read_double(fp, binary);
+          tag_y[n] = gmsh_read_double(fp, binary);
+          gmsh_read_double(fp, binary); // z
+          for (j = 0; j < ((parametric == 1) ? dim : 0); j++)
+            gmsh_read_double(fp, binary);
+          tag_index[n] = -1; // in $Nodes, not used yet
+        }
+        node_count = node_count + count;
+      }
+    }
+    else if (strcmp(section, "$Elements") == 0)
+    {
+      block_num = gmsh_read_size(fp, binary);
+      count = gmsh_read_size(fp, binary);
+      gmsh_read_size(fp, binary);
+      gmsh_read_size(fp, binary);
+      for (b = 0; b < block_num; b++)
+      {
+        dim = gmsh_read_int(fp, binary);
+        tag = gmsh_read_int(fp, binary);
+        type = gmsh_read_int(fp, binary);
+        count = gmsh_read_size(fp, binary);
+        gmsh_order = gmsh_element_node_num(type);
+        phys = 0;
+        if (dim == 2)
+        {
+          i = gmsh_element_type(type, node_order);
+          if (i == 0 || (type_code != 0 && i != type_code))
+          {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "GMSH_READ - Fatal error!\n");
+            fprintf(stderr, "  Gmsh 2D element type %d in %s: only one of T3, T6, T10, Q4, Q9, Q16 for the whole mesh.\n", type, filename);
+            exit(1);
+          }
+          type_code = i;
+          element_order = gmsh_order;
+          if (element_count + count > element_max)
+          {
+            element_max = 2 * (element_count + count);
+            element_tag_node = (size_t *)realloc(element_tag_node, element_max * element_order * sizeof(size_t));
+          }
+        }
+        else if (dim == 1)
+        {
+          for (i = 0; i < curve_num; i++)
+          {
+            if (curve_tag[i] == tag)
+              phys = curve_physical[i];
+          }
+          if (phys != 0 && edge_count + count > edge_max)
+          {
+            edge_max = 2 * (edge_count + count);
+            edge_tag_node = (size_t *)realloc(edge_tag_node, edge_max * 3 * sizeof(size_t));
+          }
+        }
+        for (k = 0; k < count; k++)
+        {
+          gmsh_read_size(fp, binary); // element tag
+          for (j = 0; j < gmsh_order; j++)
+            node_tag[j] = gmsh_read_size(fp, binary);
+          if (dim == 2)
+          {
+            for (j = 0; j < element_order; j++)
+              element_tag_node[(size_t)element_count * element_order + j] = node_tag[node_order[j]];
+            element_count++;
+          }
+          else if (dim == 1 && phys != 0)
+          {
+            edge_tag_node[3 * edge_count] = node_tag[0];
+            edge_tag_node[3 * edge_count + 1] = node_tag[1];
+            edge_tag_node[3 * edge_count + 2] = (size_t)phys;
+            edge_count++;
+          }
+        }
+      }
+    }
+    gmsh_skip_section(fp, section);
+  }
+  fclose(fp);
+
+  if (type_code == 0 || tag_index == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "GMSH_READ - Fatal error!\n");
+    fprintf(stderr, "  %s has no nodes or no 2D elements.\n", filename);
+    exit(1);
+  }
+
+  // number the nodes of the 2D elements in the order of $Nodes
+  for (k = 0; k < (size_t)element_count * element_order; k++)
+  {
+    n = element_tag_node[k];
+    if (n > tag_max || tag_index[n] == -2)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "GMSH_READ - Fatal error!\n");
+      fprintf(stderr, "  Element %zu uses node %zu, which is not in $Nodes.\n", k / element_order + 1, n);
+      exit(1);
+    }
+    tag_index[n] = 0;
+  }
+  *node_num = 0;
+  for (k = 0; k < node_count; k++)
+  {
+    if (tag_index[node_sequence[k]] == 0)
+      tag_index[node_sequence[k]] = ++(*node_num);
+  }
+  node_xy[0] = (double *)malloc(*node_num * sizeof(double));
+  node_xy[1] = (double *)malloc(*node_num * sizeof(double));
+  for (k = 0; k < node_count; k++)
+  {
+    n = node_sequence[k];
+    if (tag_index[n] > 0)
+    {
+      node_xy[0][tag_index[n] - 1] = tag_x[n];
+      node_xy[1][tag_index[n] - 1] = tag_y[n];
+    }
+  }
+  *element_num = element_count;
+  *element_node = (int *)malloc((size_t)element_count * element_order * sizeof(int));
+  for (k = 0; k < (size_t)element_count * element_order; k++)
+    (*element_node)[k] = tag_index[element_tag_node[k]];
+
+  // boundary edges on nodes of the 2D elements
+  *edge_num = 0;
+  *edge_node = (int *)malloc((2 * edge_count + 1) * sizeof(int));
+  *edge_physical = (int *)malloc((edge_count + 1) * sizeof(int));
+  for (i = 0; i < edge_count; i++)
+  {
+    if (edge_tag_node[3 * i] <= tag_max && edge_tag_node[3 * i + 1] <= tag_max &&
+        tag_index[edge_tag_node[3 * i]] > 0 && tag_index[edge_tag_node[3 * i + 1]] > 0)
+    {
+      (*edge_node)[2 * *edge_num] = tag_index[edge_tag_node[3 * i]];
+      (*edge_node)[2 * *edge_num + 1] = tag_index[edge_tag_node[3 * i + 1]];
+      (*edge_physical)[*edge_num] = (int)edge_tag_node[3 * i + 2];
+      (*edge_num)++;
+    }
+  }
+
+  free(curve_tag);
+  free(curve_physical);
+  free(tag_x);
+  free(tag_y);
+  free(tag_index);
+  free(node_sequence);
+  free(element_tag_node);
+  free(edge_tag_node);
+
+  return type_code;
+}
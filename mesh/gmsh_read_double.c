@@ -0,0 +1,26 @@
+double gmsh_read_double(FILE *fp, int binary)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_read_double reads one double of a .msh file: 8 bytes in a binary file, a number
+    in an ascii file (coordinates, bounding boxes).
+*/
+{
+  double value = 0.0;
+
+  if (binary == 1)
+  {
+    if (fread(&value, sizeof(double), 1, fp) == 1)
+      return value;
+  }
+  else
+  {
+    if (fscanf(fp, "%lf", &value) == 1)
+      return value;
+  }
+  fprintf(stderr, "\n");
+  fprintf(stderr, "GMSH_READ - Fatal error!\n");
+  fprintf(stderr, "  Unexpected end of the .msh file, or a bad number at byte %ld.\n", ftell(fp));
+  exit(1);
+}
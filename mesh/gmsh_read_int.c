@@ -0,0 +1,26 @@
+int gmsh_read_int(FILE *fp, int binary)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_read_int reads one int of a .msh file: 4 bytes in a binary file, a number in an
+    ascii file (entity dimensions, entity and physical tags, element types).
+*/
+{
+  int value = 0;
+
+  if (binary == 1)
+  {
+    if (fread(&value, sizeof(int), 1, fp) == 1)
+      return value;
+  }
+  else
+  {
+    if (fscanf(fp, "%d", &value) == 1)
+      return value;
+  }
+  fprintf(stderr, "\n");
+  fprintf(stderr, "GMSH_READ - Fatal error!\n");
+  fprintf(stderr, "  Unexpected end of the .msh file, or a bad number at byte %ld.\n", ftell(fp));
+  exit(1);
+}
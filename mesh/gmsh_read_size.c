@@ -0,0 +1,27 @@
+size_t gmsh_read_size(FILE *fp, int binary)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_read_size reads one size_t of a .msh file: 8 bytes in a binary file, a number in
+    an ascii file (node tags, element tags and counts). The end of the file is a fatal error.
+*/
+{
+  size_t value = 0;
+  unsigned long long number;
+
+  if (binary == 1)
+  {
+    if (fread(&value, sizeof(size_t), 1, fp) == 1)
+      return value;
+  }
+  else
+  {
+    if (fscanf(fp, "%llu", &number) == 1)
+      return (size_t)number;
+  }
+  fprintf(stderr, "\n");
+  fprintf(stderr, "GMSH_READ - Fatal error!\n");
+  fprintf(stderr, "  Unexpected end of the .msh file, or a bad number at byte %ld.\n", ftell(fp));
+  exit(1);
+}
@@ -0,0 +1,26 @@
+void gmsh_skip_section(FILE *fp, char *section)
+/******************************************************************************/
+/*
+  Purpose:
+
+    gmsh_skip_section skips the lines of a .msh file up to the line "$End<section>",
+    e.g. section = "$Periodic" stops after "$EndPeriodic". Binary data in between is
+    read line by line too, so nothing is held in memory.
+*/
+{
+  char line[256];
+  char end[80];
+  size_t length;
+
+  sprintf(end, "$End%.70s", section + 1);
+  length = strlen(end);
+  while (fgets(line, sizeof(line), fp) != NULL)
+  {
+    if (strncmp(line, end, length) == 0 && (line[length] == '\n' || line[length] == '\r' || line[length] == '\0'))
+      return;
+  }
+  fprintf(stderr, "\n");
+  fprintf(stderr, "GMSH_READ - Fatal error!\n");
+  fprintf(stderr, "  %s is not closed by %s.\n", section, end);
+  exit(1);
+}
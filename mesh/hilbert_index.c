@@ -0,0 +1,33 @@
+unsigned long long hilbert_index(int bits, unsigned int x, unsigned int y)
+/******************************************************************************/
+/*
+  Purpose:
+
+    hilbert_index returns the position of the cell (x, y) along the Hilbert curve that
+    fills the 2^bits x 2^bits grid, 0 <= x, y < 2^bits, bits <= 31. Cells that are close
+    on the curve are close in space.
+*/
+{
+  unsigned int s, rx, ry, t;
+  unsigned long long d = 0;
+
+  for (s = 1U << (bits - 1); s > 0; s = s / 2)
+  {
+    rx = (x & s) > 0;
+    ry = (y & s) > 0;
+    d = d + (unsigned long long)s * s * ((3 * rx) ^ ry);
+    // rotate the quadrant
+    if (ry == 0)
+    {
+      if (rx == 1)
+      {
+        x = s - 1 - (x & (s - 1));
+        y = s - 1 - (y & (s - 1));
+      }
+      t = x;
+      x = y;
+      y = t;
+    }
+  }
+  return d;
+}
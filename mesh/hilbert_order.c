@@ -0,0 +1,89 @@
+void hilbert_order(int point_num, double *x, double *y, int *order)
+/******************************************************************************/
+/*
+  Purpose:
+
+    hilbert_order sorts points along the Hilbert curve of their bounding box:
+    order[new] = old. The box is cut into 2^16 x 2^16 cells, the cell index is given by
+    hilbert_index and the points are sorted by a radix sort on it (stable, so points in
+    one cell keep their order).
+
+  Input:
+    x, y  : point coordinates, size point_num
+
+  Output:
+    order : new-to-old point order, size point_num
+*/
+{
+  int i, pass, bits = 16;
+  int count[257];
+  unsigned int cell_x, cell_y;
+  unsigned int *key = NULL;
+  unsigned int *key_temp = NULL;
+  int *order_temp = NULL;
+  double x_min, x_max, y_min, y_max, cell_size;
+
+  key = (unsigned int *)malloc(point_num * sizeof(unsigned int));
+  key_temp = (unsigned int *)malloc(point_num * sizeof(unsigned int));
+  order_temp = (int *)malloc(point_num * sizeof(int));
+  if (key == NULL || key_temp == NULL || order_temp == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "HILBERT_ORDER - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for point_num = %d.\n", point_num);
+    exit(1);
+  }
+
+  x_min = x[0];
+  x_max = x[0];
+  y_min = y[0];
+  y_max = y[0];
+  for (i = 0; i < point_num; i++)
+  {
+    if (x[i] < x_min)
+      x_min = x[i];
+    if (x[i] > x_max)
+      x_max = x[i];
+    if (y[i] < y_min)
+      y_min = y[i];
+    if (y[i] > y_max)
+      y_max = y[i];
+  }
+  // square cells, so the curve does not stretch with the aspect ratio of the model
+  cell_size = (x_max - x_min > y_max - y_min) ? x_max - x_min : y_max - y_min;
+  cell_size = (cell_size > 0.0) ? cell_size / ((1 << bits) - 1) : 1.0;
+
+  #pragma omp parallel for private(cell_x, cell_y)
+  for (i = 0; i < point_num; i++)
+  {
+    cell_x = (unsigned int)((x[i] - x_min) / cell_size);
+    cell_y = (unsigned int)((y[i] - y_min) / cell_size);
+    key[i] = (unsigned int)hilbert_index(bits, cell_x, cell_y);
+    order[i] = i;
+  }
+
+  // radix sort, 8 bits per pass
+  for (pass = 0; pass < 4; pass++)
+  {
+    for (i = 0; i < 257; i++)
+      count[i] = 0;
+    for (i = 0; i < point_num; i++)
+      count[((key[i] >> (8 * pass)) & 255) + 1]++;
+    for (i = 0; i < 256; i++)
+      count[i + 1] = count[i + 1] + count[i];
+    for (i = 0; i < point_num; i++)
+    {
+      key_temp[count[(key[i] >> (8 * pass)) & 255]] = key[i];
+      order_temp[count[(key[i] >> (8 * pass)) & 255]++] = order[i];
+    }
+    for (i = 0; i < point_num; i++)
+    {
+      key[i] = key_temp[i];
+      order[i] = order_temp[i];
+    }
+  }
+
+  free(key);
+  free(key_temp);
+  free(order_temp);
+}
@@ -0,0 +1,30 @@
+int mesh_bandwidth(int element_order, int element_num, int *element_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_bandwidth returns the geometric bandwidth M = ML + 1 + MU of the finite element
+    matrices of the mesh, as bandwidth_mesh in femlib/fem2d_pack.c. The node adjacency is
+    symmetric, so ML = MU and M = 2 * ML + 1.
+
+  Input:
+    element_node : element_node[element * element_order + i], from 1
+*/
+{
+  int element, local_i, local_j, ml;
+
+  ml = 0;
+  #pragma omp parallel for private(local_i, local_j) reduction(max : ml)
+  for (element = 0; element < element_num; element++)
+  {
+    for (local_i = 0; local_i < element_order; local_i++)
+    {
+      for (local_j = 0; local_j < element_order; local_j++)
+      {
+        if (element_node[element * element_order + local_i] - element_node[element * element_order + local_j] > ml)
+          ml = element_node[element * element_order + local_i] - element_node[element * element_order + local_j];
+      }
+    }
+  }
+  return 2 * ml + 1;
+}
@@ -0,0 +1,41 @@
+size_t mesh_binary_layout(int node_num, int element_num, int element_order, size_t *offset)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_binary_layout gives the byte offset of every section of a binary mesh file
+    (./mesh/mesh.bin) and returns the file size. Every section starts on a 64 byte
+    boundary, so the file can be mapped with mmap and the arrays used in place.
+
+  Layout:
+
+    I   SECTION          TYPE     SIZE
+    --  ---------------  -------  ---------------------------
+    -   header           long     8
+    -   bounding box     double   4: xmin, xmax, ymin, ymax
+    0   element_node     int      element_num * element_order, from 1
+    1   node_x           double   node_num
+    2   node_y           double   node_num
+    3   rho, vp, vs, c11, c13, c33, c44
+                         double   7 * node_num
+
+    header: magic, version, type_code, element_order, element_num, node_num, file size, 0
+*/
+{
+  int k;
+  size_t size[10];
+  size_t pos;
+
+  size[0] = (size_t)element_num * element_order * sizeof(int);
+  for (k = 1; k < 10; k++)
+    size[k] = (size_t)node_num * sizeof(double);
+
+  pos = 8 * sizeof(long long) + 4 * sizeof(double);
+  for (k = 0; k < 10; k++)
+  {
+    pos = (pos + 63) / 64 * 64;
+    offset[k] = pos;
+    pos = pos + size[k];
+  }
+  return pos;
+}
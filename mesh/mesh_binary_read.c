@@ -0,0 +1,91 @@
+void *mesh_binary_read(char *filename, int type_code, int *node_num, int *element_num, size_t *map_size, int **element_node, double **node_xy,
+                       double *xmin, double *xmax, double *ymin, double *ymax, double **rho, double **vp, double **vs, double **c)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_binary_read maps a binary mesh file written by mesh_binary_write and points
+    element_node, node_xy[0..1], rho, vp, vs and c[0..3] into the mapping, nothing is
+    read or copied. The mapping is private, so the arrays can still be changed in memory
+    (e.g. by mesh_renumber) without touching the file.
+
+    Return the mapping, to be released with munmap(map, map_size) instead of freeing the
+    arrays. A file that is missing or does not match type_code is a fatal error.
+*/
+{
+  int k;
+  int fd;
+  long long *header;
+  double *box;
+  size_t offset[10];
+  size_t file_size;
+  struct stat file_stat;
+  char *map;
+
+  if ((fd = open(filename, O_RDONLY)) < 0 || fstat(fd, &file_stat) != 0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_BINARY_READ - Fatal error!\n");
+    fprintf(stderr, "  Can not open %s.\n", filename);
+    exit(1);
+  }
+  if (file_stat.st_size < (off_t)(8 * sizeof(long long) + 4 * sizeof(double)))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_BINARY_READ - Fatal error!\n");
+    fprintf(stderr, "  %s is too short for a binary mesh.\n", filename);
+    exit(1);
+  }
+  map = (char *)mmap(NULL, (size_t)file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_BINARY_READ - Fatal error!\n");
+    fprintf(stderr, "  Can not map %s.\n", filename);
+    exit(1);
+  }
+
+  header = (long long *)map;
+  box = (double *)(map + 8 * sizeof(long long));
+  if (header[0] != 0x3148534d4d454653LL || header[1] != 1)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_BINARY_READ - Fatal error!\n");
+    fprintf(stderr, "  %s is not a binary mesh of version 1.\n", filename);
+    exit(1);
+  }
+  if (header[2] != type_code)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_BINARY_READ - Fatal error!\n");
+    fprintf(stderr, "  %s holds type_code = %lld, par.txt asks for type_code = %d.\n", filename, header[2], type_code);
+    exit(1);
+  }
+  file_size = mesh_binary_layout((int)header[5], (int)header[4], (int)header[3], offset);
+  if (header[6] != (long long)file_size || (size_t)file_stat.st_size != file_size)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_BINARY_READ - Fatal error!\n");
+    fprintf(stderr, "  %s has %lld bytes, %zu are expected.\n", filename, (long long)file_stat.st_size, file_size);
+    exit(1);
+  }
+
+  *element_num = (int)header[4];
+  *node_num = (int)header[5];
+  *map_size = file_size;
+  *xmin = box[0];
+  *xmax = box[1];
+  *ymin = box[2];
+  *ymax = box[3];
+  *element_node = (int *)(map + offset[0]);
+  node_xy[0] = (double *)(map + offset[1]);
+  node_xy[1] = (double *)(map + offset[2]);
+  *rho = (double *)(map + offset[3]);
+  *vp = (double *)(map + offset[4]);
+  *vs = (double *)(map + offset[5]);
+  for (k = 0; k < 4; k++)
+    c[k] = (double *)(map + offset[6 + k]);
+
+  return map;
+}
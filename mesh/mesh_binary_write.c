@@ -0,0 +1,75 @@
+int mesh_binary_write(char *filename, int type_code, int node_num, int element_num, int element_order, int *element_node, double **node_xy,
+                      double xmin, double xmax, double ymin, double ymax, double *rho, double *vp, double *vs, double **c)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_binary_write saves the mesh, its bounding box and the model (rho, vp, vs, c11,
+    c13, c33, c44) in the binary layout of mesh_binary_layout, to be mapped by
+    mesh_binary_read (use_exterior_mesh = 2) instead of reading the text files.
+
+    The file is written to filename.tmp and renamed at the end. Return 1 on success.
+*/
+{
+  int k;
+  long long header[8];
+  double box[4];
+  size_t offset[10];
+  size_t file_size;
+  char filename_temp[256];
+  void *section[10];
+  FILE *fp_mesh;
+
+  file_size = mesh_binary_layout(node_num, element_num, element_order, offset);
+
+  header[0] = 0x3148534d4d454653LL; // "SFEMMSH1"
+  header[1] = 1;
+  header[2] = type_code;
+  header[3] = element_order;
+  header[4] = element_num;
+  header[5] = node_num;
+  header[6] = (long long)file_size;
+  header[7] = 0;
+  box[0] = xmin;
+  box[1] = xmax;
+  box[2] = ymin;
+  box[3] = ymax;
+
+  section[0] = element_node;
+  section[1] = node_xy[0];
+  section[2] = node_xy[1];
+  section[3] = rho;
+  section[4] = vp;
+  section[5] = vs;
+  for (k = 0; k < 4; k++)
+    section[6 + k] = c[k];
+
+  sprintf(filename_temp, "%s.tmp", filename);
+  if ((fp_mesh = fopen(filename_temp, "wb")) == NULL)
+  {
+    printf("\n binary mesh %s cannot open\n", filename_temp);
+    return 0;
+  }
+  fwrite(header, sizeof(long long), 8, fp_mesh);
+  fwrite(box, sizeof(double), 4, fp_mesh);
+  for (k = 0; k < 10; k++)
+  {
+    // zero padding up to the 64 byte boundary of the section
+    while (ftell(fp_mesh) < (long)offset[k])
+      fputc(0, fp_mesh);
+    if (k == 0)
+      fwrite(section[k], sizeof(int), (size_t)element_num * element_order, fp_mesh);
+    else
+      fwrite(section[k], sizeof(double), node_num, fp_mesh);
+  }
+  if (ftell(fp_mesh) != (long)file_size)
+  {
+    fclose(fp_mesh);
+    remove(filename_temp);
+    printf("\n binary mesh %s is not complete\n", filename_temp);
+    return 0;
+  }
+  fclose(fp_mesh);
+  rename(filename_temp, filename);
+  return 1;
+}
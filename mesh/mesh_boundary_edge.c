@@ -0,0 +1,92 @@
+int mesh_boundary_edge(char *type, int element_num, int element_order, int *element_node, int **edge_node, int **edge_element)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_boundary_edge finds the edges of the mesh boundary from the connectivity only:
+    the sides of the elements (between the corner nodes of element_vertex) that belong
+    to one element. Every side is put in an open addressing hash table keyed by its two
+    corner nodes, a side met a second time is an interior edge.
+
+    The mid-side nodes of T6, T10, Q9 and Q16 are not listed, they lie on the straight
+    side between the two corner nodes.
+
+  Output:
+
+    edge_node[2 * edge_num], the two corner nodes of every boundary edge, from 1 as
+    element_node (the layout of the Gmsh boundary edges of gmsh_read);
+    edge_element[edge_num], the element of every boundary edge, from 0;
+    the function returns edge_num.
+*/
+{
+  int e, k, a, b, temp, vertex_num, side_num, edge_num;
+  size_t slot, table_size;
+  int vertex[4];
+  int *table_a = NULL;
+  int *table_b = NULL;
+  int *table_element = NULL;
+  int *table_count = NULL;
+
+  vertex_num = element_vertex(type, vertex);
+  side_num = element_num * vertex_num;
+
+  // at most half full
+  table_size = 1;
+  while (table_size < 2 * (size_t)side_num)
+    table_size = table_size * 2;
+  table_a = (int *)malloc(table_size * sizeof(int));
+  table_b = (int *)malloc(table_size * sizeof(int));
+  table_element = (int *)malloc(table_size * sizeof(int));
+  table_count = (int *)calloc(table_size, sizeof(int));
+
+  edge_num = 0;
+  for (e = 0; e < element_num; e++)
+  {
+    for (k = 0; k < vertex_num; k++)
+    {
+      a = element_node[e * element_order + vertex[k]];
+      b = element_node[e * element_order + vertex[(k + 1) % vertex_num]];
+      if (a > b)
+      {
+        temp = a;
+        a = b;
+        b = temp;
+      }
+      slot = (((size_t)a * 2654435761u) ^ ((size_t)b * 40503u)) & (table_size - 1);
+      while (table_count[slot] > 0 && (table_a[slot] != a || table_b[slot] != b))
+        slot = (slot + 1) & (table_size - 1);
+      if (table_count[slot] == 0)
+      {
+        table_a[slot] = a;
+        table_b[slot] = b;
+        table_element[slot] = e;
+        edge_num++;
+      }
+      else if (table_count[slot] == 1)
+      {
+        edge_num--;
+      }
+      table_count[slot]++;
+    }
+  }
+
+  *edge_node = (int *)malloc(2 * edge_num * sizeof(int));
+  *edge_element = (int *)malloc(edge_num * sizeof(int));
+  k = 0;
+  for (slot = 0; slot < table_size; slot++)
+  {
+    if (table_count[slot] != 1)
+      continue;
+    (*edge_node)[2 * k] = table_a[slot];
+    (*edge_node)[2 * k + 1] = table_b[slot];
+    (*edge_element)[k] = table_element[slot];
+    k++;
+  }
+
+  free(table_a);
+  free(table_b);
+  free(table_element);
+  free(table_count);
+
+  return edge_num;
+}
@@ -0,0 +1,60 @@
+int mesh_boundary_node(int node_num, int element_order, int *element_node, double **node_xy, int edge_num, int *edge_node, int *edge_element,
+                       int *edge_tag, int tag_mask, int *boundary_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_boundary_node lists the nodes of the boundary edges whose tag is in tag_mask
+    (bit 1 << tag, see mesh_boundary_tag): the two corner nodes and the mid-side nodes of
+    the element of the edge that lie on the segment between them. The time loops apply
+    their boundary conditions on this list after the update of all nodes, e.g. u = w = 0 on
+    the absorbing and fixed edges for the elastic wave, instead of testing every node at
+    every step.
+
+  Output:
+
+    boundary_node[node_num], the nodes from 0, in increasing order;
+    the function returns their number.
+*/
+{
+  int i, k, e, a, b, p, boundary_num;
+  double ex, ey, px, py, len2, cross, dot;
+  int *flag = NULL;
+
+  flag = (int *)calloc(node_num, sizeof(int));
+  for (e = 0; e < edge_num; e++)
+  {
+    if (((1 << edge_tag[e]) & tag_mask) == 0)
+      continue;
+    a = edge_node[2 * e] - 1;
+    b = edge_node[2 * e + 1] - 1;
+    flag[a] = 1;
+    flag[b] = 1;
+    ex = node_xy[0][b] - node_xy[0][a];
+    ey = node_xy[1][b] - node_xy[1][a];
+    len2 = ex * ex + ey * ey;
+    for (k = 0; k < element_order; k++)
+    {
+      p = element_node[edge_element[e] * element_order + k] - 1;
+      px = node_xy[0][p] - node_xy[0][a];
+      py = node_xy[1][p] - node_xy[1][a];
+      cross = px * ey - py * ex;
+      dot = px * ex + py * ey;
+      if (cross * cross <= 1.0e-12 * len2 * len2 && dot >= 0.0 && dot <= len2)
+        flag[p] = 1;
+    }
+  }
+
+  boundary_num = 0;
+  for (i = 0; i < node_num; i++)
+  {
+    if (flag[i] == 1)
+    {
+      boundary_node[boundary_num] = i;
+      boundary_num++;
+    }
+  }
+  free(flag);
+
+  return boundary_num;
+}
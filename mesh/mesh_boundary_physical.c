@@ -0,0 +1,94 @@
+int mesh_boundary_physical(int edge_num, int *edge_node, int *edge_tag, int boundary_edge_num, int *boundary_edge_node, int *boundary_edge_physical,
+                           int physical_num, int *physical_tag, char **physical_name)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_boundary_physical tags the boundary edges of mesh_boundary_edge by the physical
+    groups of the line elements of a Gmsh mesh (see gmsh_read). The groups named
+
+      absorbing       1: absorbing
+      free_surface    2: free surface
+      fixed           3: fixed (Dirichlet, no pml)
+
+    replace the tag of mesh_boundary_tag for their edges, the other groups are left out.
+    The Gmsh edges are put in an open addressing hash table keyed by their two corner
+    nodes and every boundary edge is looked up there.
+
+    The function returns the number of edges tagged by a group.
+*/
+{
+  int i, k, a, b, temp, tag, tag_num;
+  size_t slot, table_size;
+  int *table_a = NULL;
+  int *table_b = NULL;
+  int *table_tag = NULL;
+
+  // the tag of every physical group of the Gmsh edges, 0 for the other groups
+  table_size = 1;
+  while (table_size < 2 * (size_t)boundary_edge_num + 1)
+    table_size = table_size * 2;
+  table_a = (int *)malloc(table_size * sizeof(int));
+  table_b = (int *)malloc(table_size * sizeof(int));
+  table_tag = (int *)malloc(table_size * sizeof(int));
+  for (slot = 0; slot < table_size; slot++)
+    table_a[slot] = 0;
+
+  for (k = 0; k < boundary_edge_num; k++)
+  {
+    tag = 0;
+    for (i = 0; i < physical_num; i++)
+    {
+      if (physical_tag[i] != boundary_edge_physical[k])
+        continue;
+      if (strcmp(physical_name[i], "absorbing") == 0)
+        tag = 1;
+      else if (strcmp(physical_name[i], "free_surface") == 0)
+        tag = 2;
+      else if (strcmp(physical_name[i], "fixed") == 0)
+        tag = 3;
+    }
+    if (tag == 0)
+      continue;
+    a = boundary_edge_node[2 * k];
+    b = boundary_edge_node[2 * k + 1];
+    if (a > b)
+    {
+      temp = a;
+      a = b;
+      b = temp;
+    }
+    slot = (((size_t)a * 2654435761u) ^ ((size_t)b * 40503u)) & (table_size - 1);
+    while (table_a[slot] != 0 && (table_a[slot] != a || table_b[slot] != b))
+      slot = (slot + 1) & (table_size - 1);
+    table_a[slot] = a;
+    table_b[slot] = b;
+    table_tag[slot] = tag;
+  }
+
+  tag_num = 0;
+  for (k = 0; k < edge_num; k++)
+  {
+    a = edge_node[2 * k];
+    b = edge_node[2 * k + 1];
+    if (a > b)
+    {
+      temp = a;
+      a = b;
+      b = temp;
+    }
+    slot = (((size_t)a * 2654435761u) ^ ((size_t)b * 40503u)) & (table_size - 1);
+    while (table_a[slot] != 0 && (table_a[slot] != a || table_b[slot] != b))
+      slot = (slot + 1) & (table_size - 1);
+    if (table_a[slot] == 0)
+      continue;
+    edge_tag[k] = table_tag[slot];
+    tag_num++;
+  }
+
+  free(table_a);
+  free(table_b);
+  free(table_tag);
+
+  return tag_num;
+}
@@ -0,0 +1,42 @@
+void mesh_boundary_tag(int edge_num, int *edge_node, double **node_xy, double h, double xmin, double xmax, double ymin, double ymax,
+                       int *side_tag, int *edge_tag)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_boundary_tag sorts the boundary edges of mesh_boundary_edge into absorbing, free
+    surface and fixed edges by the side of the bounding box they are on: an edge with both
+    corner nodes within h / 4 of a side is on that side, an edge on no side (the topography
+    of an exterior mesh) is on "other".
+
+    side_tag[5] gives the tag of the sides xmin, xmax, ymin, ymax and other, from the
+    boundary_* rules of par.txt (by default absorbing, xmax free surface with free_surface = 1,
+    other free surface). The Gmsh physical groups can change the tags afterwards, see
+    mesh_boundary_physical.
+
+  Output:
+
+    edge_tag[edge_num], 1: absorbing, 2: free surface, 3: fixed (Dirichlet, no pml)
+*/
+{
+  int k, a, b;
+  double tol;
+
+  tol = h / 4.0;
+  #pragma omp parallel for private(a, b)
+  for (k = 0; k < edge_num; k++)
+  {
+    a = edge_node[2 * k] - 1;
+    b = edge_node[2 * k + 1] - 1;
+    if (node_xy[0][a] <= xmin + tol && node_xy[0][b] <= xmin + tol)
+      edge_tag[k] = side_tag[0];
+    else if (node_xy[0][a] >= xmax - tol && node_xy[0][b] >= xmax - tol)
+      edge_tag[k] = side_tag[1];
+    else if (node_xy[1][a] <= ymin + tol && node_xy[1][b] <= ymin + tol)
+      edge_tag[k] = side_tag[2];
+    else if (node_xy[1][a] >= ymax - tol && node_xy[1][b] >= ymax - tol)
+      edge_tag[k] = side_tag[3];
+    else
+      edge_tag[k] = side_tag[4];
+  }
+}
@@ -0,0 +1,71 @@
+int mesh_element_block(int node_num, int element_num, int element_order, int *element_node, int block_node_max, int *block_p)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_element_block cuts the element list into blocks of consecutive elements that
+    touch at most block_node_max different nodes, so the nodal data of one block stays
+    in cache while it is swept. Block b holds the elements block_p[b] to block_p[b+1]-1;
+    a block is the unit a threaded or matrix-free element kernel can take at a time.
+
+    Use it after mesh_element_sort, otherwise the blocks of an unstructured mesh are
+    spread over the whole domain.
+
+  Input:
+    block_node_max : node limit of a block, e.g. 2048 nodes x 16 doubles = 256 KB
+
+  Output:
+    block_p        : block pointers, size element_num + 1 at most
+    return         : number of blocks
+*/
+{
+  int i, k, element, block_num, node_count, node_count_new;
+  int *marker = NULL;
+
+  marker = (int *)malloc(node_num * sizeof(int));
+  if (marker == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_ELEMENT_BLOCK - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for node_num = %d.\n", node_num);
+    exit(1);
+  }
+  for (i = 0; i < node_num; i++)
+    marker[i] = -1;
+
+  block_num = 0;
+  block_p[0] = 0;
+  node_count = 0;
+  for (element = 0; element < element_num; element++)
+  {
+    // new nodes this element brings to the current block
+    node_count_new = 0;
+    for (k = 0; k < element_order; k++)
+    {
+      if (marker[element_node[element * element_order + k] - 1] != block_num)
+        node_count_new++;
+    }
+    if (node_count > 0 && node_count + node_count_new > block_node_max)
+    {
+      block_num++;
+      block_p[block_num] = element;
+      node_count = 0;
+    }
+    for (k = 0; k < element_order; k++)
+    {
+      i = element_node[element * element_order + k] - 1;
+      if (marker[i] != block_num)
+      {
+        marker[i] = block_num;
+        node_count++;
+      }
+    }
+  }
+  if (element_num > 0)
+    block_num++;
+  block_p[block_num] = element_num;
+
+  free(marker);
+
+  return block_num;
+}
@@ -0,0 +1,60 @@
+void mesh_element_sort(int element_num, int element_order, int *element_node, double **node_xy, int *element_old)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_element_sort reorders the elements along the Hilbert curve of their centroids
+    (see hilbert_order), so consecutive elements are neighbours and the element loops of
+    the assembly and of abc_mpml touch the nodes of a small region at a time.
+    element_node is permuted in place, element_old[new] = old.
+
+  Input:
+    element_node : element_node[element * element_order + i], from 1
+
+  Output:
+    element_old  : new-to-old element order, size element_num
+*/
+{
+  int i, element;
+  int *element_node_old = NULL;
+  double *centroid_x = NULL;
+  double *centroid_y = NULL;
+
+  centroid_x = (double *)malloc(element_num * sizeof(double));
+  centroid_y = (double *)malloc(element_num * sizeof(double));
+  element_node_old = (int *)malloc(element_num * element_order * sizeof(int));
+  if (centroid_x == NULL || centroid_y == NULL || element_node_old == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_ELEMENT_SORT - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for element_num = %d.\n", element_num);
+    exit(1);
+  }
+
+  #pragma omp parallel for private(i)
+  for (element = 0; element < element_num; element++)
+  {
+    centroid_x[element] = 0.0;
+    centroid_y[element] = 0.0;
+    for (i = 0; i < element_order; i++)
+    {
+      centroid_x[element] = centroid_x[element] + node_xy[0][element_node[element * element_order + i] - 1];
+      centroid_y[element] = centroid_y[element] + node_xy[1][element_node[element * element_order + i] - 1];
+    }
+    centroid_x[element] = centroid_x[element] / element_order;
+    centroid_y[element] = centroid_y[element] / element_order;
+  }
+  hilbert_order(element_num, centroid_x, centroid_y, element_old);
+
+  memcpy(element_node_old, element_node, element_num * element_order * sizeof(int));
+  #pragma omp parallel for private(i)
+  for (element = 0; element < element_num; element++)
+  {
+    for (i = 0; i < element_order; i++)
+      element_node[element * element_order + i] = element_node_old[element_old[element] * element_order + i];
+  }
+
+  free(centroid_x);
+  free(centroid_y);
+  free(element_node_old);
+}
@@ -0,0 +1,46 @@
+void mesh_first_touch(int node_num, int element_num, int element_order, int *element_node, int *node_old)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_first_touch numbers the nodes in the order the element loop first meets them:
+    node_old[new] = old. After mesh_element_sort, consecutive elements then share nodes
+    with close numbers. Nodes of no element are put at the end.
+
+  Input:
+    element_node : element_node[element * element_order + i], from 1
+
+  Output:
+    node_old     : new-to-old node order, size node_num
+*/
+{
+  int i, k, count;
+  int *touched = NULL;
+
+  touched = (int *)calloc(node_num, sizeof(int));
+  if (touched == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_FIRST_TOUCH - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for node_num = %d.\n", node_num);
+    exit(1);
+  }
+
+  count = 0;
+  for (k = 0; k < element_num * element_order; k++)
+  {
+    i = element_node[k] - 1;
+    if (touched[i] == 0)
+    {
+      touched[i] = 1;
+      node_old[count++] = i;
+    }
+  }
+  for (i = 0; i < node_num; i++)
+  {
+    if (touched[i] == 0)
+      node_old[count++] = i;
+  }
+
+  free(touched);
+}
@@ -0,0 +1,141 @@
+void mesh_rcm(int node_num, int *csr_p, int *csr_j, int *node_old)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_rcm returns the reverse Cuthill-McKee order of the nodes: node_old[new] = old.
+    The nodes are visited level by level from a pseudo-peripheral node, the neighbours in
+    increasing degree, and the order is reversed at the end. Every connected part of the
+    mesh is numbered one after the other.
+
+  Input:
+    csr_p, csr_j : node-to-node graph of the mesh, from csr_pattern (from 0)
+
+  Output:
+    node_old     : new-to-old node order, size node_num
+*/
+{
+  int i, k, kk, col, root, node, head, tail, count, degree_min;
+  int level_num, level_num_old, level_start, stamp;
+  int *degree = NULL;
+  int *mark = NULL;
+  int *queue = NULL;
+  int *visited = NULL;
+
+  degree = (int *)malloc(node_num * sizeof(int));
+  mark = (int *)malloc(node_num * sizeof(int));
+  queue = (int *)malloc(node_num * sizeof(int));
+  visited = (int *)calloc(node_num, sizeof(int));
+  if (degree == NULL || mark == NULL || queue == NULL || visited == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MESH_RCM - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for node_num = %d.\n", node_num);
+    exit(1);
+  }
+  for (i = 0; i < node_num; i++)
+  {
+    degree[i] = csr_p[i + 1] - csr_p[i];
+    mark[i] = -1;
+  }
+
+  stamp = 0;
+  count = 0;
+  while (count < node_num)
+  {
+    // 1. start from the node of lowest degree not numbered yet
+    root = -1;
+    for (i = 0; i < node_num; i++)
+    {
+      if (visited[i] == 0 && (root < 0 || degree[i] < degree[root]))
+        root = i;
+    }
+
+    // 2. pseudo-peripheral node: move the root to the last level of its level structure
+    //    while the number of levels grows
+    level_num_old = -1;
+    while (1)
+    {
+      head = 0;
+      tail = 0;
+      queue[tail++] = root;
+      mark[root] = stamp;
+      level_num = 0;
+      level_start = 0;
+      while (head < tail)
+      {
+        level_start = head;
+        kk = tail;
+        level_num++;
+        for (; head < kk; head++)
+        {
+          node = queue[head];
+          for (k = csr_p[node]; k < csr_p[node + 1]; k++)
+          {
+            col = csr_j[k];
+            if (mark[col] != stamp)
+            {
+              mark[col] = stamp;
+              queue[tail++] = col;
+            }
+          }
+        }
+      }
+      stamp++;
+      if (level_num <= level_num_old)
+        break;
+      level_num_old = level_num;
+      degree_min = node_num + 1;
+      for (k = level_start; k < tail; k++)
+      {
+        if (degree[queue[k]] < degree_min)
+        {
+          degree_min = degree[queue[k]];
+          node = queue[k];
+        }
+      }
+      if (node == root)
+        break;
+      root = node;
+    }
+
+    // 3. Cuthill-McKee: breadth first, the new neighbours of a node in increasing degree
+    head = count;
+    node_old[count++] = root;
+    visited[root] = 1;
+    while (head < count)
+    {
+      node = node_old[head++];
+      kk = count;
+      for (k = csr_p[node]; k < csr_p[node + 1]; k++)
+      {
+        col = csr_j[k];
+        if (visited[col] == 0)
+        {
+          visited[col] = 1;
+          // insertion by degree, the rows are short
+          i = count++;
+          while (i > kk && degree[node_old[i - 1]] > degree[col])
+          {
+            node_old[i] = node_old[i - 1];
+            i--;
+          }
+          node_old[i] = col;
+        }
+      }
+    }
+  }
+
+  // 4. reverse
+  for (i = 0; i < node_num / 2; i++)
+  {
+    k = node_old[i];
+    node_old[i] = node_old[node_num - 1 - i];
+    node_old[node_num - 1 - i] = k;
+  }
+
+  free(degree);
+  free(mark);
+  free(queue);
+  free(visited);
+}
@@ -0,0 +1,70 @@
+void mesh_renumber(int node_num, int element_num, int element_order, int *element_node, double **node_xy,
+                   double *rho, double *vp, double *vs, double **c, int src_num, int *src_node, int rec_num, int *rec_node,
+                   int *node_old, int *node_new)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_renumber gives node node_old[i] the new number i: node_xy, the model (rho, vp, vs,
+    c11, c13, c33, c44) are permuted, element_node, src_node and rec_node are mapped to the
+    new numbers. node_new is the inverse, node_new[old] = new, used to write the outputs
+    back in the order of the mesh files.
+
+  Input:
+    node_old     : new-to-old node order, from mesh_rcm or hilbert_order
+
+  Output:
+    node_new     : old-to-new node order, size node_num
+*/
+{
+  int i, k;
+  double *temp = NULL;
+  double *nodal[9];
+
+  for (i = 0; i < node_num; i++)
+    node_new[i] = -1;
+  for (i = 0; i < node_num; i++)
+  {
+    if (node_old[i] < 0 || node_old[i] >= node_num || node_new[node_old[i]] != -1)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "MESH_RENUMBER - Fatal error!\n");
+      fprintf(stderr, "  node_old is not a permutation of [0, %d).\n", node_num);
+      exit(1);
+    }
+    node_new[node_old[i]] = i;
+  }
+
+  // nodal arrays
+  nodal[0] = node_xy[0];
+  nodal[1] = node_xy[1];
+  nodal[2] = rho;
+  nodal[3] = vp;
+  nodal[4] = vs;
+  for (k = 0; k < 4; k++)
+    nodal[5 + k] = c[k];
+  temp = (double *)malloc(node_num * sizeof(double));
+  for (k = 0; k < 9; k++)
+  {
+    #pragma omp parallel for
+    for (i = 0; i < node_num; i++)
+      temp[i] = nodal[k][node_old[i]];
+    memcpy(nodal[k], temp, node_num * sizeof(double));
+  }
+  free(temp);
+
+  // node numbers, element_node from 1, src_node and rec_node from 0
+  #pragma omp parallel for
+  for (i = 0; i < element_num * element_order; i++)
+    element_node[i] = node_new[element_node[i] - 1] + 1;
+  for (i = 0; i < src_num; i++)
+  {
+    if (src_node[i] >= 0)
+      src_node[i] = node_new[src_node[i]];
+  }
+  for (i = 0; i < rec_num; i++)
+  {
+    if (rec_node[i] >= 0)
+      rec_node[i] = node_new[rec_node[i]];
+  }
+}
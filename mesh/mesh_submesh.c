@@ -0,0 +1,60 @@
+int mesh_submesh(int node_num, int element_num, int element_order, int *element_node, double **node_xy, double *window,
+                 int *node_sub, int *node_sub_old, int *element_sub_num, int *element_node_sub)
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_submesh extracts the elements whose centroid is in window = xmin, xmax, ymin, ymax
+    and their nodes. The sub nodes keep the order of the full mesh, so the rows of a csr
+    matrix restricted to them keep the locality of the node numbering (see csr_restrict).
+
+  Output:
+    node_sub         : node_sub[full] = sub node, from 0, or -1, size node_num
+    node_sub_old     : node_sub_old[sub] = full node, from 0, size node_num at most
+    element_sub_num  : number of sub elements
+    element_node_sub : sub element_node, from 1, size element_num * element_order at most
+    return           : number of sub nodes
+*/
+{
+  int i, k, e, sub_num;
+  double x, y;
+
+  for (i = 0; i < node_num; i++)
+    node_sub[i] = -1;
+
+  *element_sub_num = 0;
+  for (e = 0; e < element_num; e++)
+  {
+    x = 0.0;
+    y = 0.0;
+    for (k = 0; k < element_order; k++)
+    {
+      x += node_xy[0][element_node[e * element_order + k] - 1];
+      y += node_xy[1][element_node[e * element_order + k] - 1];
+    }
+    x = x / element_order;
+    y = y / element_order;
+    if (x < window[0] || x > window[1] || y < window[2] || y > window[3])
+      continue;
+    for (k = 0; k < element_order; k++)
+    {
+      element_node_sub[*element_sub_num * element_order + k] = element_node[e * element_order + k];
+      node_sub[element_node[e * element_order + k] - 1] = 0;
+    }
+    *element_sub_num = *element_sub_num + 1;
+  }
+
+  sub_num = 0;
+  for (i = 0; i < node_num; i++)
+  {
+    if (node_sub[i] < 0)
+      continue;
+    node_sub[i] = sub_num;
+    node_sub_old[sub_num] = i;
+    sub_num++;
+  }
+  for (k = 0; k < *element_sub_num * element_order; k++)
+    element_node_sub[k] = node_sub[element_node_sub[k] - 1] + 1;
+
+  return sub_num;
+}
@@ -0,0 +1,103 @@
+double text_parse_double(const char *p, const char *end, const char **next)
+/******************************************************************************/
+/*
+  Purpose:
+
+    text_parse_double reads one number [+-]digits[.digits][(e|E)[+-]digits] starting at p,
+    without looking past end, and sets *next after it (*next = p when there is no number).
+    It does not depend on the locale.
+
+    Numbers with at most 19 significant digits, a mantissa below 2^53 and a power of ten
+    within 10^22 (all the "%f" output of seisfem) are converted exactly with one multiply
+    or divide, so the result is the correctly rounded value, the same as strtod. Any other
+    number is copied and given to strtod.
+*/
+{
+  static const double power10[23] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char *start = p;
+  unsigned long long mantissa = 0;
+  int negative = 0, digit_num = 0, significant = 0, exponent = 0, exponent_value = 0, exponent_negative = 0;
+  char buffer[128];
+  double value;
+
+  *next = start;
+  if (p < end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    p++;
+  }
+  for (; p < end && *p >= '0' && *p <= '9'; p++, digit_num++)
+  {
+    if (significant > 0 || *p != '0')
+    {
+      if (significant < 19)
+        mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+      else
+        exponent++;
+      significant++;
+    }
+  }
+  if (p < end && *p == '.')
+  {
+    p++;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digit_num++)
+    {
+      if (significant > 0 || *p != '0')
+      {
+        if (significant < 19)
+        {
+          mantissa = mantissa * 10 + (unsigned long long)(*p - '0');
+          exponent--;
+        }
+        significant++;
+      }
+      else
+        exponent--;
+    }
+  }
+  if (digit_num == 0)
+    return 0.0;
+  if (p < end && (*p == 'e' || *p == 'E'))
+  {
+    const char *q = p + 1;
+    if (q < end && (*q == '-' || *q == '+'))
+    {
+      exponent_negative = (*q == '-');
+      q++;
+    }
+    if (q < end && *q >= '0' && *q <= '9')
+    {
+      for (; q < end && *q >= '0' && *q <= '9'; q++)
+      {
+        if (exponent_value < 100000)
+          exponent_value = exponent_value * 10 + (*q - '0');
+      }
+      exponent = exponent + (exponent_negative ? -exponent_value : exponent_value);
+      p = q;
+    }
+  }
+  *next = p;
+
+  if (significant <= 19 && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22)
+  {
+    value = (double)mantissa;
+    if (exponent < 0)
+      value = value / power10[-exponent];
+    else
+      value = value * power10[exponent];
+    return negative ? -value : value;
+  }
+
+  // slow path
+  if (p - start >= (long)sizeof(buffer))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "TEXT_PARSE_DOUBLE - Fatal error!\n");
+    fprintf(stderr, "  Number of %ld characters is too long.\n", (long)(p - start));
+    exit(1);
+  }
+  memcpy(buffer, start, p - start);
+  buffer[p - start] = '\0';
+  return strtod(buffer, NULL);
+}
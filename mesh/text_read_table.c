@@ -0,0 +1,195 @@
+int text_read_table(char *filename, int column_num, int row_num_expect, int *int_data, double *double_data)
+/******************************************************************************/
+/*
+  Purpose:
+
+    text_read_table reads a text file of column_num numbers per line (element_node.txt,
+    node_xy.txt, velocity_and_density.txt, ...) into int_data or double_data, row after row,
+    and returns the number of rows. Empty lines are skipped. The file must have row_num_expect
+    rows, the size of the arrays. With int_data = double_data = NULL the rows are only counted
+    (row_num_expect is not used), e.g. when element_and_node_num.txt is missing.
+
+    The file is mapped with mmap and cut at line boundaries into one piece per thread:
+    1. every thread counts the rows of its piece, the counts give the first row of each piece;
+    2. every thread parses its piece with text_parse_double (no fscanf, no locale).
+
+    A line without exactly column_num numbers (integers for int_data) is a fatal error that
+    gives the file, the line and the column of the first bad line.
+*/
+{
+  int thread_num, thread_id, k, row_num, bad_thread;
+  long i, line, error_line, error_column, error_found;
+  long *row_first = NULL;
+  long *piece = NULL;
+  long *piece_line = NULL;
+  long *thread_error_line = NULL;
+  long *thread_error_column = NULL;
+  long *thread_error_found = NULL;
+  int fd;
+  size_t size;
+  struct stat file_stat;
+  char *text;
+
+  if ((fd = open(filename, O_RDONLY)) < 0 || fstat(fd, &file_stat) != 0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "TEXT_READ_TABLE - Fatal error!\n");
+    fprintf(stderr, "  Can not open %s.\n", filename);
+    exit(1);
+  }
+  size = (size_t)file_stat.st_size;
+  if (size == 0)
+  {
+    close(fd);
+    return 0;
+  }
+  text = (char *)mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (text == MAP_FAILED)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "TEXT_READ_TABLE - Fatal error!\n");
+    fprintf(stderr, "  Can not map %s.\n", filename);
+    exit(1);
+  }
+
+  // pieces start after a '\n', piece[t] to piece[t+1]
+  thread_num = omp_get_max_threads();
+  if ((long)size < 65536L * thread_num)
+    thread_num = 1;
+  piece = (long *)malloc((thread_num + 1) * sizeof(long));
+  piece_line = (long *)calloc(thread_num + 1, sizeof(long));
+  row_first = (long *)calloc(thread_num + 1, sizeof(long));
+  thread_error_line = (long *)malloc(thread_num * sizeof(long));
+  thread_error_column = (long *)malloc(thread_num * sizeof(long));
+  thread_error_found = (long *)calloc(thread_num, sizeof(long));
+  piece[0] = 0;
+  for (k = 1; k < thread_num; k++)
+  {
+    i = (long)(size / thread_num) * k;
+    if (i < piece[k - 1])
+      i = piece[k - 1];
+    while (i < (long)size && text[i - 1] != '\n')
+      i++;
+    piece[k] = i;
+  }
+  piece[thread_num] = (long)size;
+
+  // 1. rows and lines of every piece
+  #pragma omp parallel num_threads(thread_num) private(thread_id, i)
+  {
+    long rows = 0, lines = 0;
+    int blank = 1;
+    thread_id = omp_get_thread_num();
+    for (i = piece[thread_id]; i < piece[thread_id + 1]; i++)
+    {
+      if (text[i] == '\n')
+      {
+        rows = rows + (blank == 0);
+        lines++;
+        blank = 1;
+      }
+      else if (text[i] != ' ' && text[i] != '\t' && text[i] != '\r')
+        blank = 0;
+    }
+    rows = rows + (blank == 0); // last line without '\n'
+    row_first[thread_id + 1] = rows;
+    piece_line[thread_id + 1] = lines;
+  }
+  for (k = 0; k < thread_num; k++)
+  {
+    row_first[k + 1] = row_first[k + 1] + row_first[k];
+    piece_line[k + 1] = piece_line[k + 1] + piece_line[k];
+  }
+  row_num = (int)row_first[thread_num];
+  if ((int_data != NULL || double_data != NULL) && row_num != row_num_expect)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "TEXT_READ_TABLE - Fatal error!\n");
+    fprintf(stderr, "  %s has %d lines of numbers, %d are expected.\n", filename, row_num, row_num_expect);
+    exit(1);
+  }
+
+  // 2. parse
+  if (int_data != NULL || double_data != NULL)
+  {
+    #pragma omp parallel num_threads(thread_num) private(thread_id, line, k)
+    {
+      const char *p, *q, *end;
+      long row;
+      double value;
+      thread_id = omp_get_thread_num();
+      row = row_first[thread_id];
+      line = piece_line[thread_id] + 1;
+      p = text + piece[thread_id];
+      end = text + piece[thread_id + 1];
+      while (p < end && thread_error_found[thread_id] == 0)
+      {
+        const char *line_start = p;
+        k = 0;
+        while (1)
+        {
+          while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+          if (p >= end || *p == '\n')
+            break;
+          value = text_parse_double(p, end, &q);
+          if (q == p || (q < end && *q != ' ' && *q != '\t' && *q != '\r' && *q != '\n') || k >= column_num ||
+              (int_data != NULL && value != (double)(int)value))
+          {
+            thread_error_found[thread_id] = 1;
+            thread_error_line[thread_id] = line;
+            thread_error_column[thread_id] = (long)(p - line_start) + 1;
+            break;
+          }
+          if (int_data != NULL)
+            int_data[row * column_num + k] = (int)value;
+          else
+            double_data[row * column_num + k] = value;
+          k++;
+          p = q;
+        }
+        if (thread_error_found[thread_id] == 0 && k > 0 && k < column_num)
+        {
+          thread_error_found[thread_id] = 1;
+          thread_error_line[thread_id] = line;
+          thread_error_column[thread_id] = (long)(p - line_start) + 1;
+        }
+        row = row + (k > 0);
+        line++;
+        if (p < end)
+          p++; // '\n'
+      }
+    }
+    // the first bad line of the file
+    error_found = 0;
+    bad_thread = -1;
+    for (k = 0; k < thread_num; k++)
+    {
+      if (thread_error_found[k] != 0 && error_found == 0)
+      {
+        error_found = 1;
+        bad_thread = k;
+      }
+    }
+    if (error_found != 0)
+    {
+      error_line = thread_error_line[bad_thread];
+      error_column = thread_error_column[bad_thread];
+      fprintf(stderr, "\n");
+      fprintf(stderr, "TEXT_READ_TABLE - Fatal error!\n");
+      fprintf(stderr, "  %s:%ld:%ld: line %ld is not %d numbers.\n", filename, error_line, error_column, error_line, column_num);
+      exit(1);
+    }
+  }
+
+  munmap(text, size);
+  free(piece);
+  free(piece_line);
+  free(row_first);
+  free(thread_error_line);
+  free(thread_error_column);
+  free(thread_error_found);
+
+  return row_num;
+}
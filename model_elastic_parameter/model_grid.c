@@ -0,0 +1,99 @@
+void model_grid(int model_grid_type, int node_num, double **node_xy, int nx, int ny, double x0, double y0, double dx, double dy,
+                double *rho, double *vp, double *vs, double **c)
+/******************************************************************************/
+/*
+  Purpose:
+
+    model_grid sets the model at the nodes from a gridded binary model (Marmousi, SEG/EAGE
+    ... cut to raw floats), one file per field in ./mesh, see model_grid_map:
+
+      model_grid_type = 1: model_rho.bin, model_vp.bin, model_vs.bin
+                           c11 = c33 = rho * vp^2, c13 = c11 - 2 * c44, c44 = rho * vs^2
+      model_grid_type = 2: model_rho.bin, model_c11.bin, model_c13.bin, model_c33.bin, model_c44.bin
+                           vp = sqrt(c11 / rho), vs = sqrt(c44 / rho)
+
+    Every file is mapped, interpolated at the nodes by model_grid_sample and released
+    before the next one, so only the pages under the mesh are read. rho, vp, c11 and c33
+    must be > 0 and vs, c44 >= 0 at every node, or it is a fatal error.
+
+  Output:
+    rho[node_num], vp[node_num], vs[node_num], c[4][node_num]: c11, c13, c33, c44
+*/
+{
+  int i, k;
+  float *grid;
+  size_t map_size;
+  char *name_vti[5] = {"./mesh/model_rho.bin", "./mesh/model_c11.bin", "./mesh/model_c13.bin", "./mesh/model_c33.bin", "./mesh/model_c44.bin"};
+  char *name_iso[3] = {"./mesh/model_rho.bin", "./mesh/model_vp.bin", "./mesh/model_vs.bin"};
+  double *field_vti[5];
+  double *field_iso[3];
+
+  if (nx < 1 || ny < 1 || dx <= 0.0 || dy <= 0.0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MODEL_GRID - Fatal error!\n");
+    fprintf(stderr, "  The grid %d x %d with dx = %f, dy = %f is not valid.\n", nx, ny, dx, dy);
+    exit(1);
+  }
+  map_size = (size_t)nx * ny * sizeof(float);
+
+  if (model_grid_type == 1)
+  {
+    field_iso[0] = rho;
+    field_iso[1] = vp;
+    field_iso[2] = vs;
+    for (k = 0; k < 3; k++)
+    {
+      grid = model_grid_map(name_iso[k], nx, ny);
+      model_grid_sample(node_num, node_xy, nx, ny, x0, y0, dx, dy, grid, field_iso[k]);
+      munmap(grid, map_size);
+    }
+    #pragma omp parallel for
+    for (i = 0; i < node_num; i++)
+    {
+      c[3][i] = rho[i] * vs[i] * vs[i];
+      c[0][i] = rho[i] * vp[i] * vp[i];
+      c[1][i] = c[0][i] - 2.0 * c[3][i];
+      c[2][i] = c[0][i];
+    }
+  }
+  else if (model_grid_type == 2)
+  {
+    field_vti[0] = rho;
+    for (k = 0; k < 4; k++)
+      field_vti[k + 1] = c[k];
+    for (k = 0; k < 5; k++)
+    {
+      grid = model_grid_map(name_vti[k], nx, ny);
+      model_grid_sample(node_num, node_xy, nx, ny, x0, y0, dx, dy, grid, field_vti[k]);
+      munmap(grid, map_size);
+    }
+    #pragma omp parallel for
+    for (i = 0; i < node_num; i++)
+    {
+      vp[i] = sqrt(c[0][i] / rho[i]);
+      vs[i] = sqrt(c[3][i] / rho[i]);
+    }
+  }
+  else
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MODEL_GRID - Fatal error!\n");
+    fprintf(stderr, "  model_grid = %d is not 1 (rho, vp, vs) or 2 (rho, c11, c13, c33, c44).\n", model_grid_type);
+    exit(1);
+  }
+
+  // NaN fails every test as well
+  for (i = 0; i < node_num; i++)
+  {
+    if (!(rho[i] > 0.0) || !(vp[i] > 0.0) || !(vs[i] >= 0.0) || !(c[0][i] > 0.0) || !(c[2][i] > 0.0) || !(c[3][i] >= 0.0))
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "MODEL_GRID - Fatal error!\n");
+      fprintf(stderr, "  rho = %f, vp = %f, vs = %f, c11 = %f, c33 = %f, c44 = %f at node %d (%f, %f) of the grid model,\n",
+              rho[i], vp[i], vs[i], c[0][i], c[2][i], c[3][i], i + 1, node_xy[0][i], node_xy[1][i]);
+      fprintf(stderr, "  rho, vp, c11, c33 must be > 0 and vs, c44 >= 0.\n");
+      exit(1);
+    }
+  }
+}
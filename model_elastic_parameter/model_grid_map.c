@@ -0,0 +1,46 @@
+float *model_grid_map(char *filename, int nx, int ny)
+/******************************************************************************/
+/*
+  Purpose:
+
+    model_grid_map maps one field of a gridded model: nx * ny samples of 4-byte floats
+    (native byte order, no header), x the fast axis, i.e. sample (ix, iy) at ix + nx * iy.
+    The mapping is read only, the pages are read from the file when model_grid_sample
+    touches them, so a grid of 100M samples is never loaded as a whole.
+
+    Return the mapping, to be released with munmap(map, (size_t)nx * ny * sizeof(float)).
+    A file that is missing or does not hold nx * ny floats is a fatal error.
+*/
+{
+  int fd;
+  size_t map_size;
+  struct stat file_stat;
+  void *map;
+
+  map_size = (size_t)nx * ny * sizeof(float);
+  if ((fd = open(filename, O_RDONLY)) < 0 || fstat(fd, &file_stat) != 0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MODEL_GRID_MAP - Fatal error!\n");
+    fprintf(stderr, "  Can not open %s.\n", filename);
+    exit(1);
+  }
+  if ((size_t)file_stat.st_size != map_size)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MODEL_GRID_MAP - Fatal error!\n");
+    fprintf(stderr, "  %s has %lld bytes, %zu are expected for %d x %d floats.\n", filename, (long long)file_stat.st_size, map_size, nx, ny);
+    exit(1);
+  }
+  map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "MODEL_GRID_MAP - Fatal error!\n");
+    fprintf(stderr, "  Can not map %s.\n", filename);
+    exit(1);
+  }
+
+  return (float *)map;
+}
@@ -0,0 +1,43 @@
+void model_grid_sample(int node_num, double **node_xy, int nx, int ny, double x0, double y0, double dx, double dy, float *grid, double *value)
+/******************************************************************************/
+/*
+  Purpose:
+
+    model_grid_sample interpolates a field of model_grid_map at the nodes, bilinear in
+    the cell of the grid (x0 + ix * dx, y0 + iy * dy) holding the node, in one parallel
+    loop over the nodes. A node out of the grid takes the value of the nearest grid edge.
+
+  Output:
+    value[node_num]
+*/
+{
+  int p, ix, iy;
+  double fx, fy;
+  size_t k;
+
+  #pragma omp parallel for private(ix, iy, fx, fy, k)
+  for (p = 0; p < node_num; p++)
+  {
+    fx = (node_xy[0][p] - x0) / dx;
+    fy = (node_xy[1][p] - y0) / dy;
+    fx = fmin(fmax(fx, 0.0), (double)(nx - 1));
+    fy = fmin(fmax(fy, 0.0), (double)(ny - 1));
+    ix = (int)fx;
+    iy = (int)fy;
+    if (ix > nx - 2)
+      ix = (nx > 1) ? nx - 2 : 0;
+    if (iy > ny - 2)
+      iy = (ny > 1) ? ny - 2 : 0;
+    fx = fx - ix;
+    fy = fy - iy;
+    k = (size_t)iy * nx + ix;
+    if (nx == 1 && ny == 1)
+      value[p] = grid[0];
+    else if (nx == 1)
+      value[p] = (1.0 - fy) * grid[k] + fy * grid[k + nx];
+    else if (ny == 1)
+      value[p] = (1.0 - fx) * grid[k] + fx * grid[k + 1];
+    else
+      value[p] = (1.0 - fy) * ((1.0 - fx) * grid[k] + fx * grid[k + 1]) + fy * ((1.0 - fx) * grid[k + nx] + fx * grid[k + nx + 1]);
+  }
+}
@@ -0,0 +1,91 @@
+double visco_sls(int node_num, int *csr_p, int *csr_j, double **c, double *q_p, double *q_s, int sls_num, double f_min, double f_max, double f_ref,
+                 double dt, double **c_u, double **visco, int *sls_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    visco_sls sets the viscoelastic model of elastic_wave: standard linear solids with
+    coarse-grained memory variables (Day, 1998). Each of the sls_num relaxation mechanisms of
+    visco_sls_weight is put on one node out of sls_num only, with its weight times sls_num, so
+    a node keeps one memory variable per stiffness term instead of sls_num. The mechanisms are
+    cycled across the neighbours: the nodes are taken in order and each one gets the mechanism
+    met the fewest times among its neighbours of the csr pattern already set, from i % sls_num.
+
+    With Y_p = sls_num * y_l / q_p and Y_s = sls_num * y_l / q_s at a node of mechanism l, the
+    stress relaxes as M_u * (e - Y * z), dz/dt = omega_l * (e - z), with the term e of the
+    stiffness row of the node (see elastic_wave). The P moduli c11, c33 relax with Y_p, c44
+    with Y_s and c13 = (c13 + 2 c44) - 2 c44 with both. c holds the moduli at f_ref, the
+    unrelaxed moduli follow from the real part of the modulus of all the mechanisms at f_ref.
+
+  Output:
+    c_u[4][node_num]   : unrelaxed c11, c13, c33, c44
+    visco[5][node_num] : exp(-omega_l * dt), c11 * Y_p, c33 * Y_p, (c13 + 2 c44) * Y_p - 2 c44 * Y_s,
+                         c44 * Y_s, from the unrelaxed moduli
+    sls_node[node_num] : mechanism of the node
+    the function returns the largest Y_p or Y_s.
+*/
+{
+  int i, k, l, best;
+  int *count = NULL;
+  double omega_ref, disp_p, disp_s, y_p, y_s, y_max;
+  double *sls_omega = NULL;
+  double *sls_y = NULL;
+
+  sls_omega = (double *)malloc(sls_num * sizeof(double));
+  sls_y = (double *)malloc(sls_num * sizeof(double));
+  count = (int *)malloc(sls_num * sizeof(int));
+  visco_sls_weight(sls_num, f_min, f_max, sls_omega, sls_y);
+
+  // mechanisms cycled across the neighbours, in the node order
+  for (i = 0; i < node_num; i++)
+  {
+    for (l = 0; l < sls_num; l++)
+      count[l] = 0;
+    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+    {
+      if (csr_j[k] < i)
+        count[sls_node[csr_j[k]]]++;
+    }
+    best = i % sls_num;
+    for (l = 0; l < sls_num; l++)
+    {
+      if (count[(i + l) % sls_num] < count[best])
+        best = (i + l) % sls_num;
+    }
+    sls_node[i] = best;
+  }
+
+  omega_ref = 2.0 * 3.1415926535898 * f_ref;
+  y_max = 0.0;
+  #pragma omp parallel for private(l, disp_p, disp_s, y_p, y_s) reduction(max : y_max)
+  for (i = 0; i < node_num; i++)
+  {
+    disp_p = 1.0;
+    disp_s = 1.0;
+    for (l = 0; l < sls_num; l++)
+    {
+      disp_p -= sls_y[l] / q_p[i] * sls_omega[l] * sls_omega[l] / (sls_omega[l] * sls_omega[l] + omega_ref * omega_ref);
+      disp_s -= sls_y[l] / q_s[i] * sls_omega[l] * sls_omega[l] / (sls_omega[l] * sls_omega[l] + omega_ref * omega_ref);
+    }
+    c_u[0][i] = c[0][i] / disp_p;
+    c_u[2][i] = c[2][i] / disp_p;
+    c_u[3][i] = c[3][i] / disp_s;
+    c_u[1][i] = (c[1][i] + 2.0 * c[3][i]) / disp_p - 2.0 * c_u[3][i];
+
+    l = sls_node[i];
+    y_p = sls_num * sls_y[l] / q_p[i];
+    y_s = sls_num * sls_y[l] / q_s[i];
+    visco[0][i] = exp(-sls_omega[l] * dt);
+    visco[1][i] = c_u[0][i] * y_p;
+    visco[2][i] = c_u[2][i] * y_p;
+    visco[3][i] = (c_u[1][i] + 2.0 * c_u[3][i]) * y_p - 2.0 * c_u[3][i] * y_s;
+    visco[4][i] = c_u[3][i] * y_s;
+    y_max = fmax(y_max, fmax(y_p, y_s));
+  }
+
+  free(sls_omega);
+  free(sls_y);
+  free(count);
+
+  return y_max;
+}
@@ -0,0 +1,107 @@
+void visco_sls_weight(int sls_num, double f_min, double f_max, double *sls_omega, double *sls_y)
+/******************************************************************************/
+/*
+  Purpose:
+
+    visco_sls_weight gives the relaxation frequencies and the weights of sls_num standard
+    linear solids for a constant Q between f_min and f_max (Emmerich and Korn, 1987): the
+    relaxation frequencies are spread evenly on a log scale over the band and the weights
+    fit, in the least squares sense at 2 * sls_num - 1 frequencies of the band,
+
+      1 / Q = sum_l Y_l * omega_l * omega / (omega_l^2 + omega^2)
+
+    for Q = 1, so Y_l = sls_y[l] / Q for any Q. The weights are kept positive: with many
+    mechanisms the plain fit alternates in sign, which a coarse-grained node can not take
+    (see visco_sls), so a negative weight is set to 0 and the others fitted again.
+
+  Output:
+    sls_omega[sls_num], sls_y[sls_num]
+*/
+{
+  int i, j, k, l, fit_num, negative;
+  int *active = NULL;
+  double omega, temp;
+  double *a = NULL;
+  double *ata = NULL;
+  double *atb = NULL;
+
+  fit_num = 2 * sls_num - 1;
+  a = (double *)malloc(fit_num * sls_num * sizeof(double));
+  ata = (double *)malloc(sls_num * sls_num * sizeof(double));
+  atb = (double *)malloc(sls_num * sizeof(double));
+  active = (int *)malloc(sls_num * sizeof(int));
+
+  for (l = 0; l < sls_num; l++)
+    sls_omega[l] = 2.0 * 3.1415926535898 * f_min * pow(f_max / f_min, (sls_num > 1) ? (double)l / (sls_num - 1) : 0.5);
+  for (k = 0; k < fit_num; k++)
+  {
+    omega = 2.0 * 3.1415926535898 * f_min * pow(f_max / f_min, (fit_num > 1) ? (double)k / (fit_num - 1) : 0.5);
+    for (l = 0; l < sls_num; l++)
+      a[k * sls_num + l] = sls_omega[l] * omega / (sls_omega[l] * sls_omega[l] + omega * omega);
+  }
+
+  // normal equations on the mechanisms still active, solved by Gauss elimination with partial
+  // pivoting; a negative weight is dropped (set to 0) and the fit done again
+  for (l = 0; l < sls_num; l++)
+    active[l] = 1;
+  do
+  {
+    for (i = 0; i < sls_num; i++)
+    {
+      atb[i] = 0.0;
+      for (k = 0; k < fit_num && active[i]; k++)
+        atb[i] += a[k * sls_num + i];
+      for (j = 0; j < sls_num; j++)
+      {
+        ata[i * sls_num + j] = (i == j && !active[i]) ? 1.0 : 0.0;
+        for (k = 0; k < fit_num && active[i] && active[j]; k++)
+          ata[i * sls_num + j] += a[k * sls_num + i] * a[k * sls_num + j];
+      }
+    }
+    for (i = 0; i < sls_num; i++)
+    {
+      k = i;
+      for (j = i + 1; j < sls_num; j++)
+      {
+        if (fabs(ata[j * sls_num + i]) > fabs(ata[k * sls_num + i]))
+          k = j;
+      }
+      for (j = 0; j < sls_num; j++)
+      {
+        temp = ata[i * sls_num + j];
+        ata[i * sls_num + j] = ata[k * sls_num + j];
+        ata[k * sls_num + j] = temp;
+      }
+      temp = atb[i];
+      atb[i] = atb[k];
+      atb[k] = temp;
+      for (j = i + 1; j < sls_num; j++)
+      {
+        temp = ata[j * sls_num + i] / ata[i * sls_num + i];
+        for (l = i; l < sls_num; l++)
+          ata[j * sls_num + l] -= temp * ata[i * sls_num + l];
+        atb[j] -= temp * atb[i];
+      }
+    }
+    for (i = sls_num - 1; i >= 0; i--)
+    {
+      temp = atb[i];
+      for (j = i + 1; j < sls_num; j++)
+        temp -= ata[i * sls_num + j] * sls_y[j];
+      sls_y[i] = temp / ata[i * sls_num + i];
+    }
+    negative = -1;
+    for (l = 0; l < sls_num; l++)
+    {
+      if (sls_y[l] < 0.0 && (negative < 0 || sls_y[l] < sls_y[negative]))
+        negative = l;
+    }
+    if (negative >= 0)
+      active[negative] = 0;
+  } while (negative >= 0);
+
+  free(a);
+  free(ata);
+  free(atb);
+  free(active);
+}
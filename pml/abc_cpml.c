@@ -0,0 +1,37 @@
+void abc_cpml(int node_num, double *mpml_dx, double *mpml_dy, double f0, double dt,
+              double *cpml_ax, double *cpml_bx, double *cpml_ay, double *cpml_by)
+/******************************************************************************/
+/*
+  Purpose:
+
+   abc_cpml gives the coefficients of the recursive convolution of the c-pml (see
+   elastic_wave_cpml) from the damping profiles of abc_mpml or abc_mpml_distance, with
+   their multi-axial ratios (pxy = pyx = 0.15):
+
+     dx = mpml_dx = d_x + pxy * d_y,  dy = mpml_dy = d_y + pyx * d_x
+
+   The stretching 1 / s_x = 1 - dx / (alpha + dx + i w), with the frequency shift alpha = pi * f0
+   (complex frequency shifted pml), is the convolution psi_n = b_x * psi_n-1 + a_x * f_n with
+
+     b_x = exp(-(dx + alpha) * dt),  a_x = dx / (dx + alpha) * (b_x - 1)
+
+   and the same in y. a_x = a_y = 0 out of the pml.
+
+   Output:
+     cpml_ax, cpml_bx, cpml_ay, cpml_by
+*/
+{
+	int p;
+	double alpha;
+
+	alpha = 3.1415926535898 * f0;
+
+	#pragma omp parallel for
+	for (p = 0; p < node_num; p++)
+	{
+		cpml_bx[p] = exp(-(mpml_dx[p] + alpha) * dt);
+		cpml_by[p] = exp(-(mpml_dy[p] + alpha) * dt);
+		cpml_ax[p] = (mpml_dx[p] > 0.0) ? mpml_dx[p] / (mpml_dx[p] + alpha) * (cpml_bx[p] - 1.0) : 0.0;
+		cpml_ay[p] = (mpml_dy[p] > 0.0) ? mpml_dy[p] / (mpml_dy[p] + alpha) * (cpml_by[p] - 1.0) : 0.0;
+	}
+}
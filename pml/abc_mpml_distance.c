@@ -0,0 +1,127 @@
+void abc_mpml_distance(int node_num, int element_order, int *element_node, double **node_xy, int *csr_p, int *csr_j,
+                       int edge_num, int *edge_node, int *edge_element, int *edge_tag,
+                       int mpml_nx, int mpml_ny, double h, double vp_max,
+                       double *mpml_dx, double *mpml_dy, double *mpml_dxx, double *mpml_dyy, double *mpml_dxx_pyx, double *mpml_dyy_pxy)
+/******************************************************************************/
+/*
+  Purpose:
+
+    abc_mpml_distance gives the mpml profiles of abc_mpml from the distance of the nodes
+    to the absorbing boundary edges (edge_tag = 1, see mesh_boundary_edge and
+    mesh_boundary_tag) instead of the areas of a rectangle, for any mesh shape.
+
+    The absorbing edges are split by their direction: the edges closer to the y axis
+    (|dy| >= |dx|) damp in x, the others in y. pml_distance gives the distance dist_x to the
+    first ones up to mpml_nx * h and dist_y to the others up to mpml_ny * h, then in one
+    parallel pass over the nodes
+
+      d_x = d0_x * ((thick_x - dist_x) / thick_x)^2,  d_x' = 2 * d0_x * (thick_x - dist_x) / thick_x^2
+
+    (the same in y) with d0 and the multi-axial ratios pxy = pyx = 0.15 of abc_mpml:
+
+      mpml_dx = d_x + pxy * d_y,  mpml_dy = d_y + pyx * d_x,
+      mpml_dxx = -d_x' * ddist_x/dx,  mpml_dyy = -d_y' * ddist_y/dy
+
+    The gradient of the distance is the unit vector from the nearest point of the edge to the
+    node, the inward normal of the edge on the edge. On the box of a structured mesh this is
+    abc_mpml, but for the corners next to the free surface: there the nodes are damped in
+    y only.
+
+  Output:
+     mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy
+*/
+{
+  int k, p, a, b, dir, e;
+  double pxy, pyx, Rcoef;
+  double ex, ey, len, nx, ny, cx, cy, px, py, t;
+  double thick[2], d0[2], d[2], dd[2];
+  int *edge_select[2];
+  int *dist_edge[2];
+  double *dist[2];
+
+  pxy = 0.15;
+  pyx = 0.15;
+  Rcoef = 0.0001;
+  thick[0] = h * mpml_nx;
+  thick[1] = h * mpml_ny;
+  for (dir = 0; dir < 2; dir++)
+  {
+    d0[dir] = 3.0 * vp_max * log10(1.0 / Rcoef) / (2.0 * thick[dir]);
+    edge_select[dir] = (int *)malloc(edge_num * sizeof(int));
+    dist_edge[dir] = (int *)malloc(node_num * sizeof(int));
+    dist[dir] = (double *)malloc(node_num * sizeof(double));
+  }
+
+  for (k = 0; k < edge_num; k++)
+  {
+    a = edge_node[2 * k] - 1;
+    b = edge_node[2 * k + 1] - 1;
+    ex = node_xy[0][b] - node_xy[0][a];
+    ey = node_xy[1][b] - node_xy[1][a];
+    edge_select[0][k] = (edge_tag[k] == 1 && fabs(ey) >= fabs(ex));
+    edge_select[1][k] = (edge_tag[k] == 1 && fabs(ey) < fabs(ex));
+  }
+  for (dir = 0; dir < 2; dir++)
+    pml_distance(node_num, node_xy, csr_p, csr_j, edge_num, edge_node, edge_select[dir], thick[dir], dist[dir], dist_edge[dir]);
+
+  #pragma omp parallel for private(k, a, b, dir, e, ex, ey, len, nx, ny, cx, cy, px, py, t, d, dd)
+  for (p = 0; p < node_num; p++)
+  {
+    for (dir = 0; dir < 2; dir++)
+    {
+      d[dir] = 0.0;
+      dd[dir] = 0.0;
+      e = dist_edge[dir][p];
+      if (e < 0 || dist[dir][p] >= thick[dir])
+        continue;
+      d[dir] = d0[dir] * ((thick[dir] - dist[dir][p]) / thick[dir]) * ((thick[dir] - dist[dir][p]) / thick[dir]);
+
+      // gradient of the distance, along x for dir = 0, along y for dir = 1
+      a = edge_node[2 * e] - 1;
+      b = edge_node[2 * e + 1] - 1;
+      ex = node_xy[0][b] - node_xy[0][a];
+      ey = node_xy[1][b] - node_xy[1][a];
+      len = sqrt(ex * ex + ey * ey);
+      if (dist[dir][p] > 1.0e-6 * h)
+      {
+        px = node_xy[0][p] - node_xy[0][a];
+        py = node_xy[1][p] - node_xy[1][a];
+        t = fmin(1.0, fmax(0.0, (px * ex + py * ey) / (len * len)));
+        nx = (px - t * ex) / dist[dir][p];
+        ny = (py - t * ey) / dist[dir][p];
+      }
+      else
+      {
+        // on the edge: the normal towards the centre of its element
+        nx = -ey / len;
+        ny = ex / len;
+        cx = 0.0;
+        cy = 0.0;
+        for (k = 0; k < element_order; k++)
+        {
+          cx += node_xy[0][element_node[edge_element[e] * element_order + k] - 1] / element_order;
+          cy += node_xy[1][element_node[edge_element[e] * element_order + k] - 1] / element_order;
+        }
+        if (nx * (cx - node_xy[0][a]) + ny * (cy - node_xy[1][a]) < 0.0)
+        {
+          nx = -nx;
+          ny = -ny;
+        }
+      }
+      dd[dir] = -2.0 * d0[dir] * (thick[dir] - dist[dir][p]) / (thick[dir] * thick[dir]) * ((dir == 0) ? nx : ny);
+    }
+    mpml_dx[p] = d[0] + pxy * d[1];
+    mpml_dy[p] = d[1] + pyx * d[0];
+    mpml_dxx[p] = dd[0];
+    mpml_dyy[p] = dd[1];
+    mpml_dxx_pyx[p] = pyx * mpml_dxx[p];
+    mpml_dyy_pxy[p] = pxy * mpml_dyy[p];
+  }
+
+  for (dir = 0; dir < 2; dir++)
+  {
+    free(edge_select[dir]);
+    free(dist_edge[dir]);
+    free(dist[dir]);
+  }
+}
@@ -0,0 +1,170 @@
+void pml_distance(int node_num, double **node_xy, int *csr_p, int *csr_j, int edge_num, int *edge_node, int *edge_select,
+                  double dist_max, double *dist, int *dist_edge)
+/******************************************************************************/
+/*
+  Purpose:
+
+    pml_distance gives the distance of every node to the nearest selected boundary edge
+    (edge_select[k] = 1), up to dist_max, by a Dijkstra sweep over the node graph of the
+    csr pattern (csr_j from 0). Every node carries its nearest edge, a node reached from
+    a neighbour takes the nearest of the edge of that neighbour and the edges next to it
+    along the boundary, with its own distance to the segment of the edge, so the distance
+    is the straight line distance to the boundary and not the length of a path along the
+    mesh. The sweep stops at dist_max, only the nodes of the pml layer
+    are visited.
+
+  Output:
+
+    dist[node_num], the distance, dist_max for the nodes farther than dist_max;
+    dist_edge[node_num], the nearest edge, -1 for the nodes farther than dist_max.
+*/
+{
+  int i, j, k, m, n, e, a, b, child, heap_num, heap_max, node_temp, edge_best;
+  double ax, ay, bx, by, px, py, t, len2, d, d_temp;
+  int *heap_node = NULL;
+  double *heap_dist = NULL;
+  int *incident_p = NULL;
+  int *incident_e = NULL;
+
+  #pragma omp parallel for
+  for (i = 0; i < node_num; i++)
+  {
+    dist[i] = dist_max;
+    dist_edge[i] = -1;
+  }
+
+  // the selected edges at every node, csr like
+  incident_p = (int *)calloc(node_num + 1, sizeof(int));
+  for (e = 0; e < edge_num; e++)
+  {
+    if (edge_select[e] != 1)
+      continue;
+    incident_p[edge_node[2 * e] - 1]++;
+    incident_p[edge_node[2 * e + 1] - 1]++;
+  }
+  for (i = 1; i < node_num; i++)
+    incident_p[i] += incident_p[i - 1];
+  incident_p[node_num] = incident_p[node_num - 1];
+  incident_e = (int *)malloc((incident_p[node_num] + 1) * sizeof(int));
+  for (e = 0; e < edge_num; e++)
+  {
+    if (edge_select[e] != 1)
+      continue;
+    incident_e[--incident_p[edge_node[2 * e] - 1]] = e;
+    incident_e[--incident_p[edge_node[2 * e + 1] - 1]] = e;
+  }
+
+  // binary heap of (distance, node), a node may be pushed again with a smaller distance
+  heap_max = 1024;
+  heap_num = 0;
+  heap_node = (int *)malloc(heap_max * sizeof(int));
+  heap_dist = (double *)malloc(heap_max * sizeof(double));
+
+  // seeds: the corner nodes of the selected edges, at distance 0
+  for (e = 0; e < edge_num; e++)
+  {
+    if (edge_select[e] != 1)
+      continue;
+    for (k = 0; k < 2; k++)
+    {
+      i = edge_node[2 * e + k] - 1;
+      if (dist_edge[i] >= 0)
+        continue;
+      dist[i] = 0.0;
+      dist_edge[i] = e;
+      if (heap_num == heap_max)
+      {
+        heap_max = 2 * heap_max;
+        heap_node = (int *)realloc(heap_node, heap_max * sizeof(int));
+        heap_dist = (double *)realloc(heap_dist, heap_max * sizeof(double));
+      }
+      heap_node[heap_num] = i;
+      heap_dist[heap_num] = 0.0;
+      heap_num++;
+    }
+  }
+
+  // sweep: pop the nearest node, pass its edge to the neighbours
+  while (heap_num > 0)
+  {
+    i = heap_node[0];
+    d = heap_dist[0];
+    heap_num--;
+    node_temp = heap_node[heap_num];
+    d_temp = heap_dist[heap_num];
+    j = 0;
+    while ((child = 2 * j + 1) < heap_num)
+    {
+      if (child + 1 < heap_num && heap_dist[child + 1] < heap_dist[child])
+        child++;
+      if (heap_dist[child] >= d_temp)
+        break;
+      heap_node[j] = heap_node[child];
+      heap_dist[j] = heap_dist[child];
+      j = child;
+    }
+    heap_node[j] = node_temp;
+    heap_dist[j] = d_temp;
+    if (d > dist[i])
+      continue;
+
+    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+    {
+      // distance of the neighbour to the edge of node i and the edges next to it
+      j = csr_j[k];
+      d = dist[j];
+      edge_best = -1;
+      for (m = 0; m < 2; m++)
+      {
+        n = edge_node[2 * dist_edge[i] + m] - 1;
+        for (e = incident_p[n]; e < incident_p[n + 1]; e++)
+        {
+          a = edge_node[2 * incident_e[e]] - 1;
+          b = edge_node[2 * incident_e[e] + 1] - 1;
+          ax = node_xy[0][a];
+          ay = node_xy[1][a];
+          bx = node_xy[0][b] - ax;
+          by = node_xy[1][b] - ay;
+          len2 = bx * bx + by * by;
+          px = node_xy[0][j] - ax;
+          py = node_xy[1][j] - ay;
+          t = (len2 > 0.0) ? (px * bx + py * by) / len2 : 0.0;
+          t = fmin(1.0, fmax(0.0, t));
+          px = px - t * bx;
+          py = py - t * by;
+          t = sqrt(px * px + py * py);
+          if (t < d)
+          {
+            d = t;
+            edge_best = incident_e[e];
+          }
+        }
+      }
+      if (edge_best < 0)
+        continue;
+      dist[j] = d;
+      dist_edge[j] = edge_best;
+      if (heap_num == heap_max)
+      {
+        heap_max = 2 * heap_max;
+        heap_node = (int *)realloc(heap_node, heap_max * sizeof(int));
+        heap_dist = (double *)realloc(heap_dist, heap_max * sizeof(double));
+      }
+      child = heap_num;
+      heap_num++;
+      while (child > 0 && heap_dist[(child - 1) / 2] > d)
+      {
+        heap_node[child] = heap_node[(child - 1) / 2];
+        heap_dist[child] = heap_dist[(child - 1) / 2];
+        child = (child - 1) / 2;
+      }
+      heap_node[child] = j;
+      heap_dist[child] = d;
+    }
+  }
+
+  free(heap_node);
+  free(heap_dist);
+  free(incident_p);
+  free(incident_e);
+}
@@ -4,26 +4,99 @@
 #include <math.h>
 #include <time.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
 #include "../../mesh/element_type.c"
 #include "../../mesh/mesh_element_order.c"
 #include "../../mesh/mesh_node_num.c"
 #include "../../mesh/mesh_element_num.c"
 #include "../../mesh/mesh_element.c"
 #include "../../mesh/mesh_xy.c"
+#include "../../mesh/mesh_bandwidth.c"
+#include "../../mesh/hilbert_index.c"
+#include "../../mesh/hilbert_order.c"
+#include "../../mesh/mesh_rcm.c"
+#include "../../mesh/mesh_renumber.c"
+#include "../../mesh/mesh_element_sort.c"
+#include "../../mesh/mesh_first_touch.c"
+#include "../../mesh/mesh_element_block.c"
+#include "../../mesh/mesh_binary_layout.c"
+#include "../../mesh/mesh_binary_write.c"
+#include "../../mesh/mesh_binary_read.c"
+#include "../../mesh/text_parse_double.c"
+#include "../../mesh/text_read_table.c"
+#include "../../mesh/gmsh_read_size.c"
+#include "../../mesh/gmsh_read_int.c"
+#include "../../mesh/gmsh_read_double.c"
+#include "../../mesh/gmsh_skip_section.c"
+#include "../../mesh/gmsh_element_type.c"
+#include "../../mesh/gmsh_element_node_num.c"
+#include "../../mesh/gmsh_read.c"
+#include "../../mesh/element_vertex.c"
+#include "../../mesh/mesh_boundary_edge.c"
+#include "../../mesh/mesh_boundary_tag.c"
+#include "../../mesh/mesh_boundary_physical.c"
+#include "../../mesh/mesh_boundary_node.c"
+#include "../../mesh/mesh_submesh.c"
 #include "../../assemble/mass_sparse_all.c"
 #include "../../assemble/stif_sparse_all.c"
+#include "../../assemble/mass_sparse_update.c"
 #include "../../model_elastic_parameter/model_elastic_parameter.c"
+#include "../../model_elastic_parameter/model_grid_map.c"
+#include "../../model_elastic_parameter/model_grid_sample.c"
+#include "../../model_elastic_parameter/model_grid.c"
+#include "../../model_elastic_parameter/visco_sls_weight.c"
+#include "../../model_elastic_parameter/visco_sls.c"
 #include "../../pml/abc_mpml.c"
+#include "../../pml/pml_distance.c"
+#include "../../pml/abc_mpml_distance.c"
+#include "../../pml/abc_cpml.c"
+#include "../../sparse_matrix/coo2csr.c"
+#include "../../sparse_matrix/csr_pattern.c"
+#include "../../sparse_matrix/csr_scatter_map.c"
 #include "../../sparse_matrix/csr_matvec.c"
-#include "../../source_receiver/node_location.c"
+#include "../../sparse_matrix/csr_restrict.c"
+#include "../../source_receiver/element_grid.c"
+#include "../../source_receiver/element_locate.c"
+#include "../../source_receiver/point_weight.c"
+#include "../../source_receiver/set_point_node.c"
 #include "../../source_receiver/set_receiver_node.c"
 #include "../../source_receiver/set_source_node.c"
 #include "../../source_receiver/seismic_source.c"
 #include "../../source_receiver/set_rec_and_src.c"
+#include "../../source_receiver/source_time_function.c"
+#include "../../source_receiver/source_wavelet.c"
+#include "../../source_receiver/source_injection.c"
+#include "../../source_receiver/reciprocity_shot.c"
+#include "../../source_receiver/reciprocity_gather.c"
+#include "../../source_receiver/reciprocity_write.c"
+#include "../../source_receiver/aperture_window.c"
 #include "../../solver/solver_type.c"
 #include "../../solver/pardiso/pardiso_unsym.c"
 #include "../../solver/mgmres/mgmres.c"
+#include "../../cache/fnv1a_hash.c"
+#include "../../cache/operator_hash.c"
+#include "../../cache/operator_cache_layout.c"
+#include "../../cache/operator_cache_write.c"
+#include "../../cache/operator_cache_read.c"
+#include "../../time_evolution/elastic_operator.c"
+#include "../../time_evolution/wavefield_dft.c"
+#include "../../time_evolution/wavefield_dft_write.c"
 #include "../../time_evolution/elastic_wave.c"
+#include "../../time_evolution/acoustic.c"
+#include "../../time_evolution/acoustic_pml.c"
+#include "../../time_evolution/elastic_cpml_step.c"
+#include "../../time_evolution/elastic_wave_cpml.c"
+#include "../../time_evolution/revolve_beta.c"
+#include "../../time_evolution/revolve.c"
+#include "../../time_evolution/checkpoint_copy.c"
+#include "../../time_evolution/boundary_copy.c"
+#include "../../time_evolution/elastic_boundary_step.c"
+#include "../../time_evolution/elastic_gradient.c"
+#include "../../time_evolution/elastic_wave_reverse.c"
+#include "../../time_evolution/elastic_wave_aperture.c"
 
 int main()
 /******************************************************************************/
@@ -53,7 +126,7 @@ int main()
   /***************************************
           model mesh parameters  		
   ****************************************/
-  int i, j;
+  int i, j, k;
   char *type;
   char *solver;
   int type_code = 0;
@@ -74,9 +147,96 @@ int main()
   double edge_size = 0.0;
   int *element_node = NULL;
   double **node_xy = NULL;
+  double *table = NULL; // rows of a text file, see text_read_table
   double program_start_time, program_run_time;
   int use_exterior_mesh = 0;
   int free_surface_code = 0;
+  int mesh_swap_xy = 0;
+  double *swap_temp = NULL;
+  double x_swap;
+  /***************************************
+     boundary edges and physical groups of
+     a Gmsh mesh, see gmsh_read
+  ****************************************/
+  int boundary_edge_num = 0;
+  int *boundary_edge_node = NULL;
+  int *boundary_edge_physical = NULL;
+  int physical_num = 0;
+  int *physical_tag = NULL;
+  char **physical_name = NULL;
+  /***************************************
+     boundary edges of the connectivity, see
+     mesh_boundary_edge, mesh_boundary_tag
+  ****************************************/
+  int edge_num = 0;
+  int *edge_node = NULL;
+  int *edge_element = NULL;
+  int *edge_tag = NULL;
+  int boundary_side[5] = {1, 1, 1, 1, 2}; // xmin, xmax, ymin, ymax, other; 1: absorbing, 2: free surface, 3: fixed
+  int dirichlet_mask;
+  int dirichlet_num = 0;
+  int *dirichlet_node = NULL;
+  /***************************************
+     binary mesh, see mesh_binary_layout
+  ****************************************/
+  int mesh_output = 1;
+  void *mesh_map = NULL;
+  size_t mesh_map_size = 0;
+  /***************************************
+     node renumbering, see mesh_renumber
+  ****************************************/
+  int node_renumber = 0;
+  int *node_old = NULL;
+  int *node_new = NULL;
+  int bandwidth = 0;
+  int element_renumber = 0;
+  int *element_old = NULL;
+  int element_block_node = 2048;
+  int element_block_num = 0;
+  int *element_block_p = NULL;
+  /***************************************
+     operator: csr pattern, mass and stif1-6
+  ****************************************/
+  int csr_size = 0;
+  int *csr_p = NULL;
+  int *csr_j = NULL;
+  int *scatter_map = NULL;
+  double *mass_unit_x = NULL;
+  double *mass_csr_x = NULL;
+  double *mass_lump = NULL;
+  double *stif_csr_x[6];
+  /***************************************
+     operator cache, see cache/
+  ****************************************/
+  int operator_cache = 0;
+  unsigned long long operator_key = 0;
+  char filename_operator_cache[128];
+  void *operator_map = NULL;
+  size_t operator_map_size = 0;
+  /***************************************
+     model and mpml absorbing boundary
+  ****************************************/
+  double *rho = NULL;
+  double *vp = NULL;
+  double *vs = NULL;
+  double **c = NULL;
+  double vp_max;
+  int use_mpml_xmin = 1;
+  int use_mpml_xmax = 1; // use_pml_ymax = 0, free surface on ymax.
+  int use_mpml_ymin = 1;
+  int use_mpml_ymax = 1;
+  double *mpml_dx = NULL;
+  double *mpml_dy = NULL;
+  double *mpml_dxx = NULL;
+  double *mpml_dyy = NULL;
+  double *mpml_dxx_pyx = NULL;
+  double *mpml_dyy_pxy = NULL;
+  int pml_type = 0; // 0: mpml, 1: c-pml, see elastic_wave_cpml
+  int pml_profile = 0; // 0: areas of the box, 1: distance to the absorbing edges, see abc_mpml_distance
+  double *cpml_ax = NULL;
+  double *cpml_bx = NULL;
+  double *cpml_ay = NULL;
+  double *cpml_by = NULL;
   /***************************************
         seismic source and receiver	
   ****************************************/
@@ -86,6 +246,8 @@ int main()
   int src_num;
   int *src_node;
   int *rec_node;
+  double *src_weight;
+  double *rec_weight;
   double src_x_first;
   double src_y_first;
   double src_x_last;
@@ -98,12 +260,94 @@ int main()
   double *src_y;
   double *rec_x;
   double *rec_y;
-  double x_temp, y_temp;
+  /***************************************
+     element grid to locate the sources and
+     receivers, see element_grid
+  ****************************************/
+  int point_interpolation = 1;
+  double grid_box[4];
+  int grid_n[2];
+  int *grid_p = NULL;
+  int *grid_e = NULL;
+  /***************************************
+     shots: sparse source injection lists and
+     wavelet table, see source_injection
+  ****************************************/
+  int source_type = 0;
+  int supershot = 0;
+  int source_encoding = 0;
+  double source_shift_max = 0.1;
+  unsigned int source_seed = 1;
+  int shot_num = 0;
+  int *shot_p = NULL;
+  int *inj_node = NULL;
+  double *inj_weight = NULL;
+  int *inj_src = NULL;
+  double *src_polarity = NULL;
+  double *src_shift = NULL;
+  double *wavelet = NULL;
+  double *shot_force = NULL;
+  double angle_force = 90.0; // force direction from y to x (degree), u gets sin and w gets cos
+  double force_x, force_y;
+  int reciprocity = 0;
+  double *seismogram_all = NULL;
+  int aperture = 0; // 1: every shot on the window it can see, see elastic_wave_aperture
   /***************************************
               time evolution
   ****************************************/
   int step = 0;
   double dt = 0.0;
+  int wave_type = 0; // 0: elastic_wave, 1: acoustic, 2: acoustic_pml
+  /***************************************
+     gridded binary model, see model_grid
+  ****************************************/
+  int model_grid_type = 0; // 1: rho, vp, vs, 2: rho, c11, c13, c33, c44
+  int model_grid_nx = 0;
+  int model_grid_ny = 0;
+  double model_grid_x0 = 0.0;
+  double model_grid_y0 = 0.0;
+  double model_grid_dx = 0.0;
+  double model_grid_dy = 0.0;
+  /***************************************
+     viscoelastic model, see visco_sls
+  ****************************************/
+  int attenuation = 0; // 1: standard linear solids with coarse-grained memory variables
+  int sls_num = 4;
+  double q_p = 100.0;
+  double q_s = 50.0;
+  double sls_y_max;
+  double *q_p_node = NULL;
+  double *q_s_node = NULL;
+  double *c_u[4] = {NULL, NULL, NULL, NULL};
+  double *visco[5] = {NULL, NULL, NULL, NULL, NULL};
+  int *sls_node = NULL;
+  float *q_grid = NULL;
+  /***************************************
+     running Fourier transform of u and w,
+     see wavefield_dft
+  ****************************************/
+  char dft_frequency[128] = "";
+  char dft_box[128] = "";
+  char *dft_next = NULL;
+  int dft_freq_num = 0;
+  double *dft_freq = NULL;
+  double dft_xy[4];
+  int dft_num = 0;
+  int *dft_node = NULL;
+  /***************************************
+     forward and back again, see
+     elastic_wave_reverse
+  ****************************************/
+  int reverse = 0; // 1: c-pml shots reversed with revolve checkpoints, 2: with the boundary stream
+  double checkpoint_memory = 1024.0; // MB
+  int checkpoint_disk = 0;
+  int adjoint = 0; // 1: reverse time migration image, 2: gradients of rho, c11, c13, c33, c44
+  char observed[128] = "./observed";
+  /***************************************
+     optional parameters: key = value
+  ****************************************/
+  char par_key[64];
+  char par_value[128];
 
   /***************************************
               file pointers
@@ -112,6 +356,7 @@ int main()
   FILE *fp_element_node;
   FILE *fp_node_xy;
   FILE *fp_num;
+  FILE *fp_model_par;
 
   /***************************************
             prepare parameters
@@ -145,6 +390,97 @@ int main()
   fscanf(fp_par, "step = %d\n", &step);
   fscanf(fp_par, "solver_code = %d\n", &solver_code);
   fscanf(fp_par, "free_surface = %d\n", &free_surface_code);
+  if (free_surface_code == 1)
+    boundary_side[1] = 2;
+  // optional parameters, any order, one "key = value" per line after free_surface;
+  // old par.txt files without them keep the default values
+  while (fscanf(fp_par, " %63[a-z_0-9] = %127s", par_key, par_value) == 2)
+  {
+    if (strcmp(par_key, "operator_cache") == 0)
+      operator_cache = atoi(par_value);
+    else if (strcmp(par_key, "mesh_swap_xy") == 0)
+      mesh_swap_xy = atoi(par_value);
+    else if (strcmp(par_key, "mesh_output") == 0)
+      mesh_output = atoi(par_value);
+    else if (strcmp(par_key, "node_renumber") == 0)
+      node_renumber = atoi(par_value);
+    else if (strcmp(par_key, "element_renumber") == 0)
+      element_renumber = atoi(par_value);
+    else if (strcmp(par_key, "element_block_node") == 0)
+      element_block_node = atoi(par_value);
+    else if (strcmp(par_key, "point_interpolation") == 0)
+      point_interpolation = atoi(par_value);
+    else if (strcmp(par_key, "source_type") == 0)
+      source_type = atoi(par_value);
+    else if (strcmp(par_key, "supershot") == 0)
+      supershot = atoi(par_value);
+    else if (strcmp(par_key, "source_encoding") == 0)
+      source_encoding = atoi(par_value);
+    else if (strcmp(par_key, "source_shift_max") == 0)
+      source_shift_max = atof(par_value);
+    else if (strcmp(par_key, "angle_force") == 0)
+      angle_force = atof(par_value);
+    else if (strcmp(par_key, "reciprocity") == 0)
+      reciprocity = atoi(par_value);
+    else if (strcmp(par_key, "source_seed") == 0)
+      source_seed = (unsigned int)strtoul(par_value, NULL, 10);
+    else if (strcmp(par_key, "aperture") == 0)
+      aperture = atoi(par_value);
+    else if (strcmp(par_key, "wave_type") == 0)
+      wave_type = atoi(par_value);
+    else if (strcmp(par_key, "pml_type") == 0)
+      pml_type = atoi(par_value);
+    else if (strcmp(par_key, "pml_profile") == 0)
+      pml_profile = atoi(par_value);
+    else if (strcmp(par_key, "model_grid") == 0)
+      model_grid_type = atoi(par_value);
+    else if (strcmp(par_key, "model_grid_nx") == 0)
+      model_grid_nx = atoi(par_value);
+    else if (strcmp(par_key, "model_grid_ny") == 0)
+      model_grid_ny = atoi(par_value);
+    else if (strcmp(par_key, "model_grid_x0") == 0)
+      model_grid_x0 = atof(par_value);
+    else if (strcmp(par_key, "model_grid_y0") == 0)
+      model_grid_y0 = atof(par_value);
+    else if (strcmp(par_key, "model_grid_dx") == 0)
+      model_grid_dx = atof(par_value);
+    else if (strcmp(par_key, "model_grid_dy") == 0)
+      model_grid_dy = atof(par_value);
+    else if (strcmp(par_key, "attenuation") == 0)
+      attenuation = atoi(par_value);
+    else if (strcmp(par_key, "q_p") == 0)
+      q_p = atof(par_value);
+    else if (strcmp(par_key, "q_s") == 0)
+      q_s = atof(par_value);
+    else if (strcmp(par_key, "sls_num") == 0)
+      sls_num = atoi(par_value);
+    else if (strcmp(par_key, "dft_frequency") == 0)
+      strcpy(dft_frequency, par_value);
+    else if (strcmp(par_key, "dft_box") == 0)
+      strcpy(dft_box, par_value);
+    else if (strcmp(par_key, "reverse") == 0)
+      reverse = atoi(par_value);
+    else if (strcmp(par_key, "checkpoint_memory") == 0)
+      checkpoint_memory = atof(par_value);
+    else if (strcmp(par_key, "checkpoint_disk") == 0)
+      checkpoint_disk = atoi(par_value);
+    else if (strcmp(par_key, "adjoint") == 0)
+      adjoint = atoi(par_value);
+    else if (strcmp(par_key, "observed") == 0)
+      strcpy(observed, par_value);
+    else if (strcmp(par_key, "boundary_xmin") == 0)
+      boundary_side[0] = atoi(par_value);
+    else if (strcmp(par_key, "boundary_xmax") == 0)
+      boundary_side[1] = atoi(par_value);
+    else if (strcmp(par_key, "boundary_ymin") == 0)
+      boundary_side[2] = atoi(par_value);
+    else if (strcmp(par_key, "boundary_ymax") == 0)
+      boundary_side[3] = atoi(par_value);
+    else if (strcmp(par_key, "boundary_other") == 0)
+      boundary_side[4] = atoi(par_value);
+    else
+      printf("\n unknown parameter in par.txt: %s\n", par_key);
+  }
   fclose(fp_par);
 
   /***************************************
@@ -156,44 +492,94 @@ int main()
 
   if (use_exterior_mesh == 1)
   {
-    // use exterior mesh and read the mesh scheme
-    if ((fp_num = fopen("./mesh/element_and_node_num.txt", "r")) == NULL)
-      printf("\n element_and_node_num file cannot open\n");
-    if ((fp_element_node = fopen("./mesh/element_node.txt", "r")) == NULL)
-      printf("\n element file cannot open\n");
-    if ((fp_node_xy = fopen("./mesh/node_xy.txt", "r")) == NULL)
-      printf("\n node_xy file cannot open\n");
-    fscanf(fp_num, "element_num = %d\n", &element_num);
-    fscanf(fp_num, "node_num = %d\n", &node_num);
-    
+    // use exterior mesh and read the mesh scheme, see text_read_table
+    if ((fp_num = fopen("./mesh/element_and_node_num.txt", "r")) != NULL)
+    {
+      fscanf(fp_num, "element_num = %d\n", &element_num);
+      fscanf(fp_num, "node_num = %d\n", &node_num);
+      fclose(fp_num);
+    }
+    else
+    {
+      element_num = text_read_table("./mesh/element_node.txt", element_order, 0, NULL, NULL);
+      node_num = text_read_table("./mesh/node_xy.txt", 2, 0, NULL, NULL);
+      printf("\n element_and_node_num.txt is missing, the numbers are counted from the mesh files\n");
+    }
+
     element_node = (int *)malloc(element_order * element_num * sizeof(int));
     node_xy = (double **)malloc(2 * sizeof(double));
     for (i = 0; i < 2; i++)
       node_xy[i] = malloc(sizeof(double) * node_num);
+    table = (double *)malloc(2 * node_num * sizeof(double));
 
-    // read element_node
-    for (i = 0; i < element_num * element_order; i = i + element_order)
+    text_read_table("./mesh/element_node.txt", element_order, element_num, element_node, NULL);
+    text_read_table("./mesh/node_xy.txt", 2, node_num, NULL, table);
+    #pragma omp parallel for
+    for (i = 0; i < node_num; i++)
     {
-      for (j = 0; j < element_order; j++)
-      {
-        fscanf(fp_element_node, "%d ", &element_node[i + j]);
-      }
-      fscanf(fp_element_node, "\n");
+      node_xy[0][i] = table[2 * i];
+      node_xy[1][i] = table[2 * i + 1];
     }
-    // read node_xy
-    for (i = 0; i < node_num; i++)
+    free(table);
+  }
+  else if (use_exterior_mesh == 2)
+  {
+    // use exterior binary mesh and model, mapped in place
+    node_xy = (double **)malloc(2 * sizeof(double));
+    c = (double **)malloc(4 * sizeof(double));
+    mesh_map = mesh_binary_read("./mesh/mesh.bin", type_code, &node_num, &element_num, &mesh_map_size, &element_node, node_xy,
+                                &xmin, &xmax, &ymin, &ymax, &rho, &vp, &vs, c);
+  }
+  else if (use_exterior_mesh == 3)
+  {
+    // use a Gmsh 4.1 mesh, the element type is the one of the file
+    node_xy = (double **)malloc(2 * sizeof(double));
+    i = gmsh_read("./mesh/mesh.msh", &node_num, &element_num, &element_node, node_xy,
+                  &boundary_edge_num, &boundary_edge_node, &boundary_edge_physical, &physical_num, &physical_tag, &physical_name);
+    if (i != type_code)
     {
-      fscanf(fp_node_xy, "%lf %lf\n", &x_temp, &y_temp);
-      node_xy[0][i] = x_temp;
-      node_xy[1][i] = y_temp;
+      printf("\n mesh.msh holds type_code = %d, it replaces type_code = %d of par.txt\n", i, type_code);
+      type_code = i;
+      free(type);
+      type = element_type(type_code);
+      element_order = mesh_element_order(type);
     }
-    fclose(fp_element_node);
-    fclose(fp_node_xy);
-    xmin = 0;
-    ymin = 0;
-    xmax = 0;
-    ymax = 0;
-    for (i = 0; i < node_num; i++)
+    for (i = 0; i < physical_num; i++)
+    {
+      k = 0;
+      for (j = 0; j < boundary_edge_num; j++)
+        k = k + (boundary_edge_physical[j] == physical_tag[i]);
+      if (k > 0)
+        printf("\n boundary %-10s is %d edges\n", physical_name[i], k);
+    }
+  }
+  else
+  {
+    // use internal mesh
+    xmin = 0.0;
+    ymin = 0.0;
+    xmax = edge_size * nelemx;
+    ymax = edge_size * nelemy;
+    node_num = mesh_node_num(type, nelemx, nelemy);
+    element_num = mesh_element_num(type, nelemx, nelemy);
+
+    element_node = (int *)malloc(element_order * element_num * sizeof(int));
+    node_xy = (double **)malloc(2 * sizeof(double));
+    for (i = 0; i < 2; i++)
+      node_xy[i] = malloc(sizeof(double) * node_num);
+
+    mesh_element(type, nelemx, nelemy, element_node);
+    mesh_xy(type, nelemx, nelemy, node_num, xmin, xmax, ymin, ymax, node_xy);
+  }
+
+  if (use_exterior_mesh == 1 || use_exterior_mesh == 3)
+  {
+    // the box of the nodes, which need not hold the origin
+    xmin = node_xy[0][0];
+    ymin = node_xy[1][0];
+    xmax = node_xy[0][0];
+    ymax = node_xy[1][0];
+    for (i = 1; i < node_num; i++)
     {
       if (node_xy[0][i] < xmin)
       {
@@ -213,23 +599,22 @@ int main()
       }
     }
   }
-  else
+  if (mesh_swap_xy == 1)
   {
-    // use internal mesh and save the mesh scheme
-    xmin = 0.0;
-    ymin = 0.0;
-    xmax = edge_size * nelemx;
-    ymax = edge_size * nelemy;
-    node_num = mesh_node_num(type, nelemx, nelemy);
-    element_num = mesh_element_num(type, nelemx, nelemy);
-
-    element_node = (int *)malloc(element_order * element_num * sizeof(int));
-    node_xy = (double **)malloc(2 * sizeof(double));
-    for (i = 0; i < 2; i++)
-      node_xy[i] = malloc(sizeof(double) * node_num);
-
-    mesh_element(type, nelemx, nelemy, element_node);
-    mesh_xy(type, nelemx, nelemy, node_num, xmin, xmax, ymin, ymax, node_xy);
+    // x <-> y, e.g. to put a free surface given on ymax on xmax
+    swap_temp = node_xy[0];
+    node_xy[0] = node_xy[1];
+    node_xy[1] = swap_temp;
+    x_swap = xmin;
+    xmin = ymin;
+    ymin = x_swap;
+    x_swap = xmax;
+    xmax = ymax;
+    ymax = x_swap;
+  }
+  if ((use_exterior_mesh == 0 || use_exterior_mesh == 3) && mesh_output == 1)
+  {
+    // save the mesh scheme for the plots
     fp_element_node = fopen("./mesh/element_node.txt", "w");
     fp_node_xy = fopen("./mesh/node_xy.txt", "w");
     for (i = 0; i < element_num * element_order; i = i + element_order)
@@ -263,36 +648,643 @@ int main()
   printf("\n xmax   is           %-f m\n", xmax);
   printf("\n ymax   is           %-f m\n", ymax);
 
-  rec_node = (int *)malloc(rec_num * sizeof(int));
+  // every source and receiver keeps the element_order nodes of its element and their weights
+  rec_node = (int *)malloc(rec_num * element_order * sizeof(int));
+  rec_weight = (double *)malloc(rec_num * element_order * sizeof(double));
   rec_x = (double *)malloc(rec_num * sizeof(double));
   rec_y = (double *)malloc(rec_num * sizeof(double));
-  src_node = (int *)malloc(src_num * sizeof(int));
+  src_node = (int *)malloc(src_num * element_order * sizeof(int));
+  src_weight = (double *)malloc(src_num * element_order * sizeof(double));
   src_x = (double *)malloc(src_num * sizeof(double));
   src_y = (double *)malloc(src_num * sizeof(double));
 
   set_rec_and_src(rec_num, rec_x_first, rec_y_first, rec_x_last, rec_y_last, rec_x, rec_y, src_num, src_x_first, src_y_first, src_x_last, src_y_last, src_x, src_y);
-  set_receiver_node(rec_num, node_num, edge_size, rec_x, rec_y, node_xy, rec_node);
-  set_source_node(src_num, node_num, edge_size, src_x, src_y, node_xy, src_node);
+  grid_e = element_grid(element_num, element_order, element_node, node_xy, grid_box, grid_n, &grid_p);
+  set_receiver_node(rec_num, rec_x, rec_y, type, element_order, element_node, node_xy, grid_box, grid_n, grid_p, grid_e, point_interpolation, rec_node, rec_weight);
+  set_source_node(src_num, src_x, src_y, type, element_order, element_node, node_xy, grid_box, grid_n, grid_p, grid_e, point_interpolation, src_node, src_weight);
+  free(grid_p);
+  free(grid_e);
 
-  elastic_wave(type, node_num, element_num, element_order, element_node, node_xy, nnz, csr_p_size, step, dt, f0, t0, edge_size,
-               xmin, xmax, ymin, ymax, pml_nx, pml_ny, src_num, src_node, rec_num, rec_node, solver, use_exterior_mesh, free_surface_code);
+  /***************************************
+       model density and velocity
+  ****************************************/
+  if (mesh_map != NULL)
+  {
+    // rho, vp, vs, c11, c13, c33, c44 come with the binary mesh, the private mapping can be
+    // written over by a gridded model
+    if (model_grid_type != 0)
+      model_grid(model_grid_type, node_num, node_xy, model_grid_nx, model_grid_ny, model_grid_x0, model_grid_y0, model_grid_dx, model_grid_dy,
+                 rho, vp, vs, c);
+  }
+  else if (model_grid_type == 0 && (use_exterior_mesh == 1 || (use_exterior_mesh == 3 && access("./mesh/velocity_and_density.txt", R_OK) == 0)))
+  {
+    rho = (double *)malloc(node_num * sizeof(double));
+    vp = (double *)malloc(node_num * sizeof(double));
+    vs = (double *)malloc(node_num * sizeof(double));
+    c = (double **)malloc(4 * sizeof(double));
+    for (i = 0; i < 4; i++)
+      c[i] = malloc(node_num * sizeof(double));
+    table = (double *)malloc(7 * node_num * sizeof(double));
+    text_read_table("./mesh/velocity_and_density.txt", 7, node_num, NULL, table);
+    #pragma omp parallel for
+    for (i = 0; i < node_num; i++)
+    {
+      rho[i] = table[7 * i];
+      vp[i] = table[7 * i + 1];
+      vs[i] = table[7 * i + 2];
+      c[0][i] = table[7 * i + 3];
+      c[1][i] = table[7 * i + 4];
+      c[2][i] = table[7 * i + 5];
+      c[3][i] = table[7 * i + 6];
+    }
+    free(table);
+  }
+  else
+  {
+    rho = (double *)malloc(node_num * sizeof(double));
+    vp = (double *)malloc(node_num * sizeof(double));
+    vs = (double *)malloc(node_num * sizeof(double));
+    c = (double **)malloc(4 * sizeof(double));
+    for (i = 0; i < 4; i++)
+      c[i] = malloc(node_num * sizeof(double));
+    if (model_grid_type != 0)
+      model_grid(model_grid_type, node_num, node_xy, model_grid_nx, model_grid_ny, model_grid_x0, model_grid_y0, model_grid_dx, model_grid_dy,
+                 rho, vp, vs, c);
+    else
+      model_elastic_parameter(node_num, element_num, element_order, element_node, node_xy, rho, vp, vs, c);
+    // an exterior mesh keeps its own model file
+    if (mesh_output == 1 && (model_grid_type == 0 || use_exterior_mesh == 0))
+    {
+      if ((fp_model_par = fopen("./mesh/velocity_and_density.txt", "w")) == NULL)
+        printf("\n velocity_and_density.txt file cannot open\n");
+      for (i = 0; i < node_num; i++)
+      {
+        fprintf(fp_model_par, "%f	%f	%f	%f	%f	%f	%f\n", rho[i], vp[i], vs[i], c[0][i], c[1][i], c[2][i], c[3][i]);
+      }
+      fclose(fp_model_par);
+    }
+  }
+  if (model_grid_type != 0)
+    printf("\n model is            grid of %d x %d (%s), dx = %f, dy = %f m\n", model_grid_nx, model_grid_ny,
+           (model_grid_type == 1) ? "rho, vp, vs" : "rho, c11, c13, c33, c44", model_grid_dx, model_grid_dy);
+  if (mesh_output == 2 && mesh_map == NULL)
+    mesh_binary_write("./mesh/mesh.bin", type_code, node_num, element_num, element_order, element_node, node_xy, xmin, xmax, ymin, ymax, rho, vp, vs, c);
+
+  /***************************************
+     node renumbering: after the mesh, model,
+     sources and receivers are set in the
+     order of the mesh files
+  ****************************************/
+  if (element_renumber == 1)
+  {
+    // elements first, the centroids do not depend on the node numbers
+    element_old = (int *)malloc(element_num * sizeof(int));
+    mesh_element_sort(element_num, element_order, element_node, node_xy, element_old);
+    free(element_old);
+    printf("\n element sorting is  hilbert\n");
+  }
+  node_old = (int *)malloc(node_num * sizeof(int));
+  node_new = (int *)malloc(node_num * sizeof(int));
+  if (node_renumber >= 1 && node_renumber <= 3)
+  {
+    bandwidth = mesh_bandwidth(element_order, element_num, element_node);
+    if (node_renumber == 1)
+    {
+      csr_p = (int *)malloc(csr_p_size * sizeof(int));
+      csr_j = csr_pattern(node_num, element_num, element_order, element_node, csr_p, &csr_size);
+      mesh_rcm(node_num, csr_p, csr_j, node_old);
+      free(csr_p);
+      free(csr_j);
+      csr_p = NULL;
+      csr_j = NULL;
+    }
+    else if (node_renumber == 2)
+    {
+      hilbert_order(node_num, node_xy[0], node_xy[1], node_old);
+    }
+    else
+    {
+      mesh_first_touch(node_num, element_num, element_order, element_node, node_old);
+    }
+    mesh_renumber(node_num, element_num, element_order, element_node, node_xy, rho, vp, vs, c,
+                  src_num * element_order, src_node, rec_num * element_order, rec_node, node_old, node_new);
+    for (i = 0; i < 2 * boundary_edge_num; i++)
+      boundary_edge_node[i] = node_new[boundary_edge_node[i] - 1] + 1;
+    printf("\n node renumbering is %s\n", (node_renumber == 1) ? "rcm" : (node_renumber == 2) ? "hilbert" : "first touch");
+    printf("\n bandwidth is        %d -> %d\n", bandwidth, mesh_bandwidth(element_order, element_num, element_node));
+  }
+  else
+  {
+    for (i = 0; i < node_num; i++)
+    {
+      node_old[i] = i;
+      node_new[i] = i;
+    }
+  }
+  // cache-sized element blocks, for the element kernels that sweep the mesh by blocks
+  element_block_p = (int *)malloc((element_num + 1) * sizeof(int));
+  element_block_num = mesh_element_block(node_num, element_num, element_order, element_node, element_block_node, element_block_p);
+  printf("\n element blocks is   %d (at most %d nodes)\n", element_block_num, element_block_node);
+
+  /***************************************
+     boundary edges: absorbing, free surface
+     or fixed by the side of the box, or by
+     the physical groups of a Gmsh mesh
+  ****************************************/
+  for (i = 0; i < 5; i++)
+  {
+    if (boundary_side[i] < 1 || boundary_side[i] > 3)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "SEISFEM - Fatal error!\n");
+      fprintf(stderr, "  boundary rule %d of side %d is not 1, 2 or 3.\n", boundary_side[i], i);
+      exit(1);
+    }
+  }
+  // the mpml of abc_mpml is on the absorbing sides of the box
+  use_mpml_xmin = (boundary_side[0] == 1);
+  use_mpml_xmax = (boundary_side[1] == 1);
+  use_mpml_ymin = (boundary_side[2] == 1);
+  use_mpml_ymax = (boundary_side[3] == 1);
+  edge_num = mesh_boundary_edge(type, element_num, element_order, element_node, &edge_node, &edge_element);
+  edge_tag = (int *)malloc(edge_num * sizeof(int));
+  mesh_boundary_tag(edge_num, edge_node, node_xy, edge_size, xmin, xmax, ymin, ymax, boundary_side, edge_tag);
+  if (use_exterior_mesh == 3)
+  {
+    k = mesh_boundary_physical(edge_num, edge_node, edge_tag, boundary_edge_num, boundary_edge_node, boundary_edge_physical,
+                               physical_num, physical_tag, physical_name);
+    printf("\n boundary groups     tag %d of %d boundary edges\n", k, edge_num);
+  }
+  k = 0;
+  j = 0;
+  for (i = 0; i < edge_num; i++)
+  {
+    k = k + (edge_tag[i] == 1);
+    j = j + (edge_tag[i] == 2);
+  }
+  printf("\n boundary edges is   %d: %d absorbing, %d free surface, %d fixed\n", edge_num, k, j, edge_num - k - j);
+
+  /***************************************
+     operator cache: reuse the operator, the
+     mass and the mpml profiles of a former
+     run with the same mesh, model and mpml
+  ****************************************/
+  if (operator_cache == 1)
+  {
+    operator_key = operator_hash(type, node_num, element_num, element_order, element_node, node_xy, rho, vp, vs, c, pml_nx, pml_ny, edge_size,
+                                 edge_num, edge_tag, pml_profile);
+    sprintf(filename_operator_cache, "./mesh/operator_cache_%016llx.bin", operator_key);
+    operator_map = operator_cache_read(filename_operator_cache, operator_key, node_num, &csr_size, &operator_map_size, &csr_p, &csr_j,
+                                       &mass_unit_x, &mass_csr_x, stif_csr_x, &mass_lump,
+                                       &mpml_dx, &mpml_dy, &mpml_dxx, &mpml_dyy, &mpml_dxx_pyx, &mpml_dyy_pxy);
+    if (operator_map != NULL)
+      printf("\n operator cache is   %s\n", filename_operator_cache);
+  }
+
+  if (operator_map == NULL)
+  {
+    /***************************************
+        operator, built once for the mesh
+    ****************************************/
+    elastic_operator(type, node_num, element_num, element_order, element_node, node_xy, nnz, csr_p_size,
+                     &csr_size, &csr_p, &csr_j, &scatter_map, &mass_unit_x, stif_csr_x);
+
+    /***************************************
+       mpml profiles, kept for model updates
+    ****************************************/
+    vp_max = vp[0];
+    for (i = 0; i < node_num; i++)
+    {
+      if (vp[i] > vp_max)
+        vp_max = vp[i];
+    }
+    mpml_dx = (double *)malloc(node_num * sizeof(double));
+    mpml_dy = (double *)malloc(node_num * sizeof(double));
+    mpml_dxx = (double *)malloc(node_num * sizeof(double));
+    mpml_dyy = (double *)malloc(node_num * sizeof(double));
+    mpml_dxx_pyx = (double *)malloc(node_num * sizeof(double));
+    mpml_dyy_pxy = (double *)malloc(node_num * sizeof(double));
+    if (pml_profile == 1)
+    {
+      // from the boundary of the connectivity, any mesh shape
+      abc_mpml_distance(node_num, element_order, element_node, node_xy, csr_p, csr_j, edge_num, edge_node, edge_element, edge_tag,
+                        pml_nx, pml_ny, edge_size, vp_max, mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy);
+      k = 0;
+      for (i = 0; i < edge_num; i++)
+        k = k + (edge_tag[i] == 1);
+      printf("\n pml profile is      distance to %d absorbing of %d boundary edges\n", k, edge_num);
+    }
+    else
+      abc_mpml(node_num, element_num, element_order, element_node, node_xy, pml_nx, pml_ny, edge_size, xmin, xmax, ymin, ymax, vp_max,
+               use_mpml_xmin, use_mpml_xmax, use_mpml_ymin, use_mpml_ymax, mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy);
+
+    /***************************************
+      numeric part, refreshed for every model
+    ****************************************/
+    mass_csr_x = (double *)malloc(csr_size * sizeof(double));
+    mass_lump = (double *)malloc(node_num * sizeof(double));
+    mass_sparse_update(node_num, csr_p, csr_j, mass_unit_x, rho, mass_csr_x, mass_lump);
+
+    if (operator_cache == 1)
+      operator_cache_write(filename_operator_cache, operator_key, node_num, csr_size, csr_p, csr_j, mass_unit_x, mass_csr_x, stif_csr_x, mass_lump,
+                           mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy);
+  }
+  printf("\n csr size is         %d\n", csr_size);
+
+  /***************************************
+     c-pml coefficients of the elastic wave
+  ****************************************/
+  if (pml_type != 0 && pml_type != 1)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  pml_type %d is not 0 (mpml) or 1 (c-pml).\n", pml_type);
+    exit(1);
+  }
+  if (pml_type == 1 && (wave_type != 0 || aperture == 1))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  pml_type = 1 (c-pml) is for the elastic wave on the full model only, not with wave_type = %d, aperture = %d.\n",
+            wave_type, aperture);
+    exit(1);
+  }
+  if (pml_type == 1)
+  {
+    cpml_ax = (double *)malloc(node_num * sizeof(double));
+    cpml_bx = (double *)malloc(node_num * sizeof(double));
+    cpml_ay = (double *)malloc(node_num * sizeof(double));
+    cpml_by = (double *)malloc(node_num * sizeof(double));
+    abc_cpml(node_num, mpml_dx, mpml_dy, f0, dt, cpml_ax, cpml_bx, cpml_ay, cpml_by);
+  }
+
+  /***************************************
+     viscoelastic model: Q at every node and
+     the memory variable coefficients
+  ****************************************/
+  if (attenuation == 1 && (wave_type != 0 || pml_type == 1 || aperture == 1))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  attenuation is for the elastic wave with mpml on the full model only, not with wave_type = %d, pml_type = %d, aperture = %d.\n",
+            wave_type, pml_type, aperture);
+    exit(1);
+  }
+  if (attenuation == 1)
+  {
+    if (sls_num < 1 || q_p <= 0.0 || q_s <= 0.0)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "SEISFEM - Fatal error!\n");
+      fprintf(stderr, "  attenuation needs sls_num >= 1, q_p > 0 and q_s > 0.\n");
+      exit(1);
+    }
+    q_p_node = (double *)malloc(node_num * sizeof(double));
+    q_s_node = (double *)malloc(node_num * sizeof(double));
+    for (i = 0; i < node_num; i++)
+    {
+      q_p_node[i] = q_p;
+      q_s_node[i] = q_s;
+    }
+    // Q from the grid of the model, when it comes with one
+    if (model_grid_type != 0 && access("./mesh/model_qp.bin", R_OK) == 0 && access("./mesh/model_qs.bin", R_OK) == 0)
+    {
+      q_grid = model_grid_map("./mesh/model_qp.bin", model_grid_nx, model_grid_ny);
+      model_grid_sample(node_num, node_xy, model_grid_nx, model_grid_ny, model_grid_x0, model_grid_y0, model_grid_dx, model_grid_dy, q_grid, q_p_node);
+      munmap(q_grid, (size_t)model_grid_nx * model_grid_ny * sizeof(float));
+      q_grid = model_grid_map("./mesh/model_qs.bin", model_grid_nx, model_grid_ny);
+      model_grid_sample(node_num, node_xy, model_grid_nx, model_grid_ny, model_grid_x0, model_grid_y0, model_grid_dx, model_grid_dy, q_grid, q_s_node);
+      munmap(q_grid, (size_t)model_grid_nx * model_grid_ny * sizeof(float));
+      printf("\n attenuation Q is    from model_qp.bin and model_qs.bin\n");
+      for (i = 0; i < node_num; i++)
+      {
+        if (!(q_p_node[i] > 0.0) || !(q_s_node[i] > 0.0))
+        {
+          fprintf(stderr, "\n");
+          fprintf(stderr, "SEISFEM - Fatal error!\n");
+          fprintf(stderr, "  Qp = %f, Qs = %f of model_qp.bin and model_qs.bin at node %d, Q must be > 0.\n", q_p_node[i], q_s_node[i], i + 1);
+          exit(1);
+        }
+      }
+    }
+    for (i = 0; i < 4; i++)
+      c_u[i] = (double *)malloc(node_num * sizeof(double));
+    for (i = 0; i < 5; i++)
+      visco[i] = (double *)malloc(node_num * sizeof(double));
+    sls_node = (int *)malloc(node_num * sizeof(int));
+    // constant Q over f0 / 10 to 3 f0, the band of the Ricker wavelet, velocities at f0
+    sls_y_max = visco_sls(node_num, csr_p, csr_j, c, q_p_node, q_s_node, sls_num, f0 / 10.0, 3.0 * f0, f0, dt, c_u, visco, sls_node);
+    printf("\n attenuation is      %d coarse-grained sls, Qp = %f, Qs = %f, largest Y %f\n", sls_num, q_p, q_s, sls_y_max);
+    // the stress M_u * (e - Y * z) changes sign for Y >= 1, the wave grows
+    if (!(sls_y_max < 1.0))
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "SEISFEM - Fatal error!\n");
+      fprintf(stderr, "  the largest Y of the coarse-grained sls is %f, not below 1: Q is too low.\n", sls_y_max);
+      exit(1);
+    }
+  }
+
+  /***************************************
+     Dirichlet nodes of the time loop: u = w
+     = 0 on the absorbing and fixed edges of
+     the elastic wave, p = 0 on the free
+     surface of the acoustic wave and on the
+     whole boundary of acoustic_pml
+  ****************************************/
+  if (wave_type == 1)
+    dirichlet_mask = (1 << 2);
+  else if (wave_type == 2)
+    dirichlet_mask = (1 << 1) | (1 << 2) | (1 << 3);
+  else
+    dirichlet_mask = (1 << 1) | (1 << 3);
+  dirichlet_node = (int *)malloc(node_num * sizeof(int));
+  if (aperture != 1)
+  {
+    dirichlet_num = mesh_boundary_node(node_num, element_order, element_node, node_xy, edge_num, edge_node, edge_element, edge_tag,
+                                       dirichlet_mask, dirichlet_node);
+    printf("\n dirichlet nodes is  %d\n", dirichlet_num);
+  }
+
+  /***************************************
+     frequencies and nodes of the running
+     Fourier transform, see wavefield_dft
+  ****************************************/
+  if (dft_frequency[0] != '\0' && (wave_type != 0 || aperture == 1))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  dft_frequency is for the elastic wave on the full model only, not with wave_type = %d, aperture = %d.\n",
+            wave_type, aperture);
+    exit(1);
+  }
+  if (dft_frequency[0] != '\0')
+  {
+    // "f1,f2,..." in Hz
+    dft_freq = (double *)malloc(sizeof(dft_frequency) * sizeof(double));
+    dft_next = dft_frequency;
+    while (*dft_next != '\0')
+    {
+      dft_freq[dft_freq_num] = strtod(dft_next, &dft_next);
+      if (dft_freq[dft_freq_num] <= 0.0 || (*dft_next != ',' && *dft_next != '\0'))
+      {
+        fprintf(stderr, "\n");
+        fprintf(stderr, "SEISFEM - Fatal error!\n");
+        fprintf(stderr, "  dft_frequency = %s is not a list f1,f2,... of frequencies > 0.\n", dft_frequency);
+        exit(1);
+      }
+      dft_freq_num++;
+      if (*dft_next == ',')
+        dft_next++;
+    }
+    // "xmin,xmax,ymin,ymax", all the nodes without it
+    dft_xy[0] = xmin;
+    dft_xy[1] = xmax;
+    dft_xy[2] = ymin;
+    dft_xy[3] = ymax;
+    if (dft_box[0] != '\0' && sscanf(dft_box, "%lf,%lf,%lf,%lf", &dft_xy[0], &dft_xy[1], &dft_xy[2], &dft_xy[3]) != 4)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "SEISFEM - Fatal error!\n");
+      fprintf(stderr, "  dft_box = %s is not xmin,xmax,ymin,ymax.\n", dft_box);
+      exit(1);
+    }
+    dft_node = (int *)malloc(node_num * sizeof(int));
+    for (i = 0; i < node_num; i++)
+    {
+      // nodes of the mesh files, in their order
+      k = node_new[i];
+      if (node_xy[0][k] >= dft_xy[0] && node_xy[0][k] <= dft_xy[1] && node_xy[1][k] >= dft_xy[2] && node_xy[1][k] <= dft_xy[3])
+      {
+        dft_node[dft_num] = i;
+        dft_num++;
+      }
+    }
+    printf("\n dft is              %d frequencies on %d nodes\n", dft_freq_num, dft_num);
+  }
+  if (adjoint != 0 && ((adjoint != 1 && adjoint != 2) || wave_type != 0 || pml_type != 1 || aperture == 1 || reciprocity == 1 ||
+                       strcmp(solver, "masslump") != 0))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  adjoint = %d is not 1 or 2, or not on the elastic wave with pml_type = 1 and solver = masslump on the full model\n", adjoint);
+    fprintf(stderr, "  (wave_type = %d, pml_type = %d, aperture = %d, reciprocity = %d, solver = %s).\n", wave_type, pml_type, aperture, reciprocity, solver);
+    exit(1);
+  }
+  if (adjoint != 0 && reverse == 0)
+    reverse = 1;
+  if (reverse != 0 && ((reverse != 1 && reverse != 2) || wave_type != 0 || pml_type != 1 || aperture == 1 || reciprocity == 1))
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  reverse = %d is not 1 or 2, or not on the elastic wave with pml_type = 1 on the full model\n", reverse);
+    fprintf(stderr, "  (wave_type = %d, pml_type = %d, aperture = %d, reciprocity = %d).\n", wave_type, pml_type, aperture, reciprocity);
+    exit(1);
+  }
+  if (reverse == 2 && strcmp(solver, "masslump") != 0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISFEM - Fatal error!\n");
+    fprintf(stderr, "  reverse = 2 is for solver = masslump, not %s; reverse = 1 runs with any solver.\n", solver);
+    exit(1);
+  }
+
+  /***************************************
+     shots: the sources of every simulation,
+     one by one, supershots with encoding or
+     reciprocal shots at the receivers
+  ****************************************/
+  force_x = sin(angle_force * 3.1415926535898 / 180.0);
+  force_y = cos(angle_force * 3.1415926535898 / 180.0);
+  if (reciprocity == 1 && wave_type != 0)
+  {
+    printf("\n reciprocity is for the elastic wave only, the shots are run at the sources\n");
+    reciprocity = 0;
+  }
+  if (reciprocity == 1)
+    supershot = 0;
+  if (supershot <= 1)
+    source_encoding = 0;
+  src_polarity = (double *)malloc(src_num * sizeof(double));
+  src_shift = (double *)malloc(src_num * sizeof(double));
+  wavelet = (double *)malloc((size_t)src_num * step * sizeof(double));
+  source_wavelet(src_num, step, dt, f0, t0, source_type, source_encoding, source_shift_max, source_seed, src_polarity, src_shift, wavelet);
+  if (reciprocity == 1)
+  {
+    // 2 shots per receiver, recorded at the sources
+    shot_p = (int *)malloc((2 * rec_num + 1) * sizeof(int));
+    shot_force = (double *)malloc(4 * rec_num * sizeof(double));
+    inj_node = (int *)malloc(2 * rec_num * element_order * sizeof(int));
+    inj_weight = (double *)malloc(2 * rec_num * element_order * sizeof(double));
+    inj_src = (int *)malloc(2 * rec_num * element_order * sizeof(int));
+    shot_num = reciprocity_shot(rec_num, element_order, rec_node, rec_weight, shot_p, inj_node, inj_weight, inj_src, shot_force);
+    seismogram_all = (double *)calloc((size_t)step * 2 * src_num, sizeof(double));
+    printf("\n reciprocity is      %d receivers, %d shots for %d sources\n", rec_num, shot_num, src_num);
+  }
+  else
+  {
+    shot_p = (int *)malloc((src_num + 1) * sizeof(int));
+    inj_node = (int *)malloc(src_num * element_order * sizeof(int));
+    inj_weight = (double *)malloc(src_num * element_order * sizeof(double));
+    inj_src = (int *)malloc(src_num * element_order * sizeof(int));
+    shot_num = source_injection(src_num, element_order, src_node, src_weight, supershot, shot_p, inj_node, inj_weight, inj_src);
+    shot_force = (double *)malloc(2 * shot_num * sizeof(double));
+    for (i = 0; i < shot_num; i++)
+    {
+      shot_force[2 * i] = force_x;
+      shot_force[2 * i + 1] = force_y;
+    }
+  }
+  if (wave_type == 1 || wave_type == 2)
+    printf("\n wave is             acoustic (c11 = rho vp^2), %s\n", (wave_type == 2) ? "mpml" : "no absorbing boundary");
+  if (source_type == 1)
+    printf("\n source is           band-limited impulse, f0 = %f Hz, t0 = %f s\n", f0, t0);
+  if (supershot > 1)
+    printf("\n supershot is        %d sources, %d shots, encoding %s\n", supershot, shot_num,
+           (source_encoding == 1) ? "polarity" : (source_encoding == 2) ? "shift" : "none");
+
+  if (reciprocity == 1)
+  {
+    // the sources are the receivers of the reciprocal shots
+    if (aperture == 1)
+      elastic_wave_aperture(wave_type, type, node_num, element_num, element_order, element_node, node_xy, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x,
+                            vp, c, pml_nx, pml_ny, boundary_side, dirichlet_mask,
+                            step, dt, f0, t0, edge_size, xmin, xmax, ymin, ymax, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "reciprocal",
+                            src_num, src_node, src_weight, element_order, seismogram_all, node_new, solver);
+    else if (pml_type == 1)
+      elastic_wave_cpml(node_num, node_xy, csr_p_size, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, cpml_ax, cpml_bx, cpml_ay, cpml_by,
+                        step, dt, 0, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "reciprocal",
+                        src_num, src_node, src_weight, element_order, seismogram_all, node_new, solver, dirichlet_num, dirichlet_node,
+                        dft_freq_num, dft_freq, dft_num, dft_node);
+    else
+      elastic_wave(node_num, node_xy, csr_p_size, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x,
+                   (attenuation == 1) ? c_u : c, mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy,
+                   step, dt, f0, t0, 0, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "reciprocal",
+                   src_num, src_node, src_weight, element_order, seismogram_all, node_new, solver, dirichlet_num, dirichlet_node,
+                   (attenuation == 1) ? visco : NULL, dft_freq_num, dft_freq, dft_num, dft_node);
+    reciprocity_gather(src_num, rec_num, step, force_x, force_y);
+  }
+  else
+  {
+    if (aperture == 1)
+      elastic_wave_aperture(wave_type, type, node_num, element_num, element_order, element_node, node_xy, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x,
+                            vp, c, pml_nx, pml_ny, boundary_side, dirichlet_mask,
+                            step, dt, f0, t0, edge_size, xmin, xmax, ymin, ymax, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "shot",
+                            rec_num, rec_node, rec_weight, element_order, NULL, node_new, solver);
+    else if (wave_type == 1)
+      acoustic(node_num, node_xy, csr_p_size, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c,
+               step, dt, 0, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, "shot",
+               rec_num, rec_node, rec_weight, element_order, node_new, solver, dirichlet_num, dirichlet_node);
+    else if (wave_type == 2)
+      acoustic_pml(node_num, node_xy, csr_p_size, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, mpml_dx, mpml_dy, mpml_dxx, mpml_dyy,
+                   step, dt, 0, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, "shot",
+                   rec_num, rec_node, rec_weight, element_order, node_new, solver, dirichlet_num, dirichlet_node);
+    else if (reverse != 0)
+      elastic_wave_reverse(node_num, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, cpml_ax, cpml_bx, cpml_ay, cpml_by,
+                           step, dt, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "shot",
+                           rec_num, rec_node, rec_weight, element_order, node_new, solver, dirichlet_num, dirichlet_node, reverse, checkpoint_memory, checkpoint_disk,
+                           adjoint, observed, rho);
+    else if (pml_type == 1)
+      elastic_wave_cpml(node_num, node_xy, csr_p_size, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, cpml_ax, cpml_bx, cpml_ay, cpml_by,
+                        step, dt, 0, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "shot",
+                        rec_num, rec_node, rec_weight, element_order, NULL, node_new, solver, dirichlet_num, dirichlet_node,
+                        dft_freq_num, dft_freq, dft_num, dft_node);
+    else
+      elastic_wave(node_num, node_xy, csr_p_size, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x,
+                   (attenuation == 1) ? c_u : c, mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy,
+                   step, dt, f0, t0, 0, shot_num, shot_p, inj_node, inj_weight, inj_src, wavelet, shot_force, "shot",
+                   rec_num, rec_node, rec_weight, element_order, NULL, node_new, solver, dirichlet_num, dirichlet_node,
+                   (attenuation == 1) ? visco : NULL, dft_freq_num, dft_freq, dft_num, dft_node);
+  }
 
   /***************************************
               free memory
   ****************************************/
-  fclose(fp_element_node);
-  fclose(fp_node_xy);
   free(type);
   free(solver);
-  for (i = 0; i < 2; i++)
-    free(node_xy[i]);
+  if (mesh_map != NULL)
+  {
+    // element_node, node_xy, rho, vp, vs and c point into the binary mesh mapping
+    munmap(mesh_map, mesh_map_size);
+  }
+  else
+  {
+    free(element_node);
+    for (i = 0; i < 2; i++)
+      free(node_xy[i]);
+    free(rho);
+    free(vp);
+    free(vs);
+    for (i = 0; i < 4; i++)
+      free(c[i]);
+  }
   free(node_xy);
   free(rec_node);
+  free(rec_weight);
   free(rec_x);
   free(rec_y);
   free(src_node);
+  free(src_weight);
+  free(src_polarity);
+  free(src_shift);
+  free(wavelet);
+  free(shot_p);
+  free(inj_node);
+  free(inj_weight);
+  free(inj_src);
+  free(shot_force);
+  free(seismogram_all);
   free(src_x);
   free(src_y);
+  free(node_old);
+  free(node_new);
+  free(element_block_p);
+  free(boundary_edge_node);
+  free(boundary_edge_physical);
+  free(edge_node);
+  free(edge_element);
+  free(edge_tag);
+  free(dirichlet_node);
+  free(q_p_node);
+  free(q_s_node);
+  for (i = 0; i < 4; i++)
+    free(c_u[i]);
+  for (i = 0; i < 5; i++)
+    free(visco[i]);
+  free(sls_node);
+  free(dft_freq);
+  free(dft_node);
+  for (i = 0; i < physical_num; i++)
+    free(physical_name[i]);
+  free(physical_name);
+  free(physical_tag);
+  free(c);
+  free(cpml_ax);
+  free(cpml_bx);
+  free(cpml_ay);
+  free(cpml_by);
+  if (operator_map != NULL)
+  {
+    // the operator arrays point into the cache mapping
+    munmap(operator_map, operator_map_size);
+  }
+  else
+  {
+    free(csr_p);
+    free(csr_j);
+    free(scatter_map);
+    free(mass_unit_x);
+    free(mass_csr_x);
+    free(mass_lump);
+    for (i = 0; i < 6; i++)
+      free(stif_csr_x[i]);
+    free(mpml_dx);
+    free(mpml_dy);
+    free(mpml_dxx);
+    free(mpml_dyy);
+    free(mpml_dxx_pyx);
+    free(mpml_dyy_pxy);
+  }
   program_run_time = omp_get_wtime() - program_start_time;
   printf("\n Total run time is: %f\n", program_run_time);
   printf("\n Example Normal End!\n");
@@ -0,0 +1,196 @@
+int quadrature_rule(char *type, int degree, double rtab[], double stab[], double weight[])
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    QUADRATURE_RULE returns the cheapest quadrature rule on the reference element
+    that integrates a polynomial of the given degree exactly, and the number of points.
+
+    The weights sum to 1, so the element integral is area * sum(weight * f).
+
+  Triangles (T3, T6, T10), DEGREE is the total degree of the integrand:
+
+    DEGREE   QUAD_NUM   Rule
+    ------   --------   ----
+    0 - 1       1       centroid;
+      2         3       Strang-Fix;
+    3 - 4       6       Dunavant;
+      5         7       Dunavant;
+      6        12       Dunavant.
+
+  Quadrilaterals (Q4, Q9, Q16), DEGREE is the degree in each of R and S:
+
+    a N x N Gauss-Legendre product rule on [0,1]x[0,1], N = DEGREE / 2 + 1, N <= 6.
+
+  Typical degrees, P = 1, 2, 3 for T3/Q4, T6/Q9, T10/Q16:
+
+    phi     * phi      triangle 2P,   quadrilateral 2P;
+    dphi_dx * dphi_dx  triangle 2P-2, quadrilateral 2P;
+    phi     * dphi_dx  triangle 2P-1, quadrilateral 2P.
+
+  For curved or non-parallelogram quadrilaterals the integrands are rational and the
+  rule is no longer exact, as with any fixed rule.
+
+  Reference Element:
+
+    |                   |
+    1  3                1  4-----3
+    |  |\               |  |     |
+    S  | \              S  |     |
+    |  |  \             |  |     |
+    0  1---2            0  1-----2
+    |                   |
+    +--0--R--1-->       +--0--R--1-->
+*/
+{
+  int i, j, n, quad_num;
+  double a, b, c, d, e, f, g, uu, vv, ww;
+  double x[6], w[6];
+
+  if (type[0] == 'T')
+  {
+    if (degree <= 1)
+    {
+      quad_num = 1;
+      rtab[0] = 1.0 / 3.0;
+      stab[0] = 1.0 / 3.0;
+      weight[0] = 1.0;
+    }
+    else if (degree == 2)
+    {
+      quad_num = 3;
+      a = 2.0 / 3.0;
+      b = 1.0 / 6.0;
+      rtab[0] = b;  stab[0] = b;
+      rtab[1] = a;  stab[1] = b;
+      rtab[2] = b;  stab[2] = a;
+      weight[0] = 1.0 / 3.0;
+      weight[1] = 1.0 / 3.0;
+      weight[2] = 1.0 / 3.0;
+    }
+    else if (degree <= 4)
+    {
+      quad_num = 6;
+      a = 0.445948490915965;
+      b = 0.091576213509771;
+      uu = 0.223381589678011;
+      vv = 0.109951743655322;
+      rtab[0] = a;             stab[0] = a;
+      rtab[1] = 1.0 - 2.0 * a; stab[1] = a;
+      rtab[2] = a;             stab[2] = 1.0 - 2.0 * a;
+      rtab[3] = b;             stab[3] = b;
+      rtab[4] = 1.0 - 2.0 * b; stab[4] = b;
+      rtab[5] = b;             stab[5] = 1.0 - 2.0 * b;
+      weight[0] = uu; weight[1] = uu; weight[2] = uu;
+      weight[3] = vv; weight[4] = vv; weight[5] = vv;
+    }
+    else if (degree == 5)
+    {
+      quad_num = 7;
+      a = 0.470142064105115;
+      b = 0.101286507323456;
+      uu = 0.132394152788506;
+      vv = 0.125939180544827;
+      rtab[0] = 1.0 / 3.0;     stab[0] = 1.0 / 3.0;
+      rtab[1] = a;             stab[1] = a;
+      rtab[2] = 1.0 - 2.0 * a; stab[2] = a;
+      rtab[3] = a;             stab[3] = 1.0 - 2.0 * a;
+      rtab[4] = b;             stab[4] = b;
+      rtab[5] = 1.0 - 2.0 * b; stab[5] = b;
+      rtab[6] = b;             stab[6] = 1.0 - 2.0 * b;
+      weight[0] = 0.225;
+      weight[1] = uu; weight[2] = uu; weight[3] = uu;
+      weight[4] = vv; weight[5] = vv; weight[6] = vv;
+    }
+    else if (degree == 6)
+    {
+      quad_num = 12;
+      a = 0.87382197101699600;    b = 0.06308901449150200;    c = 0.50142650965817900;    d = 0.24928674517091000;
+      e = 0.63650249912139900;    f = 0.31035245103378500;    g = 0.05314504984481600;
+      uu = 0.05084490637020700;   vv = 0.11678627572637900;   ww = 0.08285107561837400;
+
+      rtab[0] = a; rtab[1] = b; rtab[2] = b; rtab[3] = c; rtab[4]  = d; rtab[5]  = d;
+      rtab[6] = e; rtab[7] = e; rtab[8] = f; rtab[9] = f; rtab[10] = g; rtab[11] = g;
+
+      stab[0] = b; stab[1] = a; stab[2] = b; stab[3] = d; stab[4]  = c; stab[5]  = d;
+      stab[6] = f; stab[7] = g; stab[8] = e; stab[9] = g; stab[10] = e; stab[11] = f;
+
+      weight[0] = uu; weight[1] = uu; weight[2] = uu; weight[3] = vv; weight[4]  = vv; weight[5]  = vv;
+      weight[6] = ww; weight[7] = ww; weight[8] = ww; weight[9] = ww; weight[10] = ww; weight[11] = ww;
+    }
+    else
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "QUADRATURE_RULE - Fatal error!\n");
+      fprintf(stderr, "  No triangle rule of degree %d.\n", degree);
+      exit(1);
+    }
+  }
+  else if (type[0] == 'Q')
+  {
+    n = degree / 2 + 1;
+    if (n == 1)
+    {
+      x[0] = 0.500000000000000;
+      w[0] = 1.000000000000000;
+    }
+    else if (n == 2)
+    {
+      x[0] = 0.211324865405187; x[1] = 0.788675134594813;
+      w[0] = 0.500000000000000; w[1] = 0.500000000000000;
+    }
+    else if (n == 3)
+    {
+      x[0] = 0.112701665379258; x[1] = 0.500000000000000; x[2] = 0.887298334620742;
+      w[0] = 0.277777777777778; w[1] = 0.444444444444444; w[2] = 0.277777777777778;
+    }
+    else if (n == 4)
+    {
+      x[0] = 0.069431844202974; x[1] = 0.330009478207572; x[2] = 0.669990521792428; x[3] = 0.930568155797026;
+      w[0] = 0.173927422568727; w[1] = 0.326072577431273; w[2] = 0.326072577431273; w[3] = 0.173927422568727;
+    }
+    else if (n == 5)
+    {
+      x[0] = 0.046910077030668; x[1] = 0.230765344947158; x[2] = 0.500000000000000;
+      x[3] = 0.769234655052841; x[4] = 0.953089922969332;
+      w[0] = 0.118463442528095; w[1] = 0.239314335249683; w[2] = 0.284444444444444;
+      w[3] = 0.239314335249683; w[4] = 0.118463442528095;
+    }
+    else if (n == 6)
+    {
+      x[0] = 0.033765242898424; x[1] = 0.169395306766868; x[2] = 0.380690406958402;
+      x[3] = 0.619309593041599; x[4] = 0.830604693233132; x[5] = 0.966234757101576;
+      w[0] = 0.085662246189585; w[1] = 0.180380786524069; w[2] = 0.233956967286346;
+      w[3] = 0.233956967286346; w[4] = 0.180380786524069; w[5] = 0.085662246189585;
+    }
+    else
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "QUADRATURE_RULE - Fatal error!\n");
+      fprintf(stderr, "  No quadrilateral rule of degree %d.\n", degree);
+      exit(1);
+    }
+
+    // r is the outer index and s the inner one, as in the original 36 points tables.
+    quad_num = n * n;
+    for (i = 0; i < n; i++)
+    {
+      for (j = 0; j < n; j++)
+      {
+        rtab[i * n + j] = x[i];
+        stab[i * n + j] = x[j];
+        weight[i * n + j] = w[i] * w[j];
+      }
+    }
+  }
+  else
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "QUADRATURE_RULE - Fatal error!\n");
+    fprintf(stderr, "  Illegal value of type = \"%s\".\n", type);
+    exit(1);
+  }
+
+  return quad_num;
+}
@@ -0,0 +1,63 @@
+void shape_table(char *type, int element_order, int quad_num, double rtab[], double stab[], double phi_tab[], double dwdr_tab[], double dwds_tab[])
+
+/******************************************************************************/
+/*
+  Purpose:
+
+    SHAPE_TABLE tabulates the reference shape functions and their R, S derivatives
+    at the quadrature points, once per element type, so that the element loops
+    only apply the geometric mapping.
+
+    The values of basis function I at quadrature point QUAD are stored in
+    phi_tab[quad * element_order + i], and the same for dwdr_tab and dwds_tab.
+
+  List:
+
+    I  ELEMENT_TYPE   Definition
+    -  ------------   ----------
+    1  T3             3 node linear triangle;
+    2  T6             6 node quadratic triangle;
+    3  T10            10 node cubic triangle.
+    4  Q4             4 node linear Lagrange/serendipity quadrilateral;
+    5  Q9             9 node quadratic Lagrange quadrilateral;
+    6  Q16            16 node cubic Lagrange quadrilateral;
+
+*/
+{
+  int quad;
+
+  for (quad = 0; quad < quad_num; quad++)
+  {
+    if (strcmp(type, "T3") == 0)
+    {
+      shape_t3(rtab[quad], stab[quad], phi_tab + quad * element_order, dwdr_tab + quad * element_order, dwds_tab + quad * element_order);
+    }
+    else if (strcmp(type, "T6") == 0)
+    {
+      shape_t6(rtab[quad], stab[quad], phi_tab + quad * element_order, dwdr_tab + quad * element_order, dwds_tab + quad * element_order);
+    }
+    else if (strcmp(type, "T10") == 0)
+    {
+      shape_t10(rtab[quad], stab[quad], phi_tab + quad * element_order, dwdr_tab + quad * element_order, dwds_tab + quad * element_order);
+    }
+    else if (strcmp(type, "Q4") == 0)
+    {
+      shape_q4(rtab[quad], stab[quad], phi_tab + quad * element_order, dwdr_tab + quad * element_order, dwds_tab + quad * element_order);
+    }
+    else if (strcmp(type, "Q9") == 0)
+    {
+      shape_q9(rtab[quad], stab[quad], phi_tab + quad * element_order, dwdr_tab + quad * element_order, dwds_tab + quad * element_order);
+    }
+    else if (strcmp(type, "Q16") == 0)
+    {
+      shape_q16(rtab[quad], stab[quad], phi_tab + quad * element_order, dwdr_tab + quad * element_order, dwds_tab + quad * element_order);
+    }
+    else
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "SHAPE_TABLE - Fatal error!\n");
+      fprintf(stderr, "  Illegal value of type = \"%s\".\n", type);
+      exit(1);
+    }
+  }
+}
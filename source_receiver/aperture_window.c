@@ -0,0 +1,60 @@
+void aperture_window(double **node_xy, int shot, int *shot_p, int *inj_node, double *inj_weight,
+                     int rec_num, int *rec_node, double *rec_weight, int point_order,
+                     double radius, double margin, double xmin, double xmax, double ymin, double ymax, double *window)
+/******************************************************************************/
+/*
+  Purpose:
+
+    aperture_window gives the part of the model a shot can see in the recording time:
+    radius = vp_max * step * dt is the longest path of a wave. A point at more than radius / 2
+    from the box of the sources and receivers of the shot is at more than radius from the
+    sources to a receiver, and a point at more than radius from the sources is never reached,
+    so the window is
+
+      (box of sources and receivers + radius / 2) and (box of sources + radius),
+
+    plus margin on every side for the mpml of the sub-domain, clipped to the model.
+    The sources are the injection nodes of the shot (see source_injection), the receivers
+    the nodes of rec_node with a weight (see set_point_node).
+
+  Output:
+    window : xmin, xmax, ymin, ymax of the window
+*/
+{
+  int k;
+  double src_box[4], all_box[4];
+
+  src_box[0] = xmax;
+  src_box[1] = xmin;
+  src_box[2] = ymax;
+  src_box[3] = ymin;
+  for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+  {
+    if (inj_weight[k] == 0.0)
+      continue;
+    src_box[0] = fmin(src_box[0], node_xy[0][inj_node[k]]);
+    src_box[1] = fmax(src_box[1], node_xy[0][inj_node[k]]);
+    src_box[2] = fmin(src_box[2], node_xy[1][inj_node[k]]);
+    src_box[3] = fmax(src_box[3], node_xy[1][inj_node[k]]);
+  }
+  for (k = 0; k < 4; k++)
+    all_box[k] = src_box[k];
+  for (k = 0; k < rec_num * point_order; k++)
+  {
+    if (rec_weight[k] == 0.0)
+      continue;
+    all_box[0] = fmin(all_box[0], node_xy[0][rec_node[k]]);
+    all_box[1] = fmax(all_box[1], node_xy[0][rec_node[k]]);
+    all_box[2] = fmin(all_box[2], node_xy[1][rec_node[k]]);
+    all_box[3] = fmax(all_box[3], node_xy[1][rec_node[k]]);
+  }
+
+  window[0] = fmax(all_box[0] - 0.5 * radius, src_box[0] - radius) - margin;
+  window[1] = fmin(all_box[1] + 0.5 * radius, src_box[1] + radius) + margin;
+  window[2] = fmax(all_box[2] - 0.5 * radius, src_box[2] - radius) - margin;
+  window[3] = fmin(all_box[3] + 0.5 * radius, src_box[3] + radius) + margin;
+  window[0] = fmax(window[0], xmin);
+  window[1] = fmin(window[1], xmax);
+  window[2] = fmax(window[2], ymin);
+  window[3] = fmin(window[3], ymax);
+}
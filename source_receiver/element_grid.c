@@ -0,0 +1,114 @@
+int *element_grid(int element_num, int element_order, int *element_node, double **node_xy, double *grid_box, int *grid_n, int **grid_p)
+/******************************************************************************/
+/*
+  Purpose:
+
+    element_grid builds a uniform grid over the mesh for element_locate: every cell lists
+    the elements whose bounding box overlaps it. The cell size is chosen so that there is
+    about one element per cell, then a point is tested against a few elements only,
+    instead of a scan over all nodes or elements.
+
+  Output:
+    grid_box : x and y of the lower left corner, cell width and cell height
+    grid_n   : number of cells in x and y
+    grid_p   : cell pointers, cell (cx, cy) = cy * grid_n[0] + cx holds the elements
+               grid_e[grid_p[cell]] to grid_e[grid_p[cell + 1] - 1]
+    return   : grid_e, element indices from 0
+*/
+{
+  int i, element, node, cell, cx, cy;
+  int cx_min, cx_max, cy_min, cy_max;
+  int cell_num;
+  int *grid_e = NULL;
+  int *fill = NULL;
+  double x_min, x_max, y_min, y_max, cell_size;
+  double *box = NULL;
+
+  // bounding box of every element: x_min, x_max, y_min, y_max
+  box = (double *)malloc(4 * element_num * sizeof(double));
+  if (box == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "ELEMENT_GRID - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for element_num = %d.\n", element_num);
+    exit(1);
+  }
+  #pragma omp parallel for private(i, node)
+  for (element = 0; element < element_num; element++)
+  {
+    node = element_node[element * element_order] - 1;
+    box[4 * element] = node_xy[0][node];
+    box[4 * element + 1] = node_xy[0][node];
+    box[4 * element + 2] = node_xy[1][node];
+    box[4 * element + 3] = node_xy[1][node];
+    for (i = 1; i < element_order; i++)
+    {
+      node = element_node[element * element_order + i] - 1;
+      box[4 * element] = fmin(box[4 * element], node_xy[0][node]);
+      box[4 * element + 1] = fmax(box[4 * element + 1], node_xy[0][node]);
+      box[4 * element + 2] = fmin(box[4 * element + 2], node_xy[1][node]);
+      box[4 * element + 3] = fmax(box[4 * element + 3], node_xy[1][node]);
+    }
+  }
+  x_min = box[0];
+  x_max = box[1];
+  y_min = box[2];
+  y_max = box[3];
+  for (element = 1; element < element_num; element++)
+  {
+    x_min = fmin(x_min, box[4 * element]);
+    x_max = fmax(x_max, box[4 * element + 1]);
+    y_min = fmin(y_min, box[4 * element + 2]);
+    y_max = fmax(y_max, box[4 * element + 3]);
+  }
+
+  // about one element per cell
+  cell_size = sqrt((x_max - x_min) * (y_max - y_min) / element_num);
+  if (cell_size <= 0.0)
+    cell_size = fmax(x_max - x_min, y_max - y_min) + 1.0;
+  grid_n[0] = (int)((x_max - x_min) / cell_size) + 1;
+  grid_n[1] = (int)((y_max - y_min) / cell_size) + 1;
+  grid_box[0] = x_min;
+  grid_box[1] = y_min;
+  grid_box[2] = (x_max - x_min) / grid_n[0];
+  grid_box[3] = (y_max - y_min) / grid_n[1];
+  if (grid_box[2] <= 0.0)
+    grid_box[2] = cell_size;
+  if (grid_box[3] <= 0.0)
+    grid_box[3] = cell_size;
+  cell_num = grid_n[0] * grid_n[1];
+
+  // count, then fill the cells (elements stay in increasing order in every cell)
+  *grid_p = (int *)calloc(cell_num + 1, sizeof(int));
+  fill = (int *)malloc(cell_num * sizeof(int));
+  for (element = 0; element < element_num; element++)
+  {
+    cx_min = (int)fmin(fmax((box[4 * element] - x_min) / grid_box[2], 0.0), grid_n[0] - 1);
+    cx_max = (int)fmin(fmax((box[4 * element + 1] - x_min) / grid_box[2], 0.0), grid_n[0] - 1);
+    cy_min = (int)fmin(fmax((box[4 * element + 2] - y_min) / grid_box[3], 0.0), grid_n[1] - 1);
+    cy_max = (int)fmin(fmax((box[4 * element + 3] - y_min) / grid_box[3], 0.0), grid_n[1] - 1);
+    for (cy = cy_min; cy <= cy_max; cy++)
+      for (cx = cx_min; cx <= cx_max; cx++)
+        (*grid_p)[cy * grid_n[0] + cx + 1]++;
+  }
+  for (cell = 0; cell < cell_num; cell++)
+  {
+    (*grid_p)[cell + 1] = (*grid_p)[cell + 1] + (*grid_p)[cell];
+    fill[cell] = (*grid_p)[cell];
+  }
+  grid_e = (int *)malloc(((*grid_p)[cell_num] + 1) * sizeof(int));
+  for (element = 0; element < element_num; element++)
+  {
+    cx_min = (int)fmin(fmax((box[4 * element] - x_min) / grid_box[2], 0.0), grid_n[0] - 1);
+    cx_max = (int)fmin(fmax((box[4 * element + 1] - x_min) / grid_box[2], 0.0), grid_n[0] - 1);
+    cy_min = (int)fmin(fmax((box[4 * element + 2] - y_min) / grid_box[3], 0.0), grid_n[1] - 1);
+    cy_max = (int)fmin(fmax((box[4 * element + 3] - y_min) / grid_box[3], 0.0), grid_n[1] - 1);
+    for (cy = cy_min; cy <= cy_max; cy++)
+      for (cx = cx_min; cx <= cx_max; cx++)
+        grid_e[fill[cy * grid_n[0] + cx]++] = element;
+  }
+
+  free(box);
+  free(fill);
+  return grid_e;
+}
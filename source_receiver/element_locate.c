@@ -0,0 +1,91 @@
+int element_locate(char *type, int element_order, int *element_node, double **node_xy, double *grid_box, int *grid_n, int *grid_p, int *grid_e,
+                   double x, double y, double *r, double *s)
+/******************************************************************************/
+/*
+  Purpose:
+
+    element_locate returns the element that holds the point (x, y), from 0, and the
+    reference coordinates (r, s) of the point in it, or -1 when the point is outside
+    the mesh. Only the elements listed in the cell of the point by element_grid are
+    tested, with the geometry of the assembly (see element_vertex): (r, s) is exact
+    for triangles and found by Newton iterations for the bilinear quadrilaterals.
+
+    A point on an edge shared by several elements goes to the one with the smallest
+    index, so the result does not depend on the node numbering.
+*/
+{
+  int i, k, it, element, cell, cx, cy;
+  int vertex[4];
+  int vertex_num;
+  double tol = 1.0e-8;
+  double vx[4], vy[4];
+  double rr, ss, fx, fy, dxdr, dxds, dydr, dyds, det;
+
+  vertex_num = element_vertex(type, vertex);
+  cx = (int)fmin(fmax((x - grid_box[0]) / grid_box[2], 0.0), grid_n[0] - 1);
+  cy = (int)fmin(fmax((y - grid_box[1]) / grid_box[3], 0.0), grid_n[1] - 1);
+  cell = cy * grid_n[0] + cx;
+
+  for (k = grid_p[cell]; k < grid_p[cell + 1]; k++)
+  {
+    element = grid_e[k];
+    for (i = 0; i < vertex_num; i++)
+    {
+      vx[i] = node_xy[0][element_node[element * element_order + vertex[i]] - 1];
+      vy[i] = node_xy[1][element_node[element * element_order + vertex[i]] - 1];
+    }
+    if (vertex_num == 3)
+    {
+      // x = v0 + r * (v1 - v0) + s * (v2 - v0)
+      dxdr = vx[1] - vx[0];
+      dxds = vx[2] - vx[0];
+      dydr = vy[1] - vy[0];
+      dyds = vy[2] - vy[0];
+      det = dxdr * dyds - dxds * dydr;
+      rr = ((x - vx[0]) * dyds - (y - vy[0]) * dxds) / det;
+      ss = ((y - vy[0]) * dxdr - (x - vx[0]) * dydr) / det;
+      if (rr >= -tol && ss >= -tol && rr + ss <= 1.0 + tol)
+      {
+        rr = fmax(rr, 0.0);
+        ss = fmax(ss, 0.0);
+        if (rr + ss > 1.0)
+        {
+          rr = rr / (rr + ss);
+          ss = 1.0 - rr;
+        }
+        *r = rr;
+        *s = ss;
+        return element;
+      }
+    }
+    else
+    {
+      // x = (1-r)(1-s) v0 + r (1-s) v1 + r s v2 + (1-r) s v3
+      rr = 0.5;
+      ss = 0.5;
+      for (it = 0; it < 20; it++)
+      {
+        fx = (1.0 - rr) * (1.0 - ss) * vx[0] + rr * (1.0 - ss) * vx[1] + rr * ss * vx[2] + (1.0 - rr) * ss * vx[3] - x;
+        fy = (1.0 - rr) * (1.0 - ss) * vy[0] + rr * (1.0 - ss) * vy[1] + rr * ss * vy[2] + (1.0 - rr) * ss * vy[3] - y;
+        dxdr = (1.0 - ss) * (vx[1] - vx[0]) + ss * (vx[2] - vx[3]);
+        dydr = (1.0 - ss) * (vy[1] - vy[0]) + ss * (vy[2] - vy[3]);
+        dxds = (1.0 - rr) * (vx[3] - vx[0]) + rr * (vx[2] - vx[1]);
+        dyds = (1.0 - rr) * (vy[3] - vy[0]) + rr * (vy[2] - vy[1]);
+        det = dxdr * dyds - dxds * dydr;
+        if (det == 0.0)
+          break;
+        rr = rr - (fx * dyds - fy * dxds) / det;
+        ss = ss - (fy * dxdr - fx * dydr) / det;
+        if (fabs(fx * dyds - fy * dxds) + fabs(fy * dxdr - fx * dydr) <= 1.0e-14 * fabs(det))
+          break;
+      }
+      if (rr >= -tol && rr <= 1.0 + tol && ss >= -tol && ss <= 1.0 + tol)
+      {
+        *r = fmin(fmax(rr, 0.0), 1.0);
+        *s = fmin(fmax(ss, 0.0), 1.0);
+        return element;
+      }
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,65 @@
+void fft_radix2(int n, double *re, double *im, int sign)
+/******************************************************************************/
+/*
+  Purpose:
+
+    fft_radix2 computes in place the discrete Fourier transform of the n complex values
+    (re, im), n a power of 2:
+
+      X[k] = sum_j x[j] exp(sign * 2 pi i j k / n)
+
+    sign = -1 is the forward transform, sign = +1 the inverse one without the 1 / n.
+*/
+{
+  int i, j, k, m, half;
+  double pi = 3.141592653589793238462643;
+  double angle, wr, wi, w_re, w_im, t_re, t_im, temp;
+
+  // bit reversal
+  j = 0;
+  for (i = 0; i < n - 1; i++)
+  {
+    if (i < j)
+    {
+      temp = re[i];
+      re[i] = re[j];
+      re[j] = temp;
+      temp = im[i];
+      im[i] = im[j];
+      im[j] = temp;
+    }
+    k = n / 2;
+    while (k <= j)
+    {
+      j = j - k;
+      k = k / 2;
+    }
+    j = j + k;
+  }
+
+  // butterflies
+  for (m = 2; m <= n; m = 2 * m)
+  {
+    half = m / 2;
+    angle = sign * 2.0 * pi / m;
+    wr = cos(angle);
+    wi = sin(angle);
+    for (i = 0; i < n; i = i + m)
+    {
+      w_re = 1.0;
+      w_im = 0.0;
+      for (k = 0; k < half; k++)
+      {
+        t_re = w_re * re[i + k + half] - w_im * im[i + k + half];
+        t_im = w_re * im[i + k + half] + w_im * re[i + k + half];
+        re[i + k + half] = re[i + k] - t_re;
+        im[i + k + half] = im[i + k] - t_im;
+        re[i + k] = re[i + k] + t_re;
+        im[i + k] = im[i + k] + t_im;
+        temp = w_re * wr - w_im * wi;
+        w_im = w_re * wi + w_im * wr;
+        w_re = temp;
+      }
+    }
+  }
+}
@@ -0,0 +1,52 @@
+void point_weight(char *type, int element_order, double r, double s, double *weight)
+/******************************************************************************/
+/*
+  Purpose:
+
+    point_weight returns the weights of the element nodes for a point at the reference
+    coordinates (r, s): the shape functions of shape/, weight[i] for element node i.
+    A source is injected as weight[i] * force at the nodes and a receiver samples
+    sum weight[i] * u[node i], the same as the load vector and the field of the element.
+
+    The T10 nodes of mesh_element_t10 are numbered edge by edge while shape_t10 goes
+    row by row, so the T10 values are put back in the node order of the mesh.
+*/
+{
+  int i;
+  static const int shape_index_t10[10] = {0, 1, 2, 3, 6, 8, 9, 7, 4, 5};
+  double t[16], dtdr[16], dtds[16];
+
+  if (strcmp(type, "T3") == 0)
+  {
+    shape_t3(r, s, weight, dtdr, dtds);
+  }
+  else if (strcmp(type, "T6") == 0)
+  {
+    shape_t6(r, s, weight, dtdr, dtds);
+  }
+  else if (strcmp(type, "T10") == 0)
+  {
+    shape_t10(r, s, t, dtdr, dtds);
+    for (i = 0; i < element_order; i++)
+      weight[i] = t[shape_index_t10[i]];
+  }
+  else if (strcmp(type, "Q4") == 0)
+  {
+    shape_q4(r, s, weight, dtdr, dtds);
+  }
+  else if (strcmp(type, "Q9") == 0)
+  {
+    shape_q9(r, s, weight, dtdr, dtds);
+  }
+  else if (strcmp(type, "Q16") == 0)
+  {
+    shape_q16(r, s, weight, dtdr, dtds);
+  }
+  else
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "POINT_WEIGHT - Fatal error!\n");
+    fprintf(stderr, "  Illegal value of type = \"%s\".\n", type);
+    exit(1);
+  }
+}
@@ -0,0 +1,96 @@
+void reciprocity_gather(int src_num, int rec_num, int step, double force_x, double force_y)
+/******************************************************************************/
+/*
+  Purpose:
+
+    reciprocity_gather writes the source gathers of a reciprocal run (see reciprocity_shot),
+    ./outputfile/seismogram_u_shot_%d.txt and seismogram_w_shot_%d.txt as a direct run does.
+    For the force (force_x, force_y) of the sources (Angle_force), the records at receiver r
+    of source s are
+
+      u = force_x * U(s; x force at r) + force_y * W(s; x force at r)
+      w = force_x * U(s; y force at r) + force_y * W(s; y force at r)
+
+    The records of the 2 * rec_num reciprocal shots at the src_num sources are read from
+    ./outputfile/reciprocal.bin (see reciprocity_write, removed at the end), for as many
+    sources at a time as block_memory holds.
+*/
+{
+  int it, r, b, shot, shot_num, src_first, block_num;
+  size_t ux, wx, uy, wy, row;
+  double block_memory = 256.0; // MB
+  double *block = NULL;
+  char filename_seismogram_u[128], filename_seismogram_w[128];
+  FILE *fp_seismogram_u, *fp_seismogram_w, *fp_reciprocal;
+
+  shot_num = 2 * rec_num;
+  block_num = (int)fmin(fmax(block_memory * 1048576.0 / (sizeof(double) * (double)shot_num * step * 2), 1.0), (double)src_num);
+  block = (double *)malloc((size_t)shot_num * step * 2 * block_num * sizeof(double));
+  if ((fp_reciprocal = fopen("./outputfile/reciprocal.bin", "rb")) == NULL || block == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "RECIPROCITY_GATHER - Fatal error!\n");
+    fprintf(stderr, "  Can not read ./outputfile/reciprocal.bin for %d sources at a time.\n", block_num);
+    exit(1);
+  }
+
+  for (src_first = 0; src_first < src_num; src_first += block_num)
+  {
+    if (src_first + block_num > src_num)
+      block_num = src_num - src_first;
+    // row (shot * step + it) * 2 + 0 or 1 of the file, sources src_first ... src_first + block_num - 1
+    for (shot = 0; shot < shot_num; shot++)
+    {
+      for (it = 2; it < step; it++)
+      {
+        for (b = 0; b < 2; b++)
+        {
+          row = ((size_t)shot * step + it) * 2 + b;
+          fseek(fp_reciprocal, (long)((row * src_num + src_first) * sizeof(double)), SEEK_SET);
+          if (fread(block + row * block_num, sizeof(double), block_num, fp_reciprocal) != (size_t)block_num)
+          {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "RECIPROCITY_GATHER - Fatal error!\n");
+            fprintf(stderr, "  ./outputfile/reciprocal.bin is not complete.\n");
+            exit(1);
+          }
+        }
+      }
+    }
+
+    for (b = 0; b < block_num; b++)
+    {
+      sprintf(filename_seismogram_u, "./outputfile/seismogram_u_shot_%d.txt", src_first + b + 1);
+      sprintf(filename_seismogram_w, "./outputfile/seismogram_w_shot_%d.txt", src_first + b + 1);
+      fp_seismogram_u = fopen(filename_seismogram_u, "w");
+      fp_seismogram_w = fopen(filename_seismogram_w, "w");
+      if (fp_seismogram_u == NULL || fp_seismogram_w == NULL)
+      {
+        fprintf(stderr, "\n");
+        fprintf(stderr, "RECIPROCITY_GATHER - Fatal error!\n");
+        fprintf(stderr, "  Can not open %s.\n", filename_seismogram_u);
+        exit(1);
+      }
+      for (it = 2; it < step; it++)
+      {
+        for (r = 0; r < rec_num; r++)
+        {
+          ux = (((size_t)(2 * r) * step + it) * 2) * block_num + b;
+          wx = ux + block_num;
+          uy = (((size_t)(2 * r + 1) * step + it) * 2) * block_num + b;
+          wy = uy + block_num;
+          fprintf(fp_seismogram_u, "%f   ", force_x * block[ux] + force_y * block[wx]);
+          fprintf(fp_seismogram_w, "%f   ", force_x * block[uy] + force_y * block[wy]);
+        }
+        fprintf(fp_seismogram_u, "\n");
+        fprintf(fp_seismogram_w, "\n");
+      }
+      fclose(fp_seismogram_u);
+      fclose(fp_seismogram_w);
+    }
+  }
+
+  fclose(fp_reciprocal);
+  remove("./outputfile/reciprocal.bin");
+  free(block);
+}
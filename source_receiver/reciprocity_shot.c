@@ -0,0 +1,47 @@
+int reciprocity_shot(int rec_num, int point_order, int *rec_node, double *rec_weight,
+                     int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *shot_force)
+/******************************************************************************/
+/*
+  Purpose:
+
+    reciprocity_shot sets the shots of the reciprocal mode: a force at every receiver, once
+    in x and once in y, recorded at the sources. By reciprocity, G_ij(receiver, source) =
+    G_ji(source, receiver), reciprocity_gather turns these records into the source gathers
+    of the survey with 2 * rec_num simulations instead of src_num.
+
+      shot 2 r     : force (1, 0) at receiver r
+      shot 2 r + 1 : force (0, 1) at receiver r
+
+    The entries are the nodes of set_receiver_node with a non zero weight, all of them fire
+    the wavelet of source 0 (see source_wavelet, without encoding).
+
+  Output:
+    shot_p, shot_force            : size 2 * rec_num + 1 and 2 * 2 * rec_num
+    inj_node, inj_weight, inj_src : size 2 * rec_num * point_order at most
+    return                        : shot_num = 2 * rec_num
+*/
+{
+  int i, k, shot, entry;
+
+  entry = 0;
+  for (shot = 0; shot < 2 * rec_num; shot++)
+  {
+    i = shot / 2;
+    shot_p[shot] = entry;
+    shot_force[2 * shot] = (shot % 2 == 0) ? 1.0 : 0.0;
+    shot_force[2 * shot + 1] = (shot % 2 == 0) ? 0.0 : 1.0;
+    for (k = 0; k < point_order; k++)
+    {
+      if (rec_weight[i * point_order + k] != 0.0)
+      {
+        inj_node[entry] = rec_node[i * point_order + k];
+        inj_weight[entry] = rec_weight[i * point_order + k];
+        inj_src[entry] = 0;
+        entry++;
+      }
+    }
+  }
+  shot_p[2 * rec_num] = entry;
+
+  return 2 * rec_num;
+}
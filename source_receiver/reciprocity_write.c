@@ -0,0 +1,33 @@
+void reciprocity_write(int shot, int rec_num, int step, double *seismogram_shot)
+/******************************************************************************/
+/*
+  Purpose:
+
+    reciprocity_write puts the records of one reciprocal shot, u and w of step it at
+    seismogram_shot[(it * 2 + 0 or 1) * rec_num + i], in the binary file
+    ./outputfile/reciprocal.bin at the place of the shot, the shots one after the other (shot 0
+    starts the file). reciprocity_gather reads them back, so the records of all the shots are
+    never in memory together.
+*/
+{
+  size_t size;
+  FILE *fp_reciprocal;
+
+  size = (size_t)step * 2 * rec_num;
+  if ((fp_reciprocal = fopen("./outputfile/reciprocal.bin", (shot == 0) ? "wb" : "r+b")) == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "RECIPROCITY_WRITE - Fatal error!\n");
+    fprintf(stderr, "  Can not open ./outputfile/reciprocal.bin.\n");
+    exit(1);
+  }
+  fseek(fp_reciprocal, (long)((size_t)shot * size * sizeof(double)), SEEK_SET);
+  if (fwrite(seismogram_shot, sizeof(double), size, fp_reciprocal) != size)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "RECIPROCITY_WRITE - Fatal error!\n");
+    fprintf(stderr, "  The records of shot %d are not complete in ./outputfile/reciprocal.bin.\n", shot + 1);
+    exit(1);
+  }
+  fclose(fp_reciprocal);
+}
@@ -0,0 +1,62 @@
+int set_point_node(int point_num, double *point_x, double *point_y, char *type, int element_order, int *element_node, double **node_xy,
+                   double *grid_box, int *grid_n, int *grid_p, int *grid_e, int point_interpolation, int *point_node, double *node_weight)
+/******************************************************************************/
+/*
+  Purpose:
+
+    set_point_node finds the element of every point with element_locate and keeps the
+    nodes of that element and their weights, computed once here so that a source is a
+    small scatter and a receiver a small gather at every time step:
+
+      point i  <->  point_node[i * element_order + k], node_weight[i * element_order + k]
+
+    point_interpolation = 1: the weights are the shape functions at the point (point_weight);
+    point_interpolation = 0: the weight is 1 at the element node nearest to the point.
+
+    Return the number of points outside the mesh, their nodes are set to -1.
+*/
+{
+  int i, k, element, nearest;
+  int outside_num = 0;
+  double r, s, distance, distance_min;
+
+  #pragma omp parallel for private(k, element, nearest, r, s, distance, distance_min) reduction(+ : outside_num)
+  for (i = 0; i < point_num; i++)
+  {
+    element = element_locate(type, element_order, element_node, node_xy, grid_box, grid_n, grid_p, grid_e, point_x[i], point_y[i], &r, &s);
+    if (element < 0)
+    {
+      for (k = 0; k < element_order; k++)
+      {
+        point_node[i * element_order + k] = -1;
+        node_weight[i * element_order + k] = 0.0;
+      }
+      outside_num++;
+      continue;
+    }
+    for (k = 0; k < element_order; k++)
+      point_node[i * element_order + k] = element_node[element * element_order + k] - 1;
+    if (point_interpolation == 1)
+    {
+      point_weight(type, element_order, r, s, node_weight + i * element_order);
+    }
+    else
+    {
+      nearest = 0;
+      distance_min = -1.0;
+      for (k = 0; k < element_order; k++)
+      {
+        distance = pow(node_xy[0][point_node[i * element_order + k]] - point_x[i], 2) + pow(node_xy[1][point_node[i * element_order + k]] - point_y[i], 2);
+        if (distance_min < 0.0 || distance < distance_min)
+        {
+          nearest = k;
+          distance_min = distance;
+        }
+      }
+      for (k = 0; k < element_order; k++)
+        node_weight[i * element_order + k] = (k == nearest) ? 1.0 : 0.0;
+    }
+  }
+
+  return outside_num;
+}
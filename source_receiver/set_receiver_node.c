@@ -1,32 +1,46 @@
-void set_receiver_node(int rec_num, int node_num, double edge_size, double *rec_x, double *rec_y, double **node_xy, int *rec_node)
+void set_receiver_node(int rec_num, double *rec_x, double *rec_y, char *type, int element_order, int *element_node, double **node_xy,
+                       double *grid_box, int *grid_n, int *grid_p, int *grid_e, int point_interpolation, int *rec_node, double *rec_weight)
 /******************************************************************************/
 /*
   Purpose:
 
-    set_receiver_node return receivers node index according to the given (rec_x, rec_y), 
-    the total number of receiver is rec_num.
+    set_receiver_node returns the nodes and weights of the receivers at the given (rec_x, rec_y),
+    the total number of receiver is rec_num, see set_point_node. Receiver i samples
+    sum rec_weight[i * element_order + k] * u[rec_node[i * element_order + k]].
 
 */
 {
-	int i;
+	int i, k;
 	double x, y;
 	FILE *fp_receiver_xy;
-    if ((fp_receiver_xy = fopen("./outputfile/receiver_station.txt", "w")) == NULL)
-        printf("\n receiver_station.txt file cannot open\n");
-	if (rec_num >= 1)
+	if (rec_num < 1)
 	{
+		printf("Error: receiver number is less than 1.\n");
+		return;
+	}
+	if (set_point_node(rec_num, rec_x, rec_y, type, element_order, element_node, node_xy, grid_box, grid_n, grid_p, grid_e,
+	                   point_interpolation, rec_node, rec_weight) > 0)
+	{
+		fprintf(stderr, "\n");
+		fprintf(stderr, "SET_RECEIVER_NODE - Fatal error!\n");
 		for (i = 0; i < rec_num; i++)
-		{
-			rec_node[i] = -1; // initial to be -1
-			x = rec_x[i];
-			y = rec_y[i];
-			rec_node[i] = node_location(node_num, edge_size, node_xy, x, y);
-			fprintf(fp_receiver_xy, "%f	%f\n", node_xy[0][rec_node[i]], node_xy[1][rec_node[i]]);
-		}
+			if (rec_node[i * element_order] < 0)
+				fprintf(stderr, "  Receiver %d at (%f,%f) is outside the mesh.\n", i + 1, rec_x[i], rec_y[i]);
+		exit(1);
 	}
-	else
+	if ((fp_receiver_xy = fopen("./outputfile/receiver_station.txt", "w")) == NULL)
+		printf("\n receiver_station.txt file cannot open\n");
+	for (i = 0; i < rec_num; i++)
 	{
-		printf("Error: receiver number is less than 1.\n");
+		// the position that is sampled, the nearest node when point_interpolation = 0
+		x = 0.0;
+		y = 0.0;
+		for (k = 0; k < element_order; k++)
+		{
+			x = x + rec_weight[i * element_order + k] * node_xy[0][rec_node[i * element_order + k]];
+			y = y + rec_weight[i * element_order + k] * node_xy[1][rec_node[i * element_order + k]];
+		}
+		fprintf(fp_receiver_xy, "%f	%f\n", x, y);
 	}
 	fclose(fp_receiver_xy);
 }
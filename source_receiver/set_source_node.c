@@ -1,32 +1,46 @@
-void set_source_node(int src_num, int node_num, double edge_size, double *src_x, double *src_y, double **node_xy, int *src_node)
+void set_source_node(int src_num, double *src_x, double *src_y, char *type, int element_order, int *element_node, double **node_xy,
+                     double *grid_box, int *grid_n, int *grid_p, int *grid_e, int point_interpolation, int *src_node, double *src_weight)
 /******************************************************************************/
 /*
   Purpose:
 
-    set_source_node return source node index according to the given (src_x, src_y), 
-    the total number of source is src_num.
+    set_source_node returns the nodes and weights of the sources at the given (src_x, src_y),
+    the total number of source is src_num, see set_point_node. Source i adds
+    src_weight[i * element_order + k] * force to the node src_node[i * element_order + k].
 
 */
 {
-	int i;
+	int i, k;
 	double x, y;
 	FILE *fp_source_xy;
-	if ((fp_source_xy = fopen("./outputfile/source_location.txt", "w")) == NULL)
-        printf("\n source_location.txt file cannot open\n");
-	if (src_num >= 1)
+	if (src_num < 1)
 	{
+		printf("Error: source number is less than 1.\n");
+		return;
+	}
+	if (set_point_node(src_num, src_x, src_y, type, element_order, element_node, node_xy, grid_box, grid_n, grid_p, grid_e,
+	                   point_interpolation, src_node, src_weight) > 0)
+	{
+		fprintf(stderr, "\n");
+		fprintf(stderr, "SET_SOURCE_NODE - Fatal error!\n");
 		for (i = 0; i < src_num; i++)
-		{
-			src_node[i] = -1; // initial to be -1
-			x = src_x[i];
-			y = src_y[i];
-			src_node[i] = node_location(node_num, edge_size, node_xy, x, y);
-			fprintf(fp_source_xy, "%lf	%lf\n", node_xy[0][src_node[i]], node_xy[1][src_node[i]]);
-		}
+			if (src_node[i * element_order] < 0)
+				fprintf(stderr, "  Source %d at (%f,%f) is outside the mesh.\n", i + 1, src_x[i], src_y[i]);
+		exit(1);
 	}
-	else
+	if ((fp_source_xy = fopen("./outputfile/source_location.txt", "w")) == NULL)
+		printf("\n source_location.txt file cannot open\n");
+	for (i = 0; i < src_num; i++)
 	{
-		printf("Error: source number is less than 1.\n");
+		// the position of the force, the nearest node when point_interpolation = 0
+		x = 0.0;
+		y = 0.0;
+		for (k = 0; k < element_order; k++)
+		{
+			x = x + src_weight[i * element_order + k] * node_xy[0][src_node[i * element_order + k]];
+			y = y + src_weight[i * element_order + k] * node_xy[1][src_node[i * element_order + k]];
+		}
+		fprintf(fp_source_xy, "%lf	%lf\n", x, y);
 	}
 	fclose(fp_source_xy);
 }
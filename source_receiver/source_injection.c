@@ -0,0 +1,52 @@
+int source_injection(int src_num, int point_order, int *src_node, double *src_weight, int supershot,
+                     int *shot_p, int *inj_node, double *inj_weight, int *inj_src)
+/******************************************************************************/
+/*
+  Purpose:
+
+    source_injection groups the sources into shots of supershot sources each (one source per
+    shot when supershot <= 1) and lists, for every shot, the nodes where a force is injected:
+
+      shot s  <->  entries e = shot_p[s] to shot_p[s + 1] - 1:
+                   inj_weight[e] * wavelet of source inj_src[e] added at node inj_node[e]
+
+    The entries are the nodes of set_source_node with a non zero weight, so a source on a
+    node is a single entry and the time loop only touches the nodes that carry a force.
+
+  Input:
+    src_node, src_weight : point_order nodes and weights per source, see set_point_node
+
+  Output:
+    shot_p               : size shot_num + 1
+    inj_node, inj_weight, inj_src : size src_num * point_order at most
+    return               : shot_num
+*/
+{
+  int i, k, shot, shot_num, entry;
+
+  if (supershot < 1)
+    supershot = 1;
+  shot_num = (src_num + supershot - 1) / supershot;
+
+  entry = 0;
+  for (shot = 0; shot < shot_num; shot++)
+  {
+    shot_p[shot] = entry;
+    for (i = shot * supershot; i < src_num && i < (shot + 1) * supershot; i++)
+    {
+      for (k = 0; k < point_order; k++)
+      {
+        if (src_weight[i * point_order + k] != 0.0)
+        {
+          inj_node[entry] = src_node[i * point_order + k];
+          inj_weight[entry] = src_weight[i * point_order + k];
+          inj_src[entry] = i;
+          entry++;
+        }
+      }
+    }
+  }
+  shot_p[shot_num] = entry;
+
+  return shot_num;
+}
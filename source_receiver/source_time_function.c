@@ -0,0 +1,26 @@
+double source_time_function(int source_type, double f0, double t0, double magnitide, double t)
+/******************************************************************************/
+/*
+  Purpose:
+
+    source_time_function returns the force of a source at time t:
+
+      source_type = 0: Ricker wavelet of dominant frequency f0 (seismic_source);
+      source_type = 1: band-limited impulse, the Gaussian exp(-(pi f0 (t - t0))^2), flat
+                       spectrum at low frequencies and about -80 dB at 3 f0.
+
+    The impulse is the reference of an impulse response run: the seismograms can be turned
+    into those of any wavelet with a band below f0 by tools/seismogram_convolve, without
+    a new simulation. Take t0 >= 1.2 / f0 so the impulse is not cut at the start.
+*/
+{
+  double a;
+  double pi = 3.141592653589793238462643;
+
+  if (source_type == 1)
+  {
+    a = (pi * f0 * (t - t0)) * (pi * f0 * (t - t0));
+    return magnitide * exp(-a);
+  }
+  return seismic_source(f0, t0, magnitide, t);
+}
@@ -0,0 +1,77 @@
+void source_wavelet(int src_num, int step, double dt, double f0, double t0, int source_type, int encoding, double shift_max, unsigned int seed,
+                    double *polarity, double *shift, double *wavelet)
+/******************************************************************************/
+/*
+  Purpose:
+
+    source_wavelet tabulates the wavelet of every source once for the whole time loop,
+    wavelet[src * step + it] at time (it + 1) * dt, the source_time_function of source_type
+    with the encoding of the source when several sources are shot together (see source_injection):
+
+      encoding = 0: none,     polarity 1, shift 0, all sources fire the same wavelet;
+      encoding = 1: polarity, a random sign per source;
+      encoding = 2: shift,    a random onset delay in [0, shift_max] per source.
+
+    The random numbers come from seed only (xorshift), so a run can be repeated and the
+    encoding undone afterwards; it is also written to ./outputfile/source_encoding.txt.
+
+    The wavelet without encoding is written to ./outputfile/source_wavelet.txt, time and value
+    for every row of the seismograms (it = 2 to step - 1), the reference of seismogram_convolve.
+*/
+{
+  int i, it;
+  unsigned int state = seed * 2654435761u + 2463534242u;
+  FILE *fp_encoding;
+  FILE *fp_wavelet;
+
+  // a few steps first, so that small seeds do not give small first numbers
+  for (i = 0; i < 16; i++)
+  {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+  }
+
+  for (i = 0; i < src_num; i++)
+  {
+    polarity[i] = 1.0;
+    shift[i] = 0.0;
+    if (encoding == 1 || encoding == 2)
+    {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      if (encoding == 1)
+        polarity[i] = (state >> 31) ? 1.0 : -1.0;
+      else
+        shift[i] = shift_max * (state / 4294967296.0);
+    }
+  }
+
+  #pragma omp parallel for private(it)
+  for (i = 0; i < src_num; i++)
+  {
+    for (it = 0; it < step; it++)
+      wavelet[(size_t)i * step + it] = polarity[i] * source_time_function(source_type, f0, t0 + shift[i], 1.0e10, (it + 1) * dt);
+  }
+
+  if ((fp_wavelet = fopen("./outputfile/source_wavelet.txt", "w")) == NULL)
+  {
+    printf("\n source_wavelet.txt file cannot open\n");
+  }
+  else
+  {
+    for (it = 2; it < step; it++)
+      fprintf(fp_wavelet, "%.9e	%.17e\n", (it + 1) * dt, source_time_function(source_type, f0, t0, 1.0e10, (it + 1) * dt));
+    fclose(fp_wavelet);
+  }
+
+  if ((fp_encoding = fopen("./outputfile/source_encoding.txt", "w")) == NULL)
+  {
+    printf("\n source_encoding.txt file cannot open\n");
+    return;
+  }
+  for (i = 0; i < src_num; i++)
+    fprintf(fp_encoding, "%d	%f	%.9f\n", i + 1, polarity[i], shift[i]);
+  fclose(fp_encoding);
+}
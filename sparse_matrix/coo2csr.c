@@ -0,0 +1,165 @@
+void coo2csr_canonical(int nnz, int Bp_size, int *csr_size, int *Ai, int *Aj, double *Ax, int *Bp, int *Bj, double *Bx)
+/******************************************************************************/
+/*
+  Purpose:
+
+    coo2csr_canonical converts a coo matrix (Ai, Aj, Ax) into the canonical csr format (Bp, Bj, Bx):
+    column indices sorted in each row, duplicate entries summed up and zero entries removed.
+
+    Everything is 0-based, Ai, Aj, Ax are not modified,
+    and the workspaces are on the heap, so big meshes no longer need a large stack.
+
+    1. parallel counting sort of the entries by row, each thread counts and scatters its own chunk;
+    2. each row is sorted by column (the rows are short, insertion sort), duplicates are summed
+       and zeros are dropped in place;
+    3. the compacted rows are copied to (Bj, Bx).
+
+  Input:
+    nnz        : number of coo entries
+    Bp_size    : node_num + 1
+    Ai, Aj, Ax : coo row indices, column indices and values, 0-based
+
+  Output:
+    csr_size   : number of csr entries, the size used in Bj and Bx
+    Bp         : csr row pointers, size Bp_size
+    Bj, Bx     : csr column indices and values, size >= csr_size (nnz is always enough)
+*/
+{
+  int n_row, thread_num;
+  int i, k, t, row, dest, pos, temp;
+  int r1, r2, kk, jj, j_temp;
+  double x_temp;
+  int *count = NULL;
+  int *row_size = NULL;
+  int *Bj_temp = NULL;
+  double *Bx_temp = NULL;
+
+  n_row = Bp_size - 1;
+  thread_num = omp_get_max_threads();
+
+  count = (int *)calloc((size_t)n_row * thread_num, sizeof(int)); // count[row * thread_num + t]
+  row_size = (int *)malloc(n_row * sizeof(int));
+  Bj_temp = (int *)malloc(nnz * sizeof(int));
+  Bx_temp = (double *)malloc(nnz * sizeof(double));
+  if (count == NULL || row_size == NULL || Bj_temp == NULL || Bx_temp == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "COO2CSR_CANONICAL - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for nnz = %d.\n", nnz);
+    exit(1);
+  }
+
+  for (k = 0; k < nnz; k++)
+  {
+    if (Ai[k] < 0 || Ai[k] >= n_row)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "COO2CSR_CANONICAL - Fatal error!\n");
+      fprintf(stderr, "  Row index %d of entry %d is out of [0, %d).\n", Ai[k], k, n_row);
+      exit(1);
+    }
+  }
+
+  // 1. count the entries of every row, chunk t of the coo arrays is counted by thread t
+  #pragma omp parallel for private(t, k)
+  for (t = 0; t < thread_num; t++)
+  {
+    for (k = (int)((long)nnz * t / thread_num); k < (int)((long)nnz * (t + 1) / thread_num); k++)
+      count[Ai[k] * thread_num + t]++;
+  }
+
+  // exclusive scan: row by row, then chunk by chunk in the row, keeps the sort stable
+  pos = 0;
+  for (row = 0; row < n_row; row++)
+  {
+    Bp[row] = pos;
+    for (t = 0; t < thread_num; t++)
+    {
+      temp = count[row * thread_num + t];
+      count[row * thread_num + t] = pos;
+      pos = pos + temp;
+    }
+  }
+  Bp[n_row] = pos;
+
+  #pragma omp parallel for private(t, k, dest)
+  for (t = 0; t < thread_num; t++)
+  {
+    for (k = (int)((long)nnz * t / thread_num); k < (int)((long)nnz * (t + 1) / thread_num); k++)
+    {
+      dest = count[Ai[k] * thread_num + t]++;
+      Bj_temp[dest] = Aj[k];
+      Bx_temp[dest] = Ax[k];
+    }
+  }
+
+  // 2. sort the columns, sum duplicates and drop zeros inside every row
+  #pragma omp parallel for private(row, r1, r2, k, kk, jj, j_temp, x_temp) schedule(dynamic, 256)
+  for (row = 0; row < n_row; row++)
+  {
+    r1 = Bp[row];
+    r2 = Bp[row + 1];
+    for (k = r1 + 1; k < r2; k++)
+    {
+      j_temp = Bj_temp[k];
+      x_temp = Bx_temp[k];
+      kk = k - 1;
+      while (kk >= r1 && Bj_temp[kk] > j_temp)
+      {
+        Bj_temp[kk + 1] = Bj_temp[kk];
+        Bx_temp[kk + 1] = Bx_temp[kk];
+        kk--;
+      }
+      Bj_temp[kk + 1] = j_temp;
+      Bx_temp[kk + 1] = x_temp;
+    }
+
+    kk = r1;
+    jj = r1;
+    while (jj < r2)
+    {
+      j_temp = Bj_temp[jj];
+      x_temp = Bx_temp[jj];
+      jj++;
+      while (jj < r2 && Bj_temp[jj] == j_temp)
+      {
+        x_temp = x_temp + Bx_temp[jj];
+        jj++;
+      }
+      if (x_temp != 0.0)
+      {
+        Bj_temp[kk] = j_temp;
+        Bx_temp[kk] = x_temp;
+        kk++;
+      }
+    }
+    row_size[row] = kk - r1;
+  }
+
+  // 3. compact the rows into the output
+  for (row = 0; row < n_row; row++)
+    count[row] = Bp[row]; // old row starts, count is free now
+  pos = 0;
+  for (row = 0; row < n_row; row++)
+  {
+    Bp[row] = pos;
+    pos = pos + row_size[row];
+  }
+  Bp[n_row] = pos;
+  *csr_size = pos;
+
+  #pragma omp parallel for private(row, i)
+  for (row = 0; row < n_row; row++)
+  {
+    for (i = 0; i < row_size[row]; i++)
+    {
+      Bj[Bp[row] + i] = Bj_temp[count[row] + i];
+      Bx[Bp[row] + i] = Bx_temp[count[row] + i];
+    }
+  }
+
+  free(count);
+  free(row_size);
+  free(Bj_temp);
+  free(Bx_temp);
+}
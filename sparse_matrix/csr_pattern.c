@@ -0,0 +1,155 @@
+int *csr_pattern(int node_num, int element_num, int element_order, int *element_node, int *csr_p, int *csr_size)
+/******************************************************************************/
+/*
+  Purpose:
+
+    csr_pattern builds the csr pattern (csr_p, csr_j) of the finite element matrices directly
+    from the node-to-node graph of the mesh: node i and node j are connected when they are in
+    the same element. Every mass and stiffness matrix of the mesh has this pattern, so it is
+    built once and the element matrices are scattered into it with csr_scatter_map.
+
+    1. node-to-element lists, by a counting sort of element_node;
+    2. for each node the neighbours are collected from its elements into a sorted list without
+       repeats (one per thread, the size of the longest row, not of the mesh), counted in a
+       first pass and written in a second pass.
+
+  Input:
+    node_num, element_num, element_order
+    element_node : element_node[element * element_order + i], from 1
+
+  Output:
+    csr_p        : csr row pointers, size node_num + 1
+    csr_size     : number of csr entries
+    return       : csr column indices, sorted in each row, size csr_size, free it after use
+*/
+{
+  int i, k, e, iq, row, col, pos, kk, thread_num, thread_id, row_max;
+  int *node_element_p = NULL;
+  int *node_element = NULL;
+  int *neighbour = NULL;
+  int *list = NULL;
+  int *csr_j = NULL;
+
+  thread_num = omp_get_max_threads();
+
+  // 1. node-to-element lists
+  node_element_p = (int *)calloc(node_num + 1, sizeof(int));
+  node_element = (int *)malloc((size_t)element_num * element_order * sizeof(int));
+  if (node_element_p == NULL || node_element == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "CSR_PATTERN - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for node_num = %d.\n", node_num);
+    exit(1);
+  }
+  for (k = 0; k < element_num * element_order; k++)
+  {
+    row = element_node[k] - 1;
+    if (row < 0 || row >= node_num)
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "CSR_PATTERN - Fatal error!\n");
+      fprintf(stderr, "  Node %d of element %d is out of [1, %d].\n", element_node[k], k / element_order, node_num);
+      exit(1);
+    }
+    node_element_p[row + 1]++;
+  }
+  for (i = 0; i < node_num; i++)
+    node_element_p[i + 1] = node_element_p[i + 1] + node_element_p[i];
+  for (i = 0; i < node_num; i++)
+    csr_p[i] = node_element_p[i]; // fill pointer
+  for (k = 0; k < element_num * element_order; k++)
+  {
+    row = element_node[k] - 1;
+    node_element[csr_p[row]++] = k / element_order;
+  }
+
+  // 2. count the neighbours of every node, at most element_order per element of the node
+  row_max = 0;
+  for (i = 0; i < node_num; i++)
+  {
+    if (node_element_p[i + 1] - node_element_p[i] > row_max)
+      row_max = node_element_p[i + 1] - node_element_p[i];
+  }
+  row_max = row_max * element_order;
+  neighbour = (int *)malloc((size_t)thread_num * row_max * sizeof(int));
+  if (neighbour == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "CSR_PATTERN - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate the workspace for node_num = %d.\n", node_num);
+    exit(1);
+  }
+  #pragma omp parallel private(row, k, kk, e, iq, col, pos, thread_id, list)
+  {
+    thread_id = omp_get_thread_num();
+    list = neighbour + (size_t)thread_id * row_max;
+    #pragma omp for schedule(dynamic, 256)
+    for (row = 0; row < node_num; row++)
+    {
+      pos = 0;
+      for (k = node_element_p[row]; k < node_element_p[row + 1]; k++)
+      {
+        e = node_element[k];
+        for (iq = 0; iq < element_order; iq++)
+        {
+          col = element_node[(size_t)e * element_order + iq] - 1;
+          kk = pos - 1;
+          while (kk >= 0 && list[kk] > col)
+            kk--;
+          if (kk >= 0 && list[kk] == col)
+            continue;
+          memmove(list + kk + 2, list + kk + 1, (pos - kk - 1) * sizeof(int));
+          list[kk + 1] = col;
+          pos++;
+        }
+      }
+      csr_p[row + 1] = pos;
+    }
+  }
+  csr_p[0] = 0;
+  for (i = 0; i < node_num; i++)
+    csr_p[i + 1] = csr_p[i + 1] + csr_p[i];
+  *csr_size = csr_p[node_num];
+
+  // write the neighbours, sorted as they are collected
+  csr_j = (int *)malloc((size_t)*csr_size * sizeof(int));
+  if (csr_j == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "CSR_PATTERN - Fatal error!\n");
+    fprintf(stderr, "  Can not allocate csr_j for csr_size = %d.\n", *csr_size);
+    exit(1);
+  }
+  #pragma omp parallel private(row, k, kk, e, iq, col, pos)
+  {
+    #pragma omp for schedule(dynamic, 256)
+    for (row = 0; row < node_num; row++)
+    {
+      // the row of csr_j is the sorted list itself
+      pos = 0;
+      for (k = node_element_p[row]; k < node_element_p[row + 1]; k++)
+      {
+        e = node_element[k];
+        for (iq = 0; iq < element_order; iq++)
+        {
+          col = element_node[(size_t)e * element_order + iq] - 1;
+          kk = pos - 1;
+          while (kk >= 0 && csr_j[csr_p[row] + kk] > col)
+            kk--;
+          if (kk >= 0 && csr_j[csr_p[row] + kk] == col)
+            continue;
+          memmove(csr_j + csr_p[row] + kk + 2, csr_j + csr_p[row] + kk + 1, (pos - kk - 1) * sizeof(int));
+          csr_j[csr_p[row] + kk + 1] = col;
+          pos++;
+        }
+      }
+    }
+  }
+
+  free(node_element_p);
+  free(node_element);
+  free(neighbour);
+
+  return csr_j;
+}
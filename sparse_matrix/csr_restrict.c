@@ -0,0 +1,48 @@
+int *csr_restrict(int *csr_p, int *csr_j, int *node_sub, int node_sub_num, int *node_sub_old, int *csr_p_sub, int *csr_size_sub, int **csr_map)
+/******************************************************************************/
+/*
+  Purpose:
+
+    csr_restrict restricts a csr pattern to the rows and columns of the sub nodes
+    (see mesh_submesh). csr_map[k] is the entry of the full matrix of the sub entry k,
+    so any matrix of the pattern is restricted by x_sub[k] = x[csr_map[k]], without a
+    new assembly. The columns stay sorted since the sub nodes keep the full order.
+
+  Output:
+    csr_p_sub    : csr row pointers, size node_sub_num + 1
+    csr_size_sub : number of csr entries
+    csr_map      : full entries of the sub entries, size csr_size_sub, free it after use
+    return       : csr column indices, size csr_size_sub, free it after use
+*/
+{
+  int i, k, row, pos;
+  int *csr_j_sub = NULL;
+
+  csr_p_sub[0] = 0;
+  for (i = 0; i < node_sub_num; i++)
+  {
+    row = node_sub_old[i];
+    csr_p_sub[i + 1] = csr_p_sub[i];
+    for (k = csr_p[row]; k < csr_p[row + 1]; k++)
+      csr_p_sub[i + 1] += (node_sub[csr_j[k]] >= 0);
+  }
+  *csr_size_sub = csr_p_sub[node_sub_num];
+  csr_j_sub = (int *)malloc((size_t)*csr_size_sub * sizeof(int));
+  *csr_map = (int *)malloc((size_t)*csr_size_sub * sizeof(int));
+
+  #pragma omp parallel for private(k, row, pos)
+  for (i = 0; i < node_sub_num; i++)
+  {
+    row = node_sub_old[i];
+    pos = csr_p_sub[i];
+    for (k = csr_p[row]; k < csr_p[row + 1]; k++)
+    {
+      if (node_sub[csr_j[k]] < 0)
+        continue;
+      csr_j_sub[pos] = node_sub[csr_j[k]];
+      (*csr_map)[pos] = k;
+      pos++;
+    }
+  }
+  return csr_j_sub;
+}
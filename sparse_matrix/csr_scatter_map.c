@@ -0,0 +1,57 @@
+void csr_scatter_map(int element_num, int element_order, int *element_node, int *csr_p, int *csr_j, int *scatter_map)
+/******************************************************************************/
+/*
+  Purpose:
+
+    csr_scatter_map gives, for every entry (iq, jq) of every element matrix, its position
+    in the csr values of the pattern (csr_p, csr_j) built by csr_pattern:
+
+      scatter_map[element * element_order * element_order + iq * element_order + jq]
+
+    i.e. the index the old coo format used, so the element loops add their local matrix
+    straight into csr_x and no coo triplets have to be stored, sorted or summed up.
+
+  Input:
+    element_num, element_order
+    element_node : element_node[element * element_order + i], from 1
+    csr_p, csr_j : csr pattern of the mesh
+
+  Output:
+    scatter_map  : size element_num * element_order * element_order
+*/
+{
+  int element, iq, jq, row, col, low, high, mid, map_index;
+
+  #pragma omp parallel for private(element, iq, jq, row, col, low, high, mid, map_index)
+  for (element = 0; element < element_num; element++)
+  {
+    for (iq = 0; iq < element_order; iq++)
+    {
+      row = element_node[element * element_order + iq] - 1;
+      for (jq = 0; jq < element_order; jq++)
+      {
+        col = element_node[element * element_order + jq] - 1;
+        // binary search of col in the sorted row
+        low = csr_p[row];
+        high = csr_p[row + 1] - 1;
+        while (low < high)
+        {
+          mid = (low + high) / 2;
+          if (csr_j[mid] < col)
+            low = mid + 1;
+          else
+            high = mid;
+        }
+        map_index = element * element_order * element_order + iq * element_order + jq;
+        if (csr_j[low] != col)
+        {
+          fprintf(stderr, "\n");
+          fprintf(stderr, "CSR_SCATTER_MAP - Fatal error!\n");
+          fprintf(stderr, "  Entry (%d, %d) of element %d is not in the csr pattern.\n", row, col, element);
+          exit(1);
+        }
+        scatter_map[map_index] = low;
+      }
+    }
+  }
+}
@@ -1,10 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory.h>
+#include <omp.h>
+#include "coo2csr.c"
 #define N 18
 
-//void get_csr_size_(int *, int *, int (*)[], int (*)[], double (*)[], int *);
-
 int main()
 {
 	int Ai[N] = {0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 2, 2, 2, 1, 1, 1};
@@ -21,7 +21,7 @@ int main()
 	csr_size = 0;
 	Bp_size = 4 + 1;
 
-	__coo2csr_lib_MOD_coo2csr_canonical(&nnz, &Bp_size, &csr_size, &Ai, &Aj, &Ax, &Bp, &Bj, &Bx);
+	coo2csr_canonical(nnz, Bp_size, &csr_size, Ai, Aj, Ax, Bp, Bj, Bx);
 
 	printf("\ncrs size is %d\n", csr_size);
 	printf("\ncoo format \n");
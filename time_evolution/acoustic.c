@@ -1,223 +1,189 @@
+void acoustic(int node_num, double **node_xy, int csr_p_size, int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x, \
+              double **c, int step, double dt,                                                                                                       \
+              int shot_first, int shot_num, int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *wavelet, char *shot_name,           \
+              int rec_num, int *rec_node, double *rec_weight, int point_order, int *node_new, char *solver, int dirichlet_num, int *dirichlet_node)
+/******************************************************************************/
+/*
+  Purpose:
 
-void acoustic(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, int nnz, int csr_p_size, int step, double dt, double f0, double t0, int source_node, char *solver)
+    acoustic runs the time evolution of the acoustic wave equation for every shot, without
+    absorbing boundary (see acoustic_pml), on the operator of elastic_operator:
+
+      mass * p_tt = - c11 * (dphidx * dphidx + dphidy * dphidy) * p + Source
+
+    with mass from mass_sparse_update for the current rho and c11 = rho * vp * vp, so the
+    same model runs the elastic or the acoustic wave (wave_type in par.txt). The time scheme
+    is the central difference
+
+      p_new = 2 p_now - p_old + dt * dt * mass^-1 * (- c11 * stif * p_now + Source)
+
+    With the masslump solver every node is updated in a single parallel loop over the csr
+    rows: the two stiffness rows are summed together, divided by the lumped mass and the
+    time step is done in the same pass. The free surface is p = 0, set on the dirichlet_num
+    nodes of dirichlet_node (see mesh_boundary_node) after every step.
+
+    The shots, sources and receivers are those of elastic_wave: the shots shot_first to
+    shot_num - 1, inj_weight * wavelet of source inj_src at the nodes of the injection list,
+    the receivers as the weighted sums of the field at rec_node. The output files are
+    seismogram_p_<shot_name>_<shot>.txt and wavefield_p_<shot_name>_<shot>.txt, the
+    snapshots in the order of the mesh files (node_new, see mesh_renumber).
+*/
 {
-    
-    /***************************************
-     coo(i,j,x) and csr(p,j,x) arrays
-     ****************************************/
-    int mass_csr_size = 0; // csr size for mass: j and x
-    int stif_csr_size = 0; // csr size for stif: j and x
-    int *mass_coo_i = NULL;
-    int *mass_coo_j = NULL;
-    int *stif_coo_i = NULL;
-    int *stif_coo_j = NULL;
-    int *mass_csr_p = NULL;
-    int *mass_csr_j = NULL;
-    int *stif_csr_p = NULL;
-    int *stif_csr_j = NULL;
-    int *mass_csr_j_temp = NULL;
-    int *stif_csr_j_temp = NULL;
-    double *mass_coo_x = NULL;
-    double *stif_coo_x = NULL;
-    double *mass_csr_x = NULL;
-    double *stif_csr_x = NULL;
-    double *mass_csr_x_temp = NULL;
-    double *stif_csr_x_temp = NULL;
-    double *mass_lump = NULL;
-    
-    /***************************************
-     model density and velocity parameters
-     ****************************************/
-    double *rho = NULL;
-    double *vp = NULL;
-    
+    double *stif1_csr_x = stif_csr_x[0];
+    double *stif2_csr_x = stif_csr_x[1];
+
     /***************************************
              time evolution parameters
      ****************************************/
-	int i, it;
-	double time;
-	double point_source;
-	double *rhs   = NULL;
-	double *u_old = NULL;
-	double *u_now = NULL;
-	double *y1    = NULL;
-	double *y2    = NULL;
-	double *y3    = NULL;
-	double *energy= NULL;
-    double tol_abs = 1.0e-08; // a relative tolerance comparing the current residual to the initial residual.
-    double tol_rel = 1.0e-08; // an absolute tolerance applied to the current residual.
-    int    itr_max = 100;     // the maximum number of (outer) iterations to take.
-    int    mr      = 50;      // the maximum number of (inner) iterations to take.
+    int i, k, it, shot;
+    double time, energy, stif_p;
+    double *p_old = NULL, *p_now = NULL, *p_new = NULL, *p_temp = NULL;
+    double *source = NULL;
+    double *rhs = NULL, *y1 = NULL;
+    double *seismogram_p = NULL;
+    double tol_abs = 1.0e-08;   // a relative tolerance comparing the current residual to the initial residual.
+    double tol_rel = 1.0e-08;   // an absolute tolerance applied to the current residual.
+    int itr_max = 100, mr = 50; // the maximum number of outer and inner iterations to take.
     /***************************************
                   file pointers
      ****************************************/
-    FILE *fp_u, *fp_energy;
+    FILE *fp_wavefield_p, *fp_seismogram_p;
+    char filename_wavefield_p[128], filename_seismogram_p[128];
 
-    /***************************************
-     allocate the dynamic arrays
-     ****************************************/
-    
-    // mass lump
-    mass_lump = (double *)malloc(node_num * sizeof(double));
-    // coo (i,j,x), mass and stif matrices
-    mass_coo_i = (int *)malloc(nnz * sizeof(int));
-    stif_coo_i = (int *)malloc(nnz * sizeof(int));
-    mass_coo_j = (int *)malloc(nnz * sizeof(int));
-    stif_coo_j = (int *)malloc(nnz * sizeof(int));
-    mass_coo_x = (double *)malloc(nnz * sizeof(double));
-    stif_coo_x = (double *)malloc(nnz * sizeof(double));
-    // csr (p,j,x), mass and stif matrices
-    mass_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    mass_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    stif_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    mass_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    stif_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    // model density and velocity matrices
-    rho = (double *)malloc(node_num * sizeof(double));
-    vp  = (double *)malloc(node_num * sizeof(double));
-    rhs = (double *)malloc(node_num * sizeof(double));
-    // time evolution
-    u_old = (double *)malloc(node_num * sizeof(double));
-    u_now = (double *)malloc(node_num * sizeof(double));
-    y1    = (double *)malloc(node_num * sizeof(double));
-    y2    = (double *)malloc(node_num * sizeof(double));
-    y3    = (double *)malloc(node_num * sizeof(double));
-    energy= (double *)malloc(node_num * sizeof(double));
-    
-    acoustic_model(node_num, element_num, element_order, element_node, node_xy, rho, vp);
-    
-    // get lump mass matrix
-    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, mass_coo_i, mass_coo_j, mass_coo_x, 1);
-    for (i = 0; i < node_num; i++)  mass_lump[i] = mass_coo_x[i];
-    // get mass and stif matrices in coo format
-    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, mass_coo_i, mass_coo_j, mass_coo_x, 0);
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 0);
-    // call fortran subroutines to convert coo to csr. Attention: mi, mj, mass, Mp_temp, Mj_temp, Mass_temp are addresses,
-    // do not need use & to get the address of the pointers.
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &mass_csr_size, mass_coo_i, mass_coo_j, mass_coo_x, mass_csr_p, mass_csr_j_temp, mass_csr_x_temp);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    // allocate the real size mass and stif csr matrices
-    mass_csr_j = (int *)malloc(mass_csr_size * sizeof(int));
-    mass_csr_x = (double *)malloc(mass_csr_size * sizeof(double));
-    stif_csr_j = (int *)malloc(stif_csr_size * sizeof(int));
-    stif_csr_x = (double *)malloc(stif_csr_size * sizeof(double));
-    for (i = 0; i < mass_csr_size; i++)
+    seismogram_p = (double *)malloc(rec_num * sizeof(double));
+    p_old = (double *)malloc(node_num * sizeof(double));
+    p_now = (double *)malloc(node_num * sizeof(double));
+    p_new = (double *)malloc(node_num * sizeof(double));
+    source = (double *)calloc(node_num, sizeof(double));
+    if (strcmp(solver, "masslump") != 0)
     {
-        mass_csr_j[i] = mass_csr_j_temp[i];
-        mass_csr_x[i] = mass_csr_x_temp[i];
+        rhs = (double *)malloc(node_num * sizeof(double));
+        y1 = (double *)malloc(node_num * sizeof(double));
     }
-    for (i = 0; i < stif_csr_size; i++)
+
+    for (shot = shot_first; shot < shot_num; shot++)
     {
-        stif_csr_j[i] = stif_csr_j_temp[i];
-        stif_csr_x[i] = stif_csr_x_temp[i];
-    }
+        printf("\n ######## Shot num: %d ########\n", shot + 1);
+
+        sprintf(filename_wavefield_p, "./outputfile/wavefield_p_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_p, "./outputfile/seismogram_p_%s_%d.txt", shot_name, shot + 1);
+        fp_wavefield_p = fopen(filename_wavefield_p, "w");
+        fp_seismogram_p = fopen(filename_seismogram_p, "w");
 
-	fp_u = fopen("u.dat", "w");
-	fp_energy = fopen("energy.dat", "w");
-
-	// write first two step values: u_old[node_num], u_now[node_num], energy[0], energy[1]
-	for (i = 0; i < node_num; i++)
-	{
-		u_old[i] = 0.0;
-		u_now[i] = 0.0;
-		fprintf(fp_u, "%f	", u_old[i]);
-	}
-	fprintf(fp_u, "\n");
-
-	energy[0] = 0.0;
-	energy[1] = 0.0;
-	fprintf(fp_energy, "%f\n", energy[0]);
-	fprintf(fp_energy, "%f\n", energy[1]);
-
-	// begin iteration: from 0 to step-1, time = (step + 1) * dt,  with total iteration number = step
-	// give u(0) ans u(1)
-    
-	for (it = 2; it < step; it++)
-	{
-		time = (it + 1) * dt;
-		energy[it] = 0.0;
-		if ((it + 1) % 100 == 0) printf("iteration step: %-d, time: %-f\n ", it + 1, time);
-
-		for (i = 0; i < node_num; i++)
-		{
-			y1[i] = 0.0;
-			y2[i] = 0.0;
-			y3[i] = 0.0;
-			rhs[i] = 0.0;
-		}
-		point_source = seismic_source(f0, t0, 1.0, time);
-		csr_matvec(csr_p_size, stif_csr_p, stif_csr_j, stif_csr_x, u_now, y1); // stif * u_now
-		csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, u_now, y2); // mass * u_now
-		csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, u_old, y3); // mass * u_old
-        
+        #pragma omp parallel for private(i)
         for (i = 0; i < node_num; i++)
         {
-            rhs[i]   = (i == source_node) * point_source -  vp[i] * vp[i] * dt * dt * y1[i] + 2.0 * y2[i] - y3[i];
-            u_old[i] = u_now[i];
+            p_old[i] = 0.0;
+            p_now[i] = 0.0;
         }
-		// here can use openmp
-        if( strcmp(solver, "masslump") == 0 )
+        for (i = 0; i < node_num; i++)
+            fprintf(fp_wavefield_p, "%f	", p_now[i]);
+        fprintf(fp_wavefield_p, "\n");
+
+        // begin iteration: from 0 to step-1, time = (step + 1) * dt
+        printf("\n****Time iteration begin:\n");
+        for (it = 2; it < step; it++)
         {
-            for (i = 0; i < node_num; i++)
+            time = (it + 1) * dt;
+            if ((it + 1) % 100 == 0)
+                printf("\n ****Iteration step: %-d, time: %-f s\n ", it + 1, time);
+
+            // Source, sparse: only the nodes in the injection list of the shot
+            for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+                source[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it];
+
+            energy = 0.0;
+            if (strcmp(solver, "masslump") == 0)
             {
-                if (mass_lump[i] != 0.0)  u_now[i] = rhs[i] / (1.0 * mass_lump[i]);
-                else  printf("Fatal Error: zero value in the mass_csr_lumped"); // in case zero value
+                // stif * p_now, rhs and time step of a node in one pass
+                #pragma omp parallel for private(k, stif_p) reduction(+ : energy)
+                for (i = 0; i < node_num; i++)
+                {
+                    stif_p = 0.0;
+                    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+                        stif_p += (stif1_csr_x[k] + stif2_csr_x[k]) * p_now[csr_j[k]];
+                    p_new[i] = 2.0 * p_now[i] - p_old[i] + dt * dt * (source[i] - c[0][i] * stif_p) / mass_lump[i];
+                    source[i] = 0.0;
+                    energy += p_new[i] * p_new[i];
+                }
+            }
+            else
+            {
+                // mass * (p_new - 2 p_now + p_old) = dt * dt * (- c11 * stif * p_now + Source)
+                #pragma omp parallel for private(k, stif_p)
+                for (i = 0; i < node_num; i++)
+                {
+                    stif_p = 0.0;
+                    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+                        stif_p += (stif1_csr_x[k] + stif2_csr_x[k]) * p_now[csr_j[k]];
+                    rhs[i] = dt * dt * (source[i] - c[0][i] * stif_p);
+                    source[i] = 0.0;
+                    y1[i] = 0.0;
+                }
+                if (strcmp(solver, "pardiso") == 0)
+                {
+                    pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs, y1);
+                }
+                else if (strcmp(solver, "mgmres") == 0)
+                {
+                    pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, y1, rhs, itr_max, mr, tol_abs, tol_rel);
+                }
+                else
+                {
+                    fprintf(stderr, "\n");
+                    fprintf(stderr, "ACOUSTIC - Fatal error!\n");
+                    fprintf(stderr, "  Solver type is not set = \"%s\".\n", solver);
+                    exit(1);
+                }
+                #pragma omp parallel for private(i) reduction(+ : energy)
+                for (i = 0; i < node_num; i++)
+                {
+                    p_new[i] = 2.0 * p_now[i] - p_old[i] + y1[i];
+                    energy += p_new[i] * p_new[i];
+                }
+            }
+            // boundary condition: p = 0 on the Dirichlet list only
+            #pragma omp parallel for
+            for (k = 0; k < dirichlet_num; k++)
+                p_new[dirichlet_node[k]] = 0.0;
+            if (energy > 10e6)
+            {
+                fprintf(stderr, "\n");
+                fprintf(stderr, "ACOUSTIC - Fatal error!\n");
+                fprintf(stderr, "Energy exceeds maximum value!\n");
+                exit(1);
+            }
+            p_temp = p_old;
+            p_old = p_now;
+            p_now = p_new;
+            p_new = p_temp;
+
+            for (i = 0; i < rec_num; i++)
+            {
+                seismogram_p[i] = 0.0;
+                for (k = 0; k < point_order; k++)
+                    seismogram_p[i] += rec_weight[i * point_order + k] * p_now[rec_node[i * point_order + k]];
+                fprintf(fp_seismogram_p, "%f   ", seismogram_p[i]);
+            }
+            fprintf(fp_seismogram_p, "\n");
+
+            if ((it + 1) % 200 == 0)
+            {
+                for (i = 0; i < node_num; i++)
+                    fprintf(fp_wavefield_p, "%f	", p_now[node_new[i]]);
+                fprintf(fp_wavefield_p, "\n");
             }
         }
-        else if (strcmp(solver, "mgmres") == 0)
-        {
-            pmgmres_ilu_cr ( node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, u_now, rhs, itr_max, mr, tol_abs, tol_rel );
-        }
-        else
-        {
-            fprintf(stderr, "\n");
-            fprintf(stderr, "ACOUSTIC - Fatal error!\n");
-            fprintf(stderr, "  Solver type is not set = \"%s\".\n", solver);
-            exit(1);
-        }
-       
-        for (i = 0; i < node_num; i++)
-        {
-            energy[it] += u_now[i]*u_now[i];
-        }
-		if ((it + 1) % 10 == 0)
-		{
-			for (i = 0; i < node_num; i++)
-			{
-				fprintf(fp_u, "%f	", u_now[i]);
-			}
-			fprintf(fp_u, "\n");
-		}
-		fprintf(fp_energy, "%f\n", energy[it]);
-	}
-    
-    free(mass_coo_i);
-    free(mass_coo_j);
-    free(mass_coo_x);
-    free(stif_coo_i);
-    free(stif_coo_j);
-    free(stif_coo_x);
-    free(mass_csr_p);
-    free(mass_csr_j);
-    free(mass_csr_x);
-    free(stif_csr_p);
-    free(stif_csr_j);
-    free(stif_csr_x);
-    free(mass_csr_j_temp);
-    free(mass_csr_x_temp);
-    free(stif_csr_j_temp);
-    free(stif_csr_x_temp);
-    free(rho);
-    free(vp);
-	free(rhs);
-	free(u_old);
-	free(u_now);
-	free(y1);
-	free(y2);
-	free(y3);
-	free(energy);
-	fclose(fp_u);
-	fclose(fp_energy);
-	printf("\n Acoutsic Normal End!\n");
+
+        printf("\nTime iteration end!\n");
+        fclose(fp_wavefield_p);
+        fclose(fp_seismogram_p);
+    }
+    free(seismogram_p);
+    free(p_old);
+    free(p_now);
+    free(p_new);
+    free(source);
+    free(rhs);
+    free(y1);
 }
@@ -1,485 +1,294 @@
-#include "../solver/mgmres/mgmres.c"
+void acoustic_pml(int node_num, double **node_xy, int csr_p_size, int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x, \
+                  double **c, double *mpml_dx, double *mpml_dy, double *mpml_dxx, double *mpml_dyy,                                                  \
+                  int step, double dt,                                                                                                               \
+                  int shot_first, int shot_num, int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *wavelet, char *shot_name, \
+                  int rec_num, int *rec_node, double *rec_weight, int point_order, int *node_new, char *solver, int dirichlet_num, int *dirichlet_node)
+/******************************************************************************/
+/*
+  Purpose:
 
-void acoustic_pml(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, int nnz, int csr_p_size, int step, \
-     double dt, double f0, double t0, double edge_size, double xmin, double xmax, double ymin, double ymax, int pml_nx, int pml_ny, int source_node, char *solver)
+    acoustic_pml runs the time evolution of the acoustic wave equation with the mpml
+    absorbing boundary for every shot. It is the equation u1, u3 of elastic_wave for one
+    scalar field p = p1 + p3, with c11 = rho * vp * vp in place of c11 and c44 (the
+    coupling terms of c13 vanish), the same mpml profiles (abc_mpml), the same Newmark
+    scheme and the operator of elastic_operator:
+
+      mass * p1_tt = - c11 * dphidx * dphidx * p - 2.0 * mpml_dx * mass * p1_t
+                     - mpml_dx * mpml_dx * mass * p1 + mass * lx + Source
+      mass * p3_tt = - c11 * dphidy * dphidy * p - 2.0 * mpml_dy * mass * p3_t
+                     - mpml_dy * mpml_dy * mass * p3 + mass * ly
+      mass * lx_new = - dt * c11 * mpml_dxx * phi * dphidx * p - dt * mpml_dx * mass * lx + mass * lx
+      mass * ly_new = - dt * c11 * mpml_dyy * phi * dphidy * p - dt * mpml_dy * mass * ly + mass * ly
+
+    With the masslump solver the mass is the lumped mass on both sides and every node is
+    updated in a single parallel loop over the csr rows: the four stiffness rows are summed
+    in one pass over csr_j and the rhs, the auxiliary fields and the Newmark step follow
+    in the same pass. Only p is read across the rows, it is written to a second array.
+
+    p = 0 on the dirichlet_num nodes of dirichlet_node (the whole outer boundary, see
+    mesh_boundary_node): p1, p3 and their auxiliary fields are set to zero there after
+    every step.
+
+    The shots, sources, receivers and output files are those of acoustic.
+*/
 {
-    
-    /***************************************
-     coo(i,j,x) and csr(p,j,x) arrays
-     ****************************************/
-    int  mass_csr_size = 0; // csr size for mass : j and x
-    int stif1_csr_size = 0; // csr size for stif1: j and x
-    int stif2_csr_size = 0; // csr size for stif2: j and x
-    int stif3_csr_size = 0; // csr size for stif3: j and x
-    int stif4_csr_size = 0; // csr size for stif4: j and x
-    int *mass_coo_i = NULL;
-    int *mass_coo_j = NULL;
-    int *mass_csr_p = NULL;
-    int *mass_csr_j = NULL;
-    int *mass_csr_j_temp = NULL;
-    int *stif1_coo_i = NULL;
-    int *stif1_coo_j = NULL;
-    int *stif2_coo_i = NULL;
-    int *stif2_coo_j = NULL;
-    int *stif3_coo_i = NULL;
-    int *stif3_coo_j = NULL;
-    int *stif4_coo_i = NULL;
-    int *stif4_coo_j = NULL;
-    int *stif1_csr_p = NULL;
-    int *stif1_csr_j = NULL;
-    int *stif2_csr_p = NULL;
-    int *stif2_csr_j = NULL;
-    int *stif3_csr_p = NULL;
-    int *stif3_csr_j = NULL;
-    int *stif4_csr_p = NULL;
-    int *stif4_csr_j = NULL;
-    int *stif1_csr_j_temp = NULL;
-    int *stif2_csr_j_temp = NULL;
-    int *stif3_csr_j_temp = NULL;
-    int *stif4_csr_j_temp = NULL;
-    double *stif1_coo_x = NULL;
-    double *stif1_csr_x = NULL;
-    double *stif2_coo_x = NULL;
-    double *stif2_csr_x = NULL;
-    double *stif3_coo_x = NULL;
-    double *stif3_csr_x = NULL;
-    double *stif4_coo_x = NULL;
-    double *stif4_csr_x = NULL;
-    double *stif1_csr_x_temp = NULL;
-    double *stif2_csr_x_temp = NULL;
-    double *stif3_csr_x_temp = NULL;
-    double *stif4_csr_x_temp = NULL;
-    double *mass_coo_x = NULL;
-    double *mass_csr_x = NULL;
-    double *mass_csr_x_temp = NULL;
-    double *mass_lump = NULL;
-    
-    /***************************************
-     model density and velocity parameters
-     ****************************************/
-    double *rho = NULL;
-    double *vp = NULL;
-    
+    double *stif1_csr_x = stif_csr_x[0];
+    double *stif2_csr_x = stif_csr_x[1];
+    double *stif5_csr_x = stif_csr_x[4];
+    double *stif6_csr_x = stif_csr_x[5];
+
     /***************************************
              time evolution parameters
      ****************************************/
-	int i, it;
-	double time;
-    double vp_max;
-	double point_source;
-	double *rhs1   = NULL;
-    double *rhs2   = NULL;
-    double *rhs3   = NULL;
-    double *rhs4   = NULL;
-    double *u_now  = NULL;
-	double *u1_old = NULL;
-	double *u1_now = NULL;
-    double *u2_old = NULL;
-    double *u2_now = NULL;
-    double *p1_now = NULL;
-    double *p2_now = NULL;
-	double *y1     = NULL;
-	double *y2     = NULL;
-	double *y3     = NULL;
-    double *y4     = NULL;
-	double *energy = NULL;
-    double tol_abs = 1.0e-08; // a relative tolerance comparing the current residual to the initial residual.
-    double tol_rel = 1.0e-08; // an absolute tolerance applied to the current residual.
-    int    itr_max = 100;     // the maximum number of (outer) iterations to take.
-    int    mr      = 50;      // the maximum number of (inner) iterations to take.
-    
-    /***************************************
-     abosorbing bc, pml and mpml parameters
-     ****************************************/
-    int use_pml_xmin = 1;
-    int use_pml_xmax = 1;
-    int use_pml_ymin = 1;
-    int use_pml_ymax = 1; // use_pml_ymax = 0, free surface on ymax.
-    double *pml_dx  = NULL;
-    double *pml_dy  = NULL;
-    double *pml_dxx = NULL;
-    double *pml_dyy = NULL;
-    
+    int i, k, it, shot;
+    double time, energy;
+    double s1, s2, s5, s6, m1t, m1, mlx, m3t, m3, mly;
+    double p1tt_new, p3tt_new;
+    double *p_now = NULL, *p_new = NULL, *p_temp = NULL;
+    double *p1 = NULL, *p1t = NULL, *p1tt = NULL;
+    double *p3 = NULL, *p3t = NULL, *p3tt = NULL;
+    double *lx = NULL, *ly = NULL;
+    double *source = NULL;
+    double *rhs1 = NULL, *rhs2 = NULL, *rhs3 = NULL, *rhs4 = NULL;
+    double *p1tt_sol = NULL, *p3tt_sol = NULL;
+    double *seismogram_p = NULL;
+    double delta = 1.5, alpha = 1.0;
+    double tol_abs = 1.0e-08;   // a relative tolerance comparing the current residual to the initial residual.
+    double tol_rel = 1.0e-08;   // an absolute tolerance applied to the current residual.
+    int itr_max = 100, mr = 50; // the maximum number of outer and inner iterations to take.
     /***************************************
                   file pointers
      ****************************************/
-    FILE *fp_u, *fp_energy;
-    FILE *fp_stif_p, *fp_stif_j, *fp_stif_x;
+    FILE *fp_wavefield_p, *fp_seismogram_p;
+    char filename_wavefield_p[128], filename_seismogram_p[128];
 
-    /***************************************
-     allocate the dynamic arrays
-     ****************************************/
-    // mass lump
-    mass_lump = (double *)malloc(node_num * sizeof(double));
-    // coo (i,j,x), mass and stif matrices
-    mass_coo_i = (int *)malloc(nnz * sizeof(int));
-    mass_coo_j = (int *)malloc(nnz * sizeof(int));
-    mass_coo_x = (double *)malloc(nnz * sizeof(double));
-    stif1_coo_i = (int *)malloc(nnz * sizeof(int));
-    stif1_coo_j = (int *)malloc(nnz * sizeof(int));
-    stif2_coo_i = (int *)malloc(nnz * sizeof(int));
-    stif2_coo_j = (int *)malloc(nnz * sizeof(int));
-    stif3_coo_i = (int *)malloc(nnz * sizeof(int));
-    stif3_coo_j = (int *)malloc(nnz * sizeof(int));
-    stif4_coo_i = (int *)malloc(nnz * sizeof(int));
-    stif4_coo_j = (int *)malloc(nnz * sizeof(int));
-    stif1_coo_x = (double *)malloc(nnz * sizeof(double));
-    stif2_coo_x = (double *)malloc(nnz * sizeof(double));
-    stif3_coo_x = (double *)malloc(nnz * sizeof(double));
-    stif4_coo_x = (double *)malloc(nnz * sizeof(double));
-
-    // csr (p,j,x), mass and stif matrices
-    mass_csr_p      = (int *)malloc(csr_p_size * sizeof(int));
-    mass_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    mass_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    stif1_csr_p     = (int *)malloc(csr_p_size * sizeof(int));
-    stif2_csr_p     = (int *)malloc(csr_p_size * sizeof(int));
-    stif3_csr_p     = (int *)malloc(csr_p_size * sizeof(int));
-    stif4_csr_p     = (int *)malloc(csr_p_size * sizeof(int));
-    stif1_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    stif2_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    stif3_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    stif4_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    stif1_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    stif2_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    stif3_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    stif4_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    // model density and velocity matrices
-    rho = (double *)malloc(node_num * sizeof(double));
-    vp  = (double *)malloc(node_num * sizeof(double));
-    // pml and mpml matrices
-    pml_dx  = (double *)malloc(node_num * sizeof(double));
-    pml_dy  = (double *)malloc(node_num * sizeof(double));
-    pml_dxx = (double *)malloc(node_num * sizeof(double));
-    pml_dyy = (double *)malloc(node_num * sizeof(double));
-    // time evolution
-    energy = (double *)malloc(step * sizeof(double));
-    u_now  = (double *)malloc(node_num * sizeof(double));
-    u1_old = (double *)malloc(node_num * sizeof(double));
-    u1_now = (double *)malloc(node_num * sizeof(double));
-    u2_old = (double *)malloc(node_num * sizeof(double));
-    u2_now = (double *)malloc(node_num * sizeof(double));
-    p1_now = (double *)malloc(node_num * sizeof(double));
-    p2_now = (double *)malloc(node_num * sizeof(double));
-    y1     = (double *)malloc(node_num * sizeof(double));
-    y2     = (double *)malloc(node_num * sizeof(double));
-    y3     = (double *)malloc(node_num * sizeof(double));
-    y4     = (double *)malloc(node_num * sizeof(double));
-    rhs1   = (double *)malloc(node_num * sizeof(double));
-    rhs2   = (double *)malloc(node_num * sizeof(double));
-    rhs3   = (double *)malloc(node_num * sizeof(double));
-    rhs4   = (double *)malloc(node_num * sizeof(double));
-
-    
-    acoustic_model(node_num, element_num, element_order, element_node, node_xy, rho, vp);
-    vp_max = vp[0];
-    for( i = 0; i < node_num; i++ )
+    seismogram_p = (double *)malloc(rec_num * sizeof(double));
+    p_now = (double *)malloc(node_num * sizeof(double));
+    p_new = (double *)malloc(node_num * sizeof(double));
+    p1 = (double *)malloc(node_num * sizeof(double));
+    p1t = (double *)malloc(node_num * sizeof(double));
+    p1tt = (double *)malloc(node_num * sizeof(double));
+    p3 = (double *)malloc(node_num * sizeof(double));
+    p3t = (double *)malloc(node_num * sizeof(double));
+    p3tt = (double *)malloc(node_num * sizeof(double));
+    lx = (double *)malloc(node_num * sizeof(double));
+    ly = (double *)malloc(node_num * sizeof(double));
+    source = (double *)calloc(node_num, sizeof(double));
+    if (strcmp(solver, "masslump") != 0)
     {
-        if(vp[i] > vp_max) vp_max = vp[i];
+        rhs1 = (double *)malloc(node_num * sizeof(double));
+        rhs2 = (double *)malloc(node_num * sizeof(double));
+        rhs3 = (double *)malloc(node_num * sizeof(double));
+        rhs4 = (double *)malloc(node_num * sizeof(double));
+        p1tt_sol = (double *)calloc(node_num, sizeof(double));
+        p3tt_sol = (double *)calloc(node_num, sizeof(double));
     }
-    absorbing_boundary_pml(node_num, element_num, element_order, element_node, node_xy, pml_nx, pml_ny, edge_size, xmin, xmax, ymin, ymax, vp_max,
-                           use_pml_xmin, use_pml_xmax, use_pml_ymin, use_pml_ymax, pml_dx, pml_dy, pml_dxx, pml_dyy);
-    // get lump mass matrix
-    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, mass_coo_i, mass_coo_j, mass_coo_x, 1);
-    for (i = 0; i < node_num; i++)  mass_lump[i] = mass_coo_x[i];
-    // get mass and stif matrices in coo format
-    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy,  mass_coo_i,  mass_coo_j,  mass_coo_x, 0);
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif1_coo_i, stif1_coo_j, stif1_coo_x, 1); // dphidx * dphidx
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif2_coo_i, stif2_coo_j, stif2_coo_x, 5); //    phi * dphidx
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif3_coo_i, stif3_coo_j, stif3_coo_x, 2); // dphidy * dphidy
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif4_coo_i, stif4_coo_j, stif4_coo_x, 6); //    phi * dphidy
 
-    // call fortran subroutines to convert coo to csr. Attention: mi, mj, mass, Mp_temp, Mj_temp, Mass_temp are addresses,
-    // do not need use & to get the address of the pointers.
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size,  &mass_csr_size,  mass_coo_i,  mass_coo_j,  mass_coo_x,  mass_csr_p,  mass_csr_j_temp,  mass_csr_x_temp);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif1_csr_size, stif1_coo_i, stif1_coo_j, stif1_coo_x, stif1_csr_p, stif1_csr_j_temp, stif1_csr_x_temp);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif2_csr_size, stif2_coo_i, stif2_coo_j, stif2_coo_x, stif2_csr_p, stif2_csr_j_temp, stif2_csr_x_temp);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif3_csr_size, stif3_coo_i, stif3_coo_j, stif3_coo_x, stif3_csr_p, stif3_csr_j_temp, stif3_csr_x_temp);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif4_csr_size, stif4_coo_i, stif4_coo_j, stif4_coo_x, stif4_csr_p, stif4_csr_j_temp, stif4_csr_x_temp);
-
-    // allocate the real size mass and stif csr matrices
-    mass_csr_j  = (int *)malloc(mass_csr_size * sizeof(int));
-    mass_csr_x  = (double *)malloc(mass_csr_size * sizeof(double));
-    stif1_csr_j = (int *)malloc(stif1_csr_size * sizeof(int));
-    stif2_csr_j = (int *)malloc(stif2_csr_size * sizeof(int));
-    stif3_csr_j = (int *)malloc(stif3_csr_size * sizeof(int));
-    stif4_csr_j = (int *)malloc(stif4_csr_size * sizeof(int));
-    stif1_csr_x = (double *)malloc(stif1_csr_size * sizeof(double));
-    stif2_csr_x = (double *)malloc(stif2_csr_size * sizeof(double));
-    stif3_csr_x = (double *)malloc(stif3_csr_size * sizeof(double));
-    stif4_csr_x = (double *)malloc(stif4_csr_size * sizeof(double));
-
-    for (i = 0; i < mass_csr_size; i++)
-    {
-        mass_csr_j[i] = mass_csr_j_temp[i];
-        mass_csr_x[i] = mass_csr_x_temp[i];
-    }
-    for (i = 0; i < stif1_csr_size; i++)
-    {
-        stif1_csr_j[i] = stif1_csr_j_temp[i];
-        stif1_csr_x[i] = stif1_csr_x_temp[i];
-    }
-    for (i = 0; i < stif2_csr_size; i++)
-    {
-        stif2_csr_j[i] = stif2_csr_j_temp[i];
-        stif2_csr_x[i] = stif2_csr_x_temp[i];
-    }
-    for (i = 0; i < stif3_csr_size; i++)
+    for (shot = shot_first; shot < shot_num; shot++)
     {
-        stif3_csr_j[i] = stif3_csr_j_temp[i];
-        stif3_csr_x[i] = stif3_csr_x_temp[i];
-    }
-    for (i = 0; i < stif4_csr_size; i++)
-    {
-        stif4_csr_j[i] = stif4_csr_j_temp[i];
-        stif4_csr_x[i] = stif4_csr_x_temp[i];
-    }
-
-    fp_u      = fopen("u.dat", "w");
-	fp_energy = fopen("energy.dat", "w");
-	fp_stif_p = fopen("stif_p.dat", "w");
-	fp_stif_j = fopen("stif_j.dat", "w");
-    fp_stif_x = fopen("stif_x.dat", "w");
-
-
-    for(i=0;i<csr_p_size;i++)
-    {
-        fprintf(fp_stif_p,"%d\n",stif4_csr_p[i]);
-    }
-    for(i=0;i<stif4_csr_size;i++)
-    {
-        fprintf(fp_stif_j,"%d\n",stif4_csr_j[i]);
-        fprintf(fp_stif_x,"%f\n",stif4_csr_x[i]);
-    }
-
-	// write first two step values: u_old[node_num], u_now[node_num], energy[0], energy[1]
-	 for (i = 0; i < node_num; i++)
-	{
-		u1_old[i] = 0.0;
-        u2_old[i] = 0.0;
-		u1_now[i] = 0.0;
-        u2_now[i] = 0.0;
-        p1_now[i] = 0.0;
-        p2_now[i] = 0.0;
-        u_now[i]  = 0.0;
-		fprintf(fp_u, "%f	", u_now[i]);
-	}
-	fprintf(fp_u, "\n");
+        printf("\n ######## Shot num: %d ########\n", shot + 1);
 
-	energy[0] = 0.0;
-	energy[1] = 0.0;
-	fprintf(fp_energy, "%f\n", energy[0]);
-	fprintf(fp_energy, "%f\n", energy[1]);
+        sprintf(filename_wavefield_p, "./outputfile/wavefield_p_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_p, "./outputfile/seismogram_p_%s_%d.txt", shot_name, shot + 1);
+        fp_wavefield_p = fopen(filename_wavefield_p, "w");
+        fp_seismogram_p = fopen(filename_seismogram_p, "w");
 
-	// begin iteration: from 0 to step-1, time = (step + 1) * dt,  with total iteration number = step
-	// give u(0) ans u(1)
-    printf("\nTime iteration begin:\n");
-	for (it = 2; it < step; it++)
-	{
-        time = (it + 1) * dt;
-        if ((it + 1) % 100 == 0) printf("\n Iteration step: %-d, time: %-f\n ", it + 1, time);
-		energy[it] = 0.0;
-        point_source = seismic_source(f0, t0, 1.0, time);
-        for (i = 0; i < node_num; i++)
-        {
-            rhs1[i] = 0.0; rhs2[i] = 0.0; rhs3[i] = 0.0; rhs4[i] = 0.0;
-        }
-        
-        // equation 1:
-        // mass * u1_new = 2*mass*u1_now - mass*u1_old - 2*dt*pml_dx*mass*u1_now + 2*dt*pml_dx*mass*u1_old
-        //               - dt*dt*pml_dx*pml_dx*mass*u1_now + vp*vp*dt*dt*stif1*u_now + vp*vp*dt*dt*mass*p1_now
-        // stif1: dphidx * dphidx
-		for (i = 0; i < node_num; i++)
-		{
-			y1[i] = 0.0; y2[i] = 0.0; y3[i] = 0.0; y4[i] = 0.0;
-		}
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, u1_now, y1); // mass  * u1_now
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, u1_old, y2); // mass  * u1_old
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, p1_now, y3); // mass  * p1_now
-		csr_matvec(csr_p_size, stif1_csr_p, stif1_csr_j, stif1_csr_x,  u_now, y4); // stif1 *  u_now
-        for (i = 0; i < node_num; i++)
-        {
-            rhs1[i]  =  2.0 * y1[i] - y2[i] - 2.0 * dt * pml_dx[i] * y1[i] + 2 * dt * pml_dx[i] * y2[i]  \
-                     -  dt * dt * pml_dx[i] * pml_dx[i] * y1[i] + vp[i] * vp[i] * dt * dt * y4[i] + vp[i] * vp[i] * dt * dt * y3[i]  \
-                     +  (i == source_node) * point_source ;
-        }
-       
-        // equation 2
-        // mass * p1_new = mass*p1_now - dt*pml_dx*mass*p1_now - dt*pml_dxx*stif2*u_now
-        // stif2: phi * dphidx
-        for (i = 0; i < node_num; i++)
-        {
-            y1[i] = 0.0; y2[i] = 0.0; 
-        }
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, p1_now, y1); // mass  * p1_now
-        csr_matvec(csr_p_size, stif2_csr_p, stif2_csr_j, stif2_csr_x,  u_now, y2); // stif2 *  u_now
-        for (i = 0; i < node_num; i++)
-        {
-            rhs2[i]  =  y1[i] - dt * pml_dx[i] * y1[i] - dt * pml_dxx[i] * y2[i];
-        }
-        
-        // equation 3:
-        // mass * u2_new = 2*mass*u2_now - mass*u2_old - 2*dt*pml_dy*mass*u2_now + 2*dt*pml_dy*mass*u2_old
-        //               - dt*dt*pml_dy*pml_dy*mass*u2_now + vp*vp*dt*dt*stif3*u_now + vp*vp*dt*dt*mass*p2_now
-        // stif3: dphidy * dphidy
-        for (i = 0; i < node_num; i++)
-        {
-            y1[i] = 0.0; y2[i] = 0.0; y3[i] = 0.0; y4[i] = 0.0;
-        }
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, u2_now, y1); // mass  * u2_now
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, u2_old, y2); // mass  * u2_old
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, p2_now, y3); // mass  * p2_now
-        csr_matvec(csr_p_size, stif3_csr_p, stif3_csr_j, stif3_csr_x,  u_now, y4); // stif3 *  u_now
-        for (i = 0; i < node_num; i++)
-        {
-            rhs3[i]  =  2.0 * y1[i] - y2[i] - 2.0 * dt * pml_dy[i] * y1[i] + 2 * dt * pml_dy[i] * y2[i]  \
-                     -  dt * dt * pml_dy[i] * pml_dy[i] * y1[i] + vp[i] * vp[i] * dt * dt * y4[i] + vp[i] * vp[i] * dt * dt * y3[i];
-        }
-        
-        // equation 4
-        // mass * p2_new = mass*p2_now - dt*pml_dy*mass*p2_now - dt*pml_dyy*stif4*u_now
-        // stif4: phi * dphidy
-        for (i = 0; i < node_num; i++)
-        {
-            y1[i] = 0.0; y2[i] = 0.0; 
-        }
-        csr_matvec(csr_p_size,  mass_csr_p,  mass_csr_j,  mass_csr_x, p2_now, y1); // mass  * p2_now
-        csr_matvec(csr_p_size, stif4_csr_p, stif4_csr_j, stif4_csr_x,  u_now, y2); // stif4 *  u_now
+        #pragma omp parallel for private(i)
         for (i = 0; i < node_num; i++)
         {
-            rhs4[i]  =  y1[i] - dt * pml_dy[i] * y1[i] - dt * pml_dyy[i] * y2[i];
+            p_now[i] = 0.0;
+            p1[i] = 0.0;
+            p1t[i] = 0.0;
+            p1tt[i] = 0.0;
+            p3[i] = 0.0;
+            p3t[i] = 0.0;
+            p3tt[i] = 0.0;
+            lx[i] = 0.0;
+            ly[i] = 0.0;
         }
-  
         for (i = 0; i < node_num; i++)
+            fprintf(fp_wavefield_p, "%f	", p_now[i]);
+        fprintf(fp_wavefield_p, "\n");
+
+        // begin iteration: from 0 to step-1, time = (step + 1) * dt
+        printf("\n****Time iteration begin:\n");
+        for (it = 2; it < step; it++)
         {
-            u1_old[i] = u1_now[i];
-            u2_old[i] = u2_now[i];
-        }
-        
-        // here can use openmp
-        if( strcmp(solver, "masslump") == 0 )
-        {
-            for (i = 0; i < node_num; i++)
+            time = (it + 1) * dt;
+            if ((it + 1) % 100 == 0)
+                printf("\n ****Iteration step: %-d, time: %-f s\n ", it + 1, time);
+
+            // Source, sparse: only the nodes in the injection list of the shot
+            for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+                source[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it];
+
+            energy = 0.0;
+            if (strcmp(solver, "masslump") == 0)
             {
-                if (mass_lump[i] != 0.0)
+                // stif * p_now, rhs, auxiliary fields and Newmark step of a node in one pass
+                #pragma omp parallel for private(k, s1, s2, s5, s6, p1tt_new, p3tt_new) reduction(+ : energy)
+                for (i = 0; i < node_num; i++)
                 {
-                    u1_now[i] = rhs1[i] / (1.0 * mass_lump[i]);
-                    p1_now[i] = rhs2[i] / (1.0 * mass_lump[i]);
-                    u2_now[i] = rhs3[i] / (1.0 * mass_lump[i]);
-                    p2_now[i] = rhs4[i] / (1.0 * mass_lump[i]);
+                    s1 = 0.0;
+                    s2 = 0.0;
+                    s5 = 0.0;
+                    s6 = 0.0;
+                    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+                    {
+                        s1 += stif1_csr_x[k] * p_now[csr_j[k]];
+                        s2 += stif2_csr_x[k] * p_now[csr_j[k]];
+                        s5 += stif5_csr_x[k] * p_now[csr_j[k]];
+                        s6 += stif6_csr_x[k] * p_now[csr_j[k]];
+                    }
+                    p1tt_new = (source[i] - c[0][i] * s1) / mass_lump[i] - 2.0 * mpml_dx[i] * p1t[i] - mpml_dx[i] * mpml_dx[i] * p1[i] + lx[i];
+                    p3tt_new = -c[0][i] * s2 / mass_lump[i] - 2.0 * mpml_dy[i] * p3t[i] - mpml_dy[i] * mpml_dy[i] * p3[i] + ly[i];
+                    lx[i] = lx[i] - dt * mpml_dx[i] * lx[i] - dt * c[0][i] * mpml_dxx[i] * s5 / mass_lump[i];
+                    ly[i] = ly[i] - dt * mpml_dy[i] * ly[i] - dt * c[0][i] * mpml_dyy[i] * s6 / mass_lump[i];
+                    source[i] = 0.0;
+                    p1[i] = p1[i] + p1t[i] * dt + ((0.5 - alpha) * p1tt[i] + alpha * p1tt_new) * dt * dt;
+                    p3[i] = p3[i] + p3t[i] * dt + ((0.5 - alpha) * p3tt[i] + alpha * p3tt_new) * dt * dt;
+                    p1t[i] = p1t[i] + ((1 - delta) * p1tt[i] + delta * p1tt_new) * dt;
+                    p3t[i] = p3t[i] + ((1 - delta) * p3tt[i] + delta * p3tt_new) * dt;
+                    p1tt[i] = p1tt_new;
+                    p3tt[i] = p3tt_new;
+                    p_new[i] = p1[i] + p3[i];
+                    energy += p_new[i] * p_new[i];
                 }
-                else  printf("Fatal Error: zero value in the mass_csr_lumped"); // in case zero value
             }
-        }
-        else if (strcmp(solver, "mgmres") == 0)
-        {
-            pmgmres_ilu_cr ( node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, u1_now, rhs1, itr_max, mr, tol_abs, tol_rel );
-            pmgmres_ilu_cr ( node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, p1_now, rhs2, itr_max, mr, tol_abs, tol_rel );
-            pmgmres_ilu_cr ( node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, u2_now, rhs3, itr_max, mr, tol_abs, tol_rel );
-            pmgmres_ilu_cr ( node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, p2_now, rhs4, itr_max, mr, tol_abs, tol_rel );
-        }
-        else
-        {
-            fprintf(stderr, "\n");
-            fprintf(stderr, "ACOUSTIC_PML - Fatal error!\n");
-            fprintf(stderr, "  Solver type is not set = \"%s\".\n", solver);
-            exit(1);
-        }
-       
-        for (i = 0; i < node_num; i++)
-        {
-            u_now[i] = u1_now[i] + u2_now[i];
-            energy[it] += u_now[i]*u_now[i];
-            if( energy[it] > 10e6)
+            else
+            {
+                // rhs of the four equations, the stiffness and mass rows in one pass
+                #pragma omp parallel for private(k, s1, s2, s5, s6, m1t, m1, mlx, m3t, m3, mly)
+                for (i = 0; i < node_num; i++)
+                {
+                    s1 = 0.0;
+                    s2 = 0.0;
+                    s5 = 0.0;
+                    s6 = 0.0;
+                    m1t = 0.0;
+                    m1 = 0.0;
+                    mlx = 0.0;
+                    m3t = 0.0;
+                    m3 = 0.0;
+                    mly = 0.0;
+                    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+                    {
+                        s1 += stif1_csr_x[k] * p_now[csr_j[k]];
+                        s2 += stif2_csr_x[k] * p_now[csr_j[k]];
+                        s5 += stif5_csr_x[k] * p_now[csr_j[k]];
+                        s6 += stif6_csr_x[k] * p_now[csr_j[k]];
+                        m1t += mass_csr_x[k] * p1t[csr_j[k]];
+                        m1 += mass_csr_x[k] * p1[csr_j[k]];
+                        mlx += mass_csr_x[k] * lx[csr_j[k]];
+                        m3t += mass_csr_x[k] * p3t[csr_j[k]];
+                        m3 += mass_csr_x[k] * p3[csr_j[k]];
+                        mly += mass_csr_x[k] * ly[csr_j[k]];
+                    }
+                    rhs1[i] = source[i] - c[0][i] * s1 - 2.0 * mpml_dx[i] * m1t - mpml_dx[i] * mpml_dx[i] * m1 + mlx;
+                    rhs2[i] = -dt * c[0][i] * mpml_dxx[i] * s5 - dt * mpml_dx[i] * mlx + mlx;
+                    rhs3[i] = -c[0][i] * s2 - 2.0 * mpml_dy[i] * m3t - mpml_dy[i] * mpml_dy[i] * m3 + mly;
+                    rhs4[i] = -dt * c[0][i] * mpml_dyy[i] * s6 - dt * mpml_dy[i] * mly + mly;
+                    source[i] = 0.0;
+                }
+                if (strcmp(solver, "pardiso") == 0)
+                {
+                    pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs1, p1tt_sol);
+                    pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs2, lx);
+                    pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs3, p3tt_sol);
+                    pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs4, ly);
+                }
+                else if (strcmp(solver, "mgmres") == 0)
+                {
+                    pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, p1tt_sol, rhs1, itr_max, mr, tol_abs, tol_rel);
+                    pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, lx, rhs2, itr_max, mr, tol_abs, tol_rel);
+                    pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, p3tt_sol, rhs3, itr_max, mr, tol_abs, tol_rel);
+                    pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, ly, rhs4, itr_max, mr, tol_abs, tol_rel);
+                }
+                else
+                {
+                    fprintf(stderr, "\n");
+                    fprintf(stderr, "ACOUSTIC_PML - Fatal error!\n");
+                    fprintf(stderr, "  Solver type is not set = \"%s\".\n", solver);
+                    exit(1);
+                }
+                #pragma omp parallel for private(p1tt_new, p3tt_new) reduction(+ : energy)
+                for (i = 0; i < node_num; i++)
+                {
+                    p1tt_new = p1tt_sol[i];
+                    p3tt_new = p3tt_sol[i];
+                    p1[i] = p1[i] + p1t[i] * dt + ((0.5 - alpha) * p1tt[i] + alpha * p1tt_new) * dt * dt;
+                    p3[i] = p3[i] + p3t[i] * dt + ((0.5 - alpha) * p3tt[i] + alpha * p3tt_new) * dt * dt;
+                    p1t[i] = p1t[i] + ((1 - delta) * p1tt[i] + delta * p1tt_new) * dt;
+                    p3t[i] = p3t[i] + ((1 - delta) * p3tt[i] + delta * p3tt_new) * dt;
+                    p1tt[i] = p1tt_new;
+                    p3tt[i] = p3tt_new;
+                    p_new[i] = p1[i] + p3[i];
+                    energy += p_new[i] * p_new[i];
+                }
+            }
+            // boundary condition: zero on the Dirichlet list only
+            #pragma omp parallel for private(i)
+            for (k = 0; k < dirichlet_num; k++)
+            {
+                i = dirichlet_node[k];
+                p1[i] = 0.0;
+                p1t[i] = 0.0;
+                p1tt[i] = 0.0;
+                p3[i] = 0.0;
+                p3t[i] = 0.0;
+                p3tt[i] = 0.0;
+                lx[i] = 0.0;
+                ly[i] = 0.0;
+                p_new[i] = 0.0;
+            }
+            if (energy > 10e6)
             {
                 fprintf(stderr, "\n");
                 fprintf(stderr, "ACOUSTIC_PML - Fatal error!\n");
                 fprintf(stderr, "Energy exceeds maximum value!\n");
                 exit(1);
             }
-        }
-		if ((it + 1) % 20 == 0)
-		{
-			for (i = 0; i < node_num; i++)
-			{
-				fprintf(fp_u, "%f	", u_now[i]);
-			}
-			fprintf(fp_u, "\n");
-		}
-		fprintf(fp_energy, "%f\n", energy[it]);
-	}
-  
-    printf("\nTime iteration end!\n");
-    free(mass_lump);
-    free(mass_coo_i);
-    free(mass_coo_j);
-    free(mass_coo_x);
-    free(stif1_coo_i);
-    free(stif1_coo_j);
-    free(stif1_coo_x);
-    free(stif2_coo_i);
-    free(stif2_coo_j);
-    free(stif2_coo_x);
-    free(stif3_coo_i);
-    free(stif3_coo_j);
-    free(stif3_coo_x);
-    free(stif4_coo_i);
-    free(stif4_coo_j);
-    free(stif4_coo_x);
-    free(mass_csr_p);
-    free(mass_csr_j);
-    free(mass_csr_x);
-    free(stif1_csr_p);
-    free(stif1_csr_j);
-    free(stif1_csr_x);
-    free(stif2_csr_p);
-    free(stif2_csr_j);
-    free(stif2_csr_x);
-    free(stif3_csr_p);
-    free(stif3_csr_j);
-    free(stif3_csr_x);
-    free(stif4_csr_p);
-    free(stif4_csr_j);
-    free(stif4_csr_x);
-    free(mass_csr_j_temp);
-    free(mass_csr_x_temp);
-    free(stif1_csr_j_temp);
-    free(stif1_csr_x_temp);
-    free(stif2_csr_j_temp);
-    free(stif2_csr_x_temp);
-    free(stif3_csr_j_temp);
-    free(stif3_csr_x_temp);
-    free(stif4_csr_j_temp);
-    free(stif4_csr_x_temp);
-    free(rho);
-    free(vp);
-    free(pml_dx);
-    free(pml_dy);
-    free(pml_dxx);
-    free(pml_dyy);
-    free(energy);
-    free(u_now);
-	free(u1_old);
-	free(u2_old);
-	free(u1_now);
-	free(u2_now);
-	free(p1_now);
-	free(p2_now);
-	free(y1);
-	free(y2);
-	free(y3);
-    free(y4);
-	free(rhs1);
-    free(rhs2);
-	free(rhs3);
-	free(rhs4);
+            p_temp = p_now;
+            p_now = p_new;
+            p_new = p_temp;
 
-	fclose(fp_u);
-	fclose(fp_energy);
-	fclose(fp_stif_p);
-    fclose(fp_stif_j);
-	fclose(fp_stif_x);
+            for (i = 0; i < rec_num; i++)
+            {
+                seismogram_p[i] = 0.0;
+                for (k = 0; k < point_order; k++)
+                    seismogram_p[i] += rec_weight[i * point_order + k] * p_now[rec_node[i * point_order + k]];
+                fprintf(fp_seismogram_p, "%f   ", seismogram_p[i]);
+            }
+            fprintf(fp_seismogram_p, "\n");
 
+            if ((it + 1) % 200 == 0)
+            {
+                for (i = 0; i < node_num; i++)
+                    fprintf(fp_wavefield_p, "%f	", p_now[node_new[i]]);
+                fprintf(fp_wavefield_p, "\n");
+            }
+        }
 
-	printf("\n Acoutsic Normal End!\n");
+        printf("\nTime iteration end!\n");
+        fclose(fp_wavefield_p);
+        fclose(fp_seismogram_p);
+    }
+    free(seismogram_p);
+    free(p_now);
+    free(p_new);
+    free(p1);
+    free(p1t);
+    free(p1tt);
+    free(p3);
+    free(p3t);
+    free(p3tt);
+    free(lx);
+    free(ly);
+    free(source);
+    free(rhs1);
+    free(rhs2);
+    free(rhs3);
+    free(rhs4);
+    free(p1tt_sol);
+    free(p3tt_sol);
 }
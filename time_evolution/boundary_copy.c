@@ -0,0 +1,40 @@
+void boundary_copy(int restore, int state, int value_num, double *value, double *memory, FILE *fp_boundary)
+/******************************************************************************/
+/*
+  Purpose:
+
+    boundary_copy stores (restore = 0) or loads (restore = 1) the value_num values of time
+    step state in the boundary stream of elastic_wave_reverse, the steps one after the
+    other: in memory, or with memory NULL in the open binary file fp_boundary.
+*/
+{
+  size_t i, offset;
+
+  if (value_num == 0)
+    return;
+  offset = (size_t)state * value_num;
+  if (memory != NULL)
+  {
+    for (i = 0; i < (size_t)value_num; i++)
+    {
+      if (restore == 1)
+        value[i] = memory[offset + i];
+      else
+        memory[offset + i] = value[i];
+    }
+    return;
+  }
+
+  fseek(fp_boundary, (long)(offset * sizeof(double)), SEEK_SET);
+  if (restore == 1)
+    i = fread(value, sizeof(double), value_num, fp_boundary);
+  else
+    i = fwrite(value, sizeof(double), value_num, fp_boundary);
+  if (i != (size_t)value_num)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "BOUNDARY_COPY - Fatal error!\n");
+    fprintf(stderr, "  The boundary file of step %d is not complete.\n", state);
+    exit(1);
+  }
+}
@@ -0,0 +1,61 @@
+void checkpoint_copy(int restore, int slot, int array_num, int *array_size, double **array, double *memory)
+/******************************************************************************/
+/*
+  Purpose:
+
+    checkpoint_copy stores (restore = 0) or loads (restore = 1) the state of a time loop,
+    the array_num arrays array[k] of array_size[k] values, in checkpoint slot. The slots are
+    in memory, one after the other with the size of the state, or with memory NULL in the
+    files ./outputfile/checkpoint_<slot>.bin, written over by the next state of the slot.
+*/
+{
+  int k;
+  size_t i, offset;
+  char filename[128];
+  FILE *fp_checkpoint;
+
+  if (memory != NULL)
+  {
+    offset = 0;
+    for (k = 0; k < array_num; k++)
+      offset += array_size[k];
+    offset *= slot;
+    for (k = 0; k < array_num; k++)
+    {
+      #pragma omp parallel for
+      for (i = 0; i < (size_t)array_size[k]; i++)
+      {
+        if (restore == 1)
+          array[k][i] = memory[offset + i];
+        else
+          memory[offset + i] = array[k][i];
+      }
+      offset += array_size[k];
+    }
+    return;
+  }
+
+  sprintf(filename, "./outputfile/checkpoint_%d.bin", slot);
+  if ((fp_checkpoint = fopen(filename, (restore == 1) ? "rb" : "wb")) == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "CHECKPOINT_COPY - Fatal error!\n");
+    fprintf(stderr, "  Could not open the checkpoint file \"%s\".\n", filename);
+    exit(1);
+  }
+  for (k = 0; k < array_num; k++)
+  {
+    if (restore == 1)
+      i = fread(array[k], sizeof(double), array_size[k], fp_checkpoint);
+    else
+      i = fwrite(array[k], sizeof(double), array_size[k], fp_checkpoint);
+    if (i != (size_t)array_size[k])
+    {
+      fprintf(stderr, "\n");
+      fprintf(stderr, "CHECKPOINT_COPY - Fatal error!\n");
+      fprintf(stderr, "  The checkpoint file \"%s\" is not complete.\n", filename);
+      exit(1);
+    }
+  }
+  fclose(fp_checkpoint);
+}
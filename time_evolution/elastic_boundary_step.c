@@ -0,0 +1,115 @@
+void elastic_boundary_step(int node_num, int *csr_p, int *csr_j, double *mass_lump, double **stif_csr_x, double **c, int *ring_index, double *ring_value,
+                           double dt, double **field, double **work, double *source_u, double *source_w, int dirichlet_num, int *dirichlet_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_boundary_step is one time step of elastic_cpml_step backward, with the lumped mass.
+    The Newmark update of elastic_cpml_step (alpha = 1 on the lagged Utt, delta = 1.5) is for U
+    and W the central difference
+
+      U(n+1) = 2 U(n) - U(n-1) + dt^2 Utt(n+1),  Utt(n+1) = (rhs of U(n) + source) / mass_lump
+
+    which is run backward where it does not go through the c-pml memory variables: on the
+    nodes with pml_index < 0 (see elastic_cpml_step) whose csr neighbours are all such nodes,
+    ring_index[i] = -1. The nodes next to the pml, ring_index[i] = 0, 1, ..., take U and W from
+    ring_value (u, w of each node) as saved on the way forward, the pml nodes
+    (ring_index[i] = -2) and the Dirichlet list are set to zero.
+
+    field[6] = U, Ut, Utt, W, Wt, Wtt at step n + 1 and work[0], work[1] = U, W at step n, as
+    elastic_cpml_step leaves them, go to field = step n, work = step n - 1, with ring_value of
+    step n - 1 and source_u, source_w of the forward step from n - 1 (zeroed on the way). Ut and
+    Wt are left as they are, Utt and Wtt are set inside the ring only.
+*/
+{
+  double *stif1_csr_x = stif_csr_x[0];
+  double *stif2_csr_x = stif_csr_x[1];
+  double *stif3_csr_x = stif_csr_x[2];
+  double *stif4_csr_x = stif_csr_x[3];
+  double *U_next = field[0], *Utt = field[2];
+  double *W_next = field[3], *Wtt = field[5];
+  double *U_now = work[0], *W_now = work[1];
+
+  int i, k, r;
+  double s1u, s2u, s3u, s4u, s1w, s2w, s3w, s4w;
+  double a_u, b_u, c_u, a_w, b_w, c_w;
+
+  // step n - 1 in the place of step n + 1
+  #pragma omp parallel for private(r)
+  for (i = 0; i < node_num; i++)
+  {
+    r = ring_index[i];
+    if (r == -1)
+    {
+      U_next[i] = 2.0 * U_now[i] - U_next[i] + Utt[i] * dt * dt;
+      W_next[i] = 2.0 * W_now[i] - W_next[i] + Wtt[i] * dt * dt;
+    }
+    else if (r >= 0)
+    {
+      U_next[i] = ring_value[2 * r];
+      W_next[i] = ring_value[2 * r + 1];
+    }
+    else
+    {
+      U_next[i] = 0.0;
+      W_next[i] = 0.0;
+    }
+  }
+  for (k = 0; k < dirichlet_num; k++)
+  {
+    U_next[dirichlet_node[k]] = 0.0;
+    W_next[dirichlet_node[k]] = 0.0;
+  }
+
+  // Utt and Wtt of step n from step n - 1
+  #pragma omp parallel for private(k, s1u, s2u, s3u, s4u, s1w, s2w, s3w, s4w, a_u, b_u, c_u, a_w, b_w, c_w)
+  for (i = 0; i < node_num; i++)
+  {
+    if (ring_index[i] != -1)
+    {
+      Utt[i] = 0.0;
+      Wtt[i] = 0.0;
+      source_u[i] = 0.0;
+      source_w[i] = 0.0;
+      continue;
+    }
+    s1u = 0.0;
+    s2u = 0.0;
+    s3u = 0.0;
+    s4u = 0.0;
+    s1w = 0.0;
+    s2w = 0.0;
+    s3w = 0.0;
+    s4w = 0.0;
+    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+    {
+      s1u += stif1_csr_x[k] * U_next[csr_j[k]];
+      s2u += stif2_csr_x[k] * U_next[csr_j[k]];
+      s3u += stif3_csr_x[k] * U_next[csr_j[k]];
+      s4u += stif4_csr_x[k] * U_next[csr_j[k]];
+      s1w += stif1_csr_x[k] * W_next[csr_j[k]];
+      s2w += stif2_csr_x[k] * W_next[csr_j[k]];
+      s3w += stif3_csr_x[k] * W_next[csr_j[k]];
+      s4w += stif4_csr_x[k] * W_next[csr_j[k]];
+    }
+    a_u = -c[0][i] * s1u;
+    b_u = -c[3][i] * s2u;
+    c_u = -c[1][i] * s3w - c[3][i] * s4w;
+    a_w = -c[3][i] * s1w;
+    b_w = -c[2][i] * s2w;
+    c_w = -c[3][i] * s3u - c[1][i] * s4u;
+    Utt[i] = (a_u + b_u + c_u + source_u[i]) / mass_lump[i];
+    Wtt[i] = (a_w + b_w + c_w + source_w[i]) / mass_lump[i];
+    source_u[i] = 0.0;
+    source_w[i] = 0.0;
+  }
+  for (k = 0; k < dirichlet_num; k++)
+  {
+    Utt[dirichlet_node[k]] = 0.0;
+    Wtt[dirichlet_node[k]] = 0.0;
+  }
+  field[0] = U_now;
+  field[3] = W_now;
+  work[0] = U_next;
+  work[1] = W_next;
+}
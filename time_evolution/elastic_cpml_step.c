@@ -0,0 +1,204 @@
+void elastic_cpml_step(int node_num, int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x, double **c,
+                       double *cpml_ax, double *cpml_bx, double *cpml_ay, double *cpml_by, int *pml_index, double **psi, double dt, int transpose,
+                       double **field, double **work, double *source_u, double *source_w, char *solver, int dirichlet_num, int *dirichlet_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_cpml_step is one time step of elastic_wave_cpml: the stiffness terms of U and W,
+    stretched by the recursive convolutions psi of the pml nodes (pml_index[i] >= 0, psi[12]
+    over those nodes), plus source_u and source_w, give Utt and Wtt and the Newmark update,
+    then the Dirichlet list is set to zero. source_u and source_w are zeroed on the way.
+
+    field[6] = U, Ut, Utt, W, Wt, Wtt is the state of the wave, with psi all that a time step
+    needs: a copy of both is a checkpoint (see elastic_wave_reverse). work[6] = U_new, W_new,
+    and rhs_u, rhs_w, Utt, Wtt of the consistent mass solvers (NULL with masslump). U and W
+    are written to U_new and W_new, the pointers are then swapped with field[0] and field[3].
+
+    With transpose = 1 the stiffness terms are those of the transposed operator, c at the
+    column node (K (c u) instead of c (K u); stif1, stif2 are symmetric and stif4 is stif3
+    transposed), for the adjoint wave of elastic_wave_reverse.
+*/
+{
+    double *stif1_csr_x = stif_csr_x[0];
+    double *stif2_csr_x = stif_csr_x[1];
+    double *stif3_csr_x = stif_csr_x[2];
+    double *stif4_csr_x = stif_csr_x[3];
+    double *U_now = field[0], *Ut = field[1], *Utt = field[2];
+    double *W_now = field[3], *Wt = field[4], *Wtt = field[5];
+    double *U_new = work[0], *W_new = work[1];
+    double *rhs_u1 = work[2], *rhs_w1 = work[3], *Utt_sol = work[4], *Wtt_sol = work[5];
+
+    int i, j, k, pml;
+    double energy_u, energy_w;
+    double s1u, s2u, s3u, s4u, s1w, s2w, s3w, s4w;
+    double a_u, b_u, c_u, a_w, b_w, c_w, rhs_u, rhs_w, utt_new, wtt_new;
+    double delta = 1.5, alpha = 1.0;
+    double tol_abs = 1.0e-08;   // a relative tolerance comparing the current residual to the initial residual.
+    double tol_rel = 1.0e-08;   // an absolute tolerance applied to the current residual.
+    int itr_max = 100, mr = 50; // the maximum number of outer and inner iterations to take.
+
+    energy_u = 0.0;
+    energy_w = 0.0;
+    #pragma omp parallel for private(j, k, pml, s1u, s2u, s3u, s4u, s1w, s2w, s3w, s4w, a_u, b_u, c_u, a_w, b_w, c_w, rhs_u, rhs_w, utt_new, wtt_new) \
+        reduction(+ : energy_u, energy_w)
+    for (i = 0; i < node_num; i++)
+    {
+        s1u = 0.0;
+        s2u = 0.0;
+        s3u = 0.0;
+        s4u = 0.0;
+        s1w = 0.0;
+        s2w = 0.0;
+        s3w = 0.0;
+        s4w = 0.0;
+        if (transpose == 1)
+        {
+            for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+            {
+                j = csr_j[k];
+                s1u += stif1_csr_x[k] * c[0][j] * U_now[j];
+                s2u += stif2_csr_x[k] * c[3][j] * U_now[j];
+                s3u += stif3_csr_x[k] * c[3][j] * U_now[j];
+                s4u += stif4_csr_x[k] * c[1][j] * U_now[j];
+                s1w += stif1_csr_x[k] * c[3][j] * W_now[j];
+                s2w += stif2_csr_x[k] * c[2][j] * W_now[j];
+                s3w += stif3_csr_x[k] * c[1][j] * W_now[j];
+                s4w += stif4_csr_x[k] * c[3][j] * W_now[j];
+            }
+            a_u = -s1u;
+            b_u = -s2u;
+            c_u = -s3w - s4w;
+            a_w = -s1w;
+            b_w = -s2w;
+            c_w = -s3u - s4u;
+        }
+        else
+        {
+            for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+            {
+                s1u += stif1_csr_x[k] * U_now[csr_j[k]];
+                s2u += stif2_csr_x[k] * U_now[csr_j[k]];
+                s3u += stif3_csr_x[k] * U_now[csr_j[k]];
+                s4u += stif4_csr_x[k] * U_now[csr_j[k]];
+                s1w += stif1_csr_x[k] * W_now[csr_j[k]];
+                s2w += stif2_csr_x[k] * W_now[csr_j[k]];
+                s3w += stif3_csr_x[k] * W_now[csr_j[k]];
+                s4w += stif4_csr_x[k] * W_now[csr_j[k]];
+            }
+            a_u = -c[0][i] * s1u;
+            b_u = -c[3][i] * s2u;
+            c_u = -c[1][i] * s3w - c[3][i] * s4w;
+            a_w = -c[3][i] * s1w;
+            b_w = -c[2][i] * s2w;
+            c_w = -c[3][i] * s3u - c[1][i] * s4u;
+        }
+
+        pml = pml_index[i];
+        if (pml >= 0)
+        {
+            // f / s = f + psi, psi = b * psi + a * f; twice for every group
+            psi[0][pml] = cpml_bx[i] * psi[0][pml] + cpml_ax[i] * a_u;
+            a_u = a_u + psi[0][pml];
+            psi[1][pml] = cpml_bx[i] * psi[1][pml] + cpml_ax[i] * a_u;
+            a_u = a_u + psi[1][pml];
+            psi[2][pml] = cpml_by[i] * psi[2][pml] + cpml_ay[i] * b_u;
+            b_u = b_u + psi[2][pml];
+            psi[3][pml] = cpml_by[i] * psi[3][pml] + cpml_ay[i] * b_u;
+            b_u = b_u + psi[3][pml];
+            psi[4][pml] = cpml_bx[i] * psi[4][pml] + cpml_ax[i] * c_u;
+            c_u = c_u + psi[4][pml];
+            psi[5][pml] = cpml_by[i] * psi[5][pml] + cpml_ay[i] * c_u;
+            c_u = c_u + psi[5][pml];
+            psi[6][pml] = cpml_bx[i] * psi[6][pml] + cpml_ax[i] * a_w;
+            a_w = a_w + psi[6][pml];
+            psi[7][pml] = cpml_bx[i] * psi[7][pml] + cpml_ax[i] * a_w;
+            a_w = a_w + psi[7][pml];
+            psi[8][pml] = cpml_by[i] * psi[8][pml] + cpml_ay[i] * b_w;
+            b_w = b_w + psi[8][pml];
+            psi[9][pml] = cpml_by[i] * psi[9][pml] + cpml_ay[i] * b_w;
+            b_w = b_w + psi[9][pml];
+            psi[10][pml] = cpml_bx[i] * psi[10][pml] + cpml_ax[i] * c_w;
+            c_w = c_w + psi[10][pml];
+            psi[11][pml] = cpml_by[i] * psi[11][pml] + cpml_ay[i] * c_w;
+            c_w = c_w + psi[11][pml];
+        }
+        rhs_u = a_u + b_u + c_u + source_u[i];
+        rhs_w = a_w + b_w + c_w + source_w[i];
+        source_u[i] = 0.0;
+        source_w[i] = 0.0;
+
+        if (rhs_u1 != NULL)
+        {
+            // consistent mass, solved after the loop
+            rhs_u1[i] = rhs_u;
+            rhs_w1[i] = rhs_w;
+            continue;
+        }
+        utt_new = rhs_u / mass_lump[i];
+        wtt_new = rhs_w / mass_lump[i];
+        U_new[i] = U_now[i] + Ut[i] * dt + ((0.5 - alpha) * Utt[i] + alpha * utt_new) * dt * dt;
+        W_new[i] = W_now[i] + Wt[i] * dt + ((0.5 - alpha) * Wtt[i] + alpha * wtt_new) * dt * dt;
+        Ut[i] = Ut[i] + ((1 - delta) * Utt[i] + delta * utt_new) * dt;
+        Wt[i] = Wt[i] + ((1 - delta) * Wtt[i] + delta * wtt_new) * dt;
+        Utt[i] = utt_new;
+        Wtt[i] = wtt_new;
+        energy_u += U_new[i] * U_new[i];
+        energy_w += W_new[i] * W_new[i];
+    }
+
+    if (rhs_u1 != NULL)
+    {
+        if (strcmp(solver, "pardiso") == 0)
+        {
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u1, Utt_sol);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w1, Wtt_sol);
+        }
+        else if (strcmp(solver, "mgmres") == 0)
+        {
+            pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Utt_sol, rhs_u1, itr_max, mr, tol_abs, tol_rel);
+            pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Wtt_sol, rhs_w1, itr_max, mr, tol_abs, tol_rel);
+        }
+        else
+        {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "ELASTIC_WAVE_CPML - Fatal error!\n");
+            fprintf(stderr, "  Solver type is not set = \"%s\".\n", solver);
+            exit(1);
+        }
+        #pragma omp parallel for reduction(+ : energy_u, energy_w)
+        for (i = 0; i < node_num; i++)
+        {
+            U_new[i] = U_now[i] + Ut[i] * dt + ((0.5 - alpha) * Utt[i] + alpha * Utt_sol[i]) * dt * dt;
+            W_new[i] = W_now[i] + Wt[i] * dt + ((0.5 - alpha) * Wtt[i] + alpha * Wtt_sol[i]) * dt * dt;
+            Ut[i] = Ut[i] + ((1 - delta) * Utt[i] + delta * Utt_sol[i]) * dt;
+            Wt[i] = Wt[i] + ((1 - delta) * Wtt[i] + delta * Wtt_sol[i]) * dt;
+            Utt[i] = Utt_sol[i];
+            Wtt[i] = Wtt_sol[i];
+            energy_u += U_new[i] * U_new[i];
+            energy_w += W_new[i] * W_new[i];
+        }
+    }
+    // boundary condition: zero on the Dirichlet list only
+    for (k = 0; k < dirichlet_num; k++)
+    {
+        i = dirichlet_node[k];
+        U_new[i] = 0.0;
+        Ut[i] = 0.0;
+        Utt[i] = 0.0;
+        W_new[i] = 0.0;
+        Wt[i] = 0.0;
+        Wtt[i] = 0.0;
+    }
+    if (energy_u > 10e6 || energy_w > 10e6)
+    {
+        fprintf(stderr, "\n");
+        fprintf(stderr, "ELASTIC_WAVE_CPML - Fatal error!\n");
+        fprintf(stderr, "Energy exceeds maximum value!\n");
+        exit(1);
+    }
+    field[0] = U_new;
+    field[3] = W_new;
+    work[0] = U_now;
+    work[1] = W_now;
+}
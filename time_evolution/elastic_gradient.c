@@ -0,0 +1,54 @@
+void elastic_gradient(int node_num, int *csr_p, int *csr_j, double **stif_csr_x, double *U, double *W, double *lambda_u, double *lambda_w, double **gradient)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_gradient adds the terms of one time step to the gradients of the misfit with
+    respect to c11, c13, c33, c44 at the nodes: the stiffness rows of elastic_cpml_step are
+    c (K u) with c at the row node, so the derivative of row i in c[m][i] is the stiffness
+    term of c[m] there, times the adjoint wave lambda (see elastic_wave_reverse)
+
+      c11: - lambda_u (K1 U)
+      c13: - lambda_u (K3 W) - lambda_w (K4 U)
+      c33: - lambda_w (K2 W)
+      c44: - lambda_u (K2 U + K4 W) - lambda_w (K1 W + K3 U)
+
+    with K1 ... K4 = stif_csr_x[0 ... 3].
+
+  Output:
+    gradient[4][node_num] : c11, c13, c33, c44, summed
+*/
+{
+  int i, k;
+  double s1u, s2u, s3u, s4u, s1w, s2w, s3w, s4w;
+
+  #pragma omp parallel for private(k, s1u, s2u, s3u, s4u, s1w, s2w, s3w, s4w)
+  for (i = 0; i < node_num; i++)
+  {
+    if (lambda_u[i] == 0.0 && lambda_w[i] == 0.0)
+      continue;
+    s1u = 0.0;
+    s2u = 0.0;
+    s3u = 0.0;
+    s4u = 0.0;
+    s1w = 0.0;
+    s2w = 0.0;
+    s3w = 0.0;
+    s4w = 0.0;
+    for (k = csr_p[i]; k < csr_p[i + 1]; k++)
+    {
+      s1u += stif_csr_x[0][k] * U[csr_j[k]];
+      s2u += stif_csr_x[1][k] * U[csr_j[k]];
+      s3u += stif_csr_x[2][k] * U[csr_j[k]];
+      s4u += stif_csr_x[3][k] * U[csr_j[k]];
+      s1w += stif_csr_x[0][k] * W[csr_j[k]];
+      s2w += stif_csr_x[1][k] * W[csr_j[k]];
+      s3w += stif_csr_x[2][k] * W[csr_j[k]];
+      s4w += stif_csr_x[3][k] * W[csr_j[k]];
+    }
+    gradient[0][i] -= lambda_u[i] * s1u;
+    gradient[1][i] -= lambda_u[i] * s3w + lambda_w[i] * s4u;
+    gradient[2][i] -= lambda_w[i] * s2w;
+    gradient[3][i] -= lambda_u[i] * (s2u + s4w) + lambda_w[i] * (s1w + s3u);
+  }
+}
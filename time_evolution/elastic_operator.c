@@ -0,0 +1,59 @@
+void elastic_operator(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, int nnz, int csr_p_size,
+                      int *csr_size, int **csr_p, int **csr_j, int **scatter_map, double **mass_unit_x, double **stif_csr_x)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_operator builds the part of the elastic operator that only depends on the mesh:
+    the csr pattern, the element-to-csr scatter map, the unit density mass matrix and the
+    stiffness matrices stif1-6. None of them contains a material parameter (rho only scales
+    the mass rows and c11, c13, c33, c44 are applied node by node in the time loop), so they
+    are built once and kept when the model changes, e.g. in an inversion loop:
+
+      elastic_operator(...)                      once per mesh
+      mass_sparse_update(..., rho, ...)          once per model
+      elastic_wave(...)                          time evolution
+
+    All the output arrays are allocated here, free them after use.
+
+    stiffness matrix List:
+
+        I      Stiffness_TYPE
+        -  --------------------------------------
+        1  dphi_dx * dphi_dx
+        2  dphi_dy * dphi_dy
+        3  dphi_dx * dphi_dy
+        4  dphi_dy * dphi_dx
+        5  phi     * dphi_dx
+        6  phi     * dphi_dy
+
+  Output:
+    csr_size, csr_p, csr_j : csr pattern shared by all the matrices
+    scatter_map            : element matrix entry -> csr position, size nnz
+    mass_unit_x            : mass matrix with rho = 1, size csr_size
+    stif_csr_x[0..5]       : stif1-6, size csr_size
+*/
+{
+    int i, k;
+    double *rho_unit = NULL;
+
+    *csr_p = (int *)malloc(csr_p_size * sizeof(int));
+    *csr_j = csr_pattern(node_num, element_num, element_order, element_node, *csr_p, csr_size);
+    *scatter_map = (int *)malloc(nnz * sizeof(int));
+    csr_scatter_map(element_num, element_order, element_node, *csr_p, *csr_j, *scatter_map);
+
+    // mass with unit density
+    rho_unit = (double *)malloc(node_num * sizeof(double));
+    for (i = 0; i < node_num; i++)
+        rho_unit[i] = 1.0;
+    *mass_unit_x = (double *)malloc(*csr_size * sizeof(double));
+    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, rho_unit, *csr_size, *scatter_map, *mass_unit_x, 0);
+    free(rho_unit);
+
+    // stiffness1-6
+    for (k = 0; k < 6; k++)
+    {
+        stif_csr_x[k] = (double *)malloc(*csr_size * sizeof(double));
+        stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, *csr_size, *scatter_map, stif_csr_x[k], k + 1);
+    }
+}
@@ -1,6 +1,48 @@
-void elastic_wave(char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy, int nnz, int csr_p_size, int step, double dt,  \
-                  double f0, double t0, double edge_size, double xmin, double xmax, double ymin, double ymax, int pml_nx, int pml_ny, int src_num, int *src_node,   \
-                  int rec_num, int *rec_node, char *solver, int use_exterior_mesh, int free_surface_code)
+void elastic_wave(int node_num, double **node_xy, int csr_p_size, int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x, \
+                  double **c, double *mpml_dx, double *mpml_dy, double *mpml_dxx, double *mpml_dyy, double *mpml_dxx_pyx, double *mpml_dyy_pxy,                      \
+                  int step, double dt, double f0, double t0,                                                                                                          \
+                  int shot_first, int shot_num, int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *wavelet, double *shot_force, char *shot_name, \
+                  int rec_num, int *rec_node, double *rec_weight, int point_order,                                                                    \
+                  double *seismogram_all, int *node_new, char *solver, int dirichlet_num, int *dirichlet_node, double **visco,
+                  int dft_freq_num, double *dft_freq, int dft_num, int *dft_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_wave runs the time evolution of every shot. The csr pattern and stif1-6 come from
+    elastic_operator, mass_csr_x and mass_lump from mass_sparse_update for the current rho,
+    c[4] = c11, c13, c33, c44 from the model and the mpml profiles from abc_mpml.
+
+    node_new[old] = new maps the node order of the mesh files to the order of the arrays
+    (see mesh_renumber), the wavefield snapshots are written in the order of the mesh files.
+
+    The shots shot_first to shot_num - 1 are run (see elastic_wave_aperture for one shot at a time),
+    every shot injects the sources listed by source_injection, one or a supershot of several:
+    inj_weight * wavelet of source inj_src at the time step, wavelet from source_wavelet, times
+    shot_force[2 * shot] in x (u) and shot_force[2 * shot + 1] in y (w). The output files are
+    named after shot_name, e.g. seismogram_u_shot_1.txt.
+    Receiver i is spread over point_order nodes with weights (see set_point_node), the
+    seismogram is the weighted sum of the field at rec_node. When seismogram_all is not NULL
+    the seismograms of the shot are also kept there, u and w of step it at
+    seismogram_all[(it * 2 + 0 or 1) * rec_num + i], and written out at the end of the shot
+    (see reciprocity_write).
+    The dirichlet_num nodes of dirichlet_node (the absorbing and fixed boundary, see
+    mesh_boundary_node) are held at zero after every solve.
+
+    With visco not NULL (see visco_sls) c holds the unrelaxed moduli and every stiffness
+    term e = stif * U_now or stif * W_now of the c11, c13, c33, c44 rows keeps one memory
+    variable z, coarse-grained to the mechanism of the node:
+
+      z = zeta + h * e,  rhs += visco[1..4] * z,  zeta = visco[0] * z + h * e,  h = (1 - visco[0]) / 2
+
+    the exponential update of dz/dt = omega * (e - z) with e linear over the step, kept in one
+    array zeta per term (z half updated): 8 arrays and one pass over the nodes per component,
+    no other csr product.
+
+    With dft_freq_num > 0 the Fourier transforms of u and w at the dft_freq_num frequencies of
+    dft_freq are summed at every step on the dft_num nodes of dft_node (see wavefield_dft) and
+    written at the end of the shot to dft_shot_1.bin, ... (see wavefield_dft_write).
+*/
 {
 
     /*    stiffness matrix List:
@@ -16,62 +58,20 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
         6  phi     * dphi_dy
     */
     /***************************************
-     coo(i,j,x) and csr(p,j,x) arrays
+     csr(p,j,x) arrays, one pattern for all
      ****************************************/
-    int mass_csr_size = 0;                                                                                                      // csr size for mass : j and x
-    int stif1_csr_size = 0, stif2_csr_size = 0, stif3_csr_size = 0, stif4_csr_size = 0, stif5_csr_size = 0, stif6_csr_size = 0; // csr size for stif1-6: j and x
-    int *mass_coo_i = NULL;
-    int *mass_coo_j = NULL;
-    int *mass_csr_p = NULL;
-    int *mass_csc_p = NULL;
-    int *mass_csr_j = NULL;
-    int *mass_csc_j = NULL;
-    int *mass_csr_j_temp = NULL;
-    int *stif_coo_i = NULL;
-    int *stif_coo_j = NULL;
-    int *stif_csr_j_temp = NULL;
-    int *stif1_csr_p = NULL;
-    int *stif2_csr_p = NULL;
-    int *stif3_csr_p = NULL;
-    int *stif4_csr_p = NULL;
-    int *stif5_csr_p = NULL;
-    int *stif6_csr_p = NULL;
-    int *stif1_csr_j = NULL;
-    int *stif2_csr_j = NULL;
-    int *stif3_csr_j = NULL;
-    int *stif4_csr_j = NULL;
-    int *stif5_csr_j = NULL;
-    int *stif6_csr_j = NULL;
-    double *mass_lump = NULL;
-    double *mass_coo_x = NULL;
-    double *mass_csr_x = NULL;
-    double *mass_csc_x = NULL;
-    double *mass_csr_x_temp = NULL;
-    double *stif_coo_x = NULL;
-    double *stif_csr_x_temp = NULL;
-    double *stif1_csr_x = NULL;
-    double *stif2_csr_x = NULL;
-    double *stif3_csr_x = NULL;
-    double *stif4_csr_x = NULL;
-    double *stif5_csr_x = NULL;
-    double *stif6_csr_x = NULL;
+    double *stif1_csr_x = stif_csr_x[0];
+    double *stif2_csr_x = stif_csr_x[1];
+    double *stif3_csr_x = stif_csr_x[2];
+    double *stif4_csr_x = stif_csr_x[3];
+    double *stif5_csr_x = stif_csr_x[4];
+    double *stif6_csr_x = stif_csr_x[5];
 
-    /***************************************
-     model density and velocity parameters
-     ****************************************/
-    double *rho = NULL;
-    double *vp = NULL;
-    double *vs = NULL;
-    double **c = NULL;
-    double Angle_force = 90.0;
-    double pi = 3.1415926535898;
     /***************************************
              time evolution parameters
      ****************************************/
-    int i, it;
+    int i, k, it;
     double time;
-    double vp_max;
-    double point_source;
     double *Energy_u = NULL, *Energy_w = NULL;
     double *U_now = NULL, *W_now = NULL;
     double *seismogram_u = NULL, *seismogram_w = NULL;
@@ -94,276 +94,27 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
     double *equ5_1 = NULL, *equ5_2 = NULL;
     double *equ6_1 = NULL, *equ6_2 = NULL;
     double *equ7_1 = NULL, *equ7_2 = NULL;
+    double *zeta[8];
+    double *dft = NULL;
+    size_t d, dft_size = (size_t)dft_freq_num * 4 * dft_num; // u, w of every frequency, real and imaginary
+    double decay, half, z1, z2, z3, z4;
     double delta = 1.5, alpha = 1.0;
     double tol_abs = 1.0e-08;   // a relative tolerance comparing the current residual to the initial residual.
     double tol_rel = 1.0e-08;   // an absolute tolerance applied to the current residual.
     int itr_max = 100, mr = 50; // the maximum number of outer and inner iterations to take.
-    int source_node = 0;
     int source_count = 0;
     int shot;
-    /***************************************
-     abosorbing bc, mpml parameters
-     ****************************************/
-    int use_mpml_xmin = 1;
-    int use_mpml_xmax = 1; // use_pml_ymax = 0, free surface on ymax.
-    int use_mpml_ymin = 1;
-    int use_mpml_ymax = 1; 
-    double *mpml_dx = NULL;
-    double *mpml_dy = NULL;
-    double *mpml_dxx = NULL;
-    double *mpml_dyy = NULL;
-    double *mpml_dxx_pyx = NULL;
-    double *mpml_dyy_pxy = NULL;
-    int *Dirichlet_boundary_node_flag = NULL;
     /***************************************
                   file pointers
      ****************************************/
     FILE *fp_wavefield_u,  *fp_wavefield_w;
     FILE *fp_energy_u,     *fp_energy_w;
     FILE *fp_seismogram_u, *fp_seismogram_w;
-    FILE *fp_mass;
-	FILE *fp_stif1;
-	FILE *fp_stif2;
-	FILE *fp_stif3;
-	FILE *fp_stif4;
-	FILE *fp_stif5;
-	FILE *fp_stif6;
-	FILE *fp_model_par;
 	char filename_wavefield_u[128],  filename_wavefield_w[128];
     char filename_energy_u[128],     filename_energy_w[128];
     char filename_seismogram_u[128], filename_seismogram_w[128];
+    char filename_dft[128];
 
-    Dirichlet_boundary_node_flag = (int *)malloc(node_num * sizeof(int));
-    for( i =0;i<node_num;i++)
-    {
-        if(free_surface_code == 0)
-        {
-            if( (node_xy[0][i] <= xmin + edge_size/4.0)|| (node_xy[0][i] >= xmax - edge_size/4.0)  || (node_xy[1][i] <= ymin + edge_size/4.0) || (node_xy[1][i] >= ymax - edge_size/4.0) )
-            {
-                Dirichlet_boundary_node_flag[i] = 1;
-            }
-        }
-        else
-        {
-            if( (node_xy[0][i] <= xmin + edge_size/4.0) || (node_xy[1][i] <= ymin + edge_size/4.0) || (node_xy[1][i] >= ymax - edge_size/4.0) )
-            {
-                Dirichlet_boundary_node_flag[i] = 1;
-            }
-        }
-        
-      
-    }
-
-    use_mpml_xmax = use_mpml_xmax - free_surface_code;
-    // when no free_surface use_mpml_xmax = 1
-    // when    free_surface use_mpml_xmax = 0
-    /****************************************************************************
-                                       prepare part
-    *****************************************************************************/
-    /***************************************
-          allocate the dynamic arrays
-     ****************************************/
-    mass_lump = (double *)malloc(node_num * sizeof(double));
-    mass_coo_i = (int *)malloc(nnz * sizeof(int));
-    mass_coo_j = (int *)malloc(nnz * sizeof(int));
-    stif_coo_i = (int *)malloc(nnz * sizeof(int));
-    stif_coo_j = (int *)malloc(nnz * sizeof(int));
-    mass_csc_p = (int *)malloc(csr_p_size * sizeof(int));
-    mass_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif1_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif2_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif3_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif4_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif5_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif6_csr_p = (int *)malloc(csr_p_size * sizeof(int));
-    stif_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    mass_csr_j_temp = (int *)malloc(nnz * sizeof(int));
-    mass_coo_x = (double *)malloc(nnz * sizeof(double));
-    stif_coo_x = (double *)malloc(nnz * sizeof(double));
-    mass_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-    stif_csr_x_temp = (double *)malloc(nnz * sizeof(double));
-
-    rho = (double *)malloc(node_num * sizeof(double));
-    vp = (double *)malloc(node_num * sizeof(double));
-    vs = (double *)malloc(node_num * sizeof(double));
-    c = (double **)malloc(4 * sizeof(double));
-    for (i = 0; i < 4; i++)
-        c[i] = malloc(node_num * sizeof(double));
-    mpml_dx = (double *)malloc(node_num * sizeof(double));
-    mpml_dy = (double *)malloc(node_num * sizeof(double));
-    mpml_dxx = (double *)malloc(node_num * sizeof(double));
-    mpml_dyy = (double *)malloc(node_num * sizeof(double));
-    mpml_dxx_pyx = (double *)malloc(node_num * sizeof(double));
-    mpml_dyy_pxy = (double *)malloc(node_num * sizeof(double));
-    if (use_exterior_mesh == 1)
-    {
-
-       if ((fp_model_par = fopen("./mesh/velocity_and_density.txt","r")) == NULL)
-            printf("\n test velocity_and_density.txt file cannot open\n");
-
-        for(i=0;i<node_num;i++)
-	    {
-		    fscanf(fp_model_par,"%lf %lf  %lf  %lf  %lf  %lf  %lf\n", &rho[i],&vp[i],&vs[i],&c[0][i],&c[1][i],&c[2][i],&c[3][i]);	
-        }
-	    fclose(fp_model_par);
-    }
-    else 
-    {
-        model_elastic_parameter(node_num, element_num, element_order, element_node, node_xy, rho, vp, vs, c);
-        if ((fp_model_par = fopen("./mesh/velocity_and_density.txt","w")) == NULL)
-            printf("\n velocity_and_density.txt file cannot open\n");
-	    for(i=0;i<node_num;i++)
-	    {
-		    fprintf(fp_model_par,"%f	%f	%f	%f	%f	%f	%f\n", rho[i],vp[i],vs[i],c[0][i],c[1][i],c[2][i],c[3][i]);	
-	    }
-	    fclose(fp_model_par);
-    }
-    vp_max = vp[0];
-    for (i = 0; i < node_num; i++)
-    {
-        if (vp[i] > vp_max)
-            vp_max = vp[i];
-    }
-    abc_mpml(node_num, element_num, element_order, element_node, node_xy, pml_nx, pml_ny, edge_size, xmin, xmax, ymin, ymax, vp_max,
-             use_mpml_xmin, use_mpml_xmax, use_mpml_ymin, use_mpml_ymax, mpml_dx, mpml_dy, mpml_dxx, mpml_dyy, mpml_dxx_pyx, mpml_dyy_pxy);
-
-    /********************************************************
-        assemble matrices, first in coo then call 
-        fortran subroutines to convert coo to csr. 
-        do not need use & to get the address of the pointers.
-     *********************************************************/
-    // mass lump
-    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, 1);
-    for (i = 0; i < node_num; i++)
-        mass_lump[i] = mass_coo_x[i];
-    // mass
-    mass_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, rho, mass_coo_i, mass_coo_j, mass_coo_x, 0);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &mass_csr_size, mass_coo_i, mass_coo_j, mass_coo_x, mass_csr_p, mass_csr_j_temp, mass_csr_x_temp);
-    mass_csr_j = (int *)malloc(mass_csr_size * sizeof(int));
-    mass_csc_j = (int *)malloc(mass_csr_size * sizeof(int));
-    mass_csr_x = (double *)malloc(mass_csr_size * sizeof(double));
-    mass_csc_x = (double *)malloc(mass_csr_size * sizeof(double));
-    for (i = 0; i < mass_csr_size; i++)
-    {
-        mass_csr_j[i] = mass_csr_j_temp[i];
-        mass_csr_x[i] = mass_csr_x_temp[i];
-    }
-    // pardiso need csr and superlu need csc
-    //__coo2csr_lib_MOD_csr2csc(&node_num, &mass_csr_size, mass_csr_x, mass_csr_j, mass_csr_p, mass_csc_x, mass_csc_j, mass_csc_p);
-
-    // stiffness1: dphidx * dphidx
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 1);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif1_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif1_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    stif1_csr_j = (int *)malloc(stif1_csr_size * sizeof(int));
-    stif1_csr_x = (double *)malloc(stif1_csr_size * sizeof(double));
-    for (i = 0; i < stif1_csr_size; i++)
-    {
-        stif1_csr_j[i] = stif_csr_j_temp[i];
-        stif1_csr_x[i] = stif_csr_x_temp[i];
-    }
-    // stiffness2: dphidy * dphidy
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 2);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif2_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif2_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    stif2_csr_j = (int *)malloc(stif2_csr_size * sizeof(int));
-    stif2_csr_x = (double *)malloc(stif2_csr_size * sizeof(double));
-    for (i = 0; i < stif2_csr_size; i++)
-    {
-        stif2_csr_j[i] = stif_csr_j_temp[i];
-        stif2_csr_x[i] = stif_csr_x_temp[i];
-    }
-    // stiffness3: dphidx * dphidy
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 3);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif3_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif3_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    stif3_csr_j = (int *)malloc(stif3_csr_size * sizeof(int));
-    stif3_csr_x = (double *)malloc(stif3_csr_size * sizeof(double));
-    for (i = 0; i < stif3_csr_size; i++)
-    {
-        stif3_csr_j[i] = stif_csr_j_temp[i];
-        stif3_csr_x[i] = stif_csr_x_temp[i];
-    }
-    // stiffness4: dphidy * dphidx
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 4);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif4_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif4_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    stif4_csr_j = (int *)malloc(stif4_csr_size * sizeof(int));
-    stif4_csr_x = (double *)malloc(stif4_csr_size * sizeof(double));
-    for (i = 0; i < stif4_csr_size; i++)
-    {
-        stif4_csr_j[i] = stif_csr_j_temp[i];
-        stif4_csr_x[i] = stif_csr_x_temp[i];
-    }
-    // stiffness5: phi * dphidx
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 5);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif5_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif5_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    stif5_csr_j = (int *)malloc(stif5_csr_size * sizeof(int));
-    stif5_csr_x = (double *)malloc(stif5_csr_size * sizeof(double));
-    for (i = 0; i < stif5_csr_size; i++)
-    {
-        stif5_csr_j[i] = stif_csr_j_temp[i];
-        stif5_csr_x[i] = stif_csr_x_temp[i];
-    }
-    // stiffness6: phi * dphidy
-    stif_sparse_all(type, node_num, element_num, element_order, element_node, node_xy, stif_coo_i, stif_coo_j, stif_coo_x, 6);
-    __coo2csr_lib_MOD_coo2csr_canonical(&nnz, &csr_p_size, &stif6_csr_size, stif_coo_i, stif_coo_j, stif_coo_x, stif6_csr_p, stif_csr_j_temp, stif_csr_x_temp);
-    stif6_csr_j = (int *)malloc(stif6_csr_size * sizeof(int));
-    stif6_csr_x = (double *)malloc(stif6_csr_size * sizeof(double));
-    for (i = 0; i < stif6_csr_size; i++)
-    {
-        stif6_csr_j[i] = stif_csr_j_temp[i];
-        stif6_csr_x[i] = stif_csr_x_temp[i];
-    }
-
-
-	/*
-    fp_mass=fopen("mass_p.dat","w");	
-	fp_stif1=fopen("stif1_p.dat","w");
-	fp_stif2=fopen("stif2_p.dat","w");
-	fp_stif3=fopen("stif3_p.dat","w");
-	fp_stif4=fopen("stif4_p.dat","w");
-	fp_stif5=fopen("stif5_p.dat","w");
-	fp_stif6=fopen("stif6_p.dat","w");
-	for(i=0;i<csr_p_size;i++)
-	{
-		fprintf(fp_mass,"%d\n",mass_csr_p[i]);
-		fprintf(fp_stif1,"%d\n",stif1_csr_p[i]);
-		fprintf(fp_stif2,"%d\n",stif2_csr_p[i]);
-		fprintf(fp_stif3,"%d\n",stif3_csr_p[i]);
-		fprintf(fp_stif4,"%d\n",stif4_csr_p[i]);
-		fprintf(fp_stif5,"%d\n",stif5_csr_p[i]);
-		fprintf(fp_stif6,"%d\n",stif6_csr_p[i]);
-	}
-	fclose(fp_mass);
-	fclose(fp_stif1);
-	fclose(fp_stif2);
-	fclose(fp_stif3);
-	fclose(fp_stif4);
-	fclose(fp_stif5);
-	fclose(fp_stif6);
-    fp_mass =fopen("mass_j_x.dat","w");
-	fp_stif1=fopen("stif1_j_x.dat","w");
-	fp_stif2=fopen("stif2_j_x.dat","w");
-	fp_stif3=fopen("stif3_j_x.dat","w");
-	fp_stif4=fopen("stif4_j_x.dat","w");
-	fp_stif5=fopen("stif5_j_x.dat","w");
-	fp_stif6=fopen("stif6_j_x.dat","w");
- 	for(i=0;i<mass_csr_size;i++)
-	{
-		fprintf(fp_mass,"%d	%lf\n",mass_csr_j[i],mass_csr_x[i]);	
-	}
-	for(i=0;i<stif1_csr_size;i++)	fprintf(fp_stif1,"%d %lf\n",stif1_csr_j[i],stif1_csr_x[i]);
-	for(i=0;i<stif2_csr_size;i++)	fprintf(fp_stif2,"%d %lf\n",stif2_csr_j[i],stif2_csr_x[i]);
-	for(i=0;i<stif3_csr_size;i++)	fprintf(fp_stif3,"%d %lf\n",stif3_csr_j[i],stif3_csr_x[i]);
-	for(i=0;i<stif4_csr_size;i++)	fprintf(fp_stif4,"%d %lf\n",stif4_csr_j[i],stif4_csr_x[i]);
-	for(i=0;i<stif5_csr_size;i++)	fprintf(fp_stif5,"%d %lf\n",stif5_csr_j[i],stif5_csr_x[i]);
-	for(i=0;i<stif6_csr_size;i++)	fprintf(fp_stif6,"%d %lf\n",stif6_csr_j[i],stif6_csr_x[i]);
-   	fclose(fp_mass);
-   	fclose(fp_stif1);
-    fclose(fp_stif2);
-	fclose(fp_stif3);
-	fclose(fp_stif4);
-	fclose(fp_stif5);
-	fclose(fp_stif6);
-    */
-    
     /****************************************************************************
      *                    multi shot time evolution
     *****************************************************************************/
@@ -442,18 +193,21 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
     rhs_w5 = (double *)malloc(node_num * sizeof(double));
     rhs_w6 = (double *)malloc(node_num * sizeof(double));
     rhs_w7 = (double *)malloc(node_num * sizeof(double));
+    for (k = 0; k < 8; k++)
+        zeta[k] = (visco != NULL) ? (double *)malloc(node_num * sizeof(double)) : NULL;
+    if (dft_freq_num > 0)
+        dft = (double *)malloc(dft_size * sizeof(double));
     //#pragma omp parallel for private(shot)
-    for (shot = 0; shot < src_num; shot++)
+    for (shot = shot_first; shot < shot_num; shot++)
     {
-        source_node = src_node[shot];
         printf("\n ######## Shot num: %d ########\n", shot + 1);
 
-        sprintf(filename_wavefield_u, "./outputfile/wavefield_u_shot_%d.txt", shot + 1);
-        sprintf(filename_wavefield_w, "./outputfile/wavefield_w_shot_%d.txt", shot + 1);
-        sprintf(filename_energy_u, "./outputfile/energy_u_shot_%d.txt", shot + 1);
-        sprintf(filename_energy_w, "./outputfile/energy_w_shot_%d.txt", shot + 1);
-        sprintf(filename_seismogram_u, "./outputfile/seismogram_u_shot_%d.txt", shot + 1);
-        sprintf(filename_seismogram_w, "./outputfile/seismogram_w_shot_%d.txt", shot + 1);
+        sprintf(filename_wavefield_u, "./outputfile/wavefield_u_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_wavefield_w, "./outputfile/wavefield_w_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_energy_u, "./outputfile/energy_u_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_energy_w, "./outputfile/energy_w_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_u, "./outputfile/seismogram_u_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_w, "./outputfile/seismogram_w_%s_%d.txt", shot_name, shot + 1);
 
         fp_wavefield_u = fopen(filename_wavefield_u, "w");
         fp_wavefield_w = fopen(filename_wavefield_w, "w");
@@ -505,6 +259,13 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
         }
         fprintf(fp_wavefield_u, "\n");
         fprintf(fp_wavefield_w, "\n");
+        for (k = 0; k < 8 && visco != NULL; k++)
+        {
+            for (i = 0; i < node_num; i++)
+                zeta[k][i] = 0.0;
+        }
+        for (d = 0; d < dft_size; d++)
+            dft[d] = 0.0;
 
         Energy_u[0] = 0.0;
         Energy_u[1] = 0.0;
@@ -523,66 +284,65 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
                 printf("\n ****Iteration step: %-d, time: %-f s\n ", it + 1, time);
             Energy_u[it] = 0.0;
             Energy_w[it] = 0.0;
-            point_source = seismic_source(f0, t0, 1.0e10, time);
 
         /********************************************************************************************************************************************
          Equation u1:
           mass * U1tt_new = - c11 * dphidx * dphidx * U_now - 2.0 * mpml_dx * phi * phi * U1t_now - mpml_dx * mpml_dx * phi * phi * U1_now 
                             + phi * phi * Lx1_now + phi * phi * Lx2_now + Source_x
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif1_csr_p, stif1_csr_j, stif1_csr_x, U_now, equ1_1); // dphidx * dphidx * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, U1t_now, equ1_2);  // phi    * phi    * U1t_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, U1_now, equ1_3);   // phi    * phi    * U1_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx1_now, equ1_4);  // phi    * phi    * Lx1_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx2_now, equ1_5);  // phi    * phi    * Lx2_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif1_csr_x, U_now, equ1_1); // dphidx * dphidx * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, U1t_now, equ1_2);  // phi    * phi    * U1t_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, U1_now, equ1_3);   // phi    * phi    * U1_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx1_now, equ1_4);  // phi    * phi    * Lx1_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx2_now, equ1_5);  // phi    * phi    * Lx2_now
         /********************************************************************************************************************************************
          Equation u2:
           mass * U2tt_new = - c13 * dphidx * dphidy * W_now - c44 * dphidy * dphidx * W_now - mpml_dx * phi * phi * U2t_now 
                             - mpml_dy * phi * phi * U2t_now - mpml_dx * mpml_dy * phi * phi * U2_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif3_csr_p, stif3_csr_j, stif3_csr_x, W_now, equ2_1); // dphidx * dphidy * W_now
-        csr_matvec(csr_p_size, stif4_csr_p, stif4_csr_j, stif4_csr_x, W_now, equ2_2); // dphidy * dphidx * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, U2t_now, equ2_3);  // phi    * phi    * U2t_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, U2_now, equ2_4);   // phi    * phi    * U2_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif3_csr_x, W_now, equ2_1); // dphidx * dphidy * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif4_csr_x, W_now, equ2_2); // dphidy * dphidx * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, U2t_now, equ2_3);  // phi    * phi    * U2t_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, U2_now, equ2_4);   // phi    * phi    * U2_now
         /********************************************************************************************************************************************
          Equation u3:
           mass * U3tt_new = - c44 * dphidy * dphidy * U_now - 2.0 * mpml_dy * phi * phi * U3t_now - mpml_dy * mpml_dy * phi * phi * U3_now 
                             + phi * phi * Lx3_now + phi * phi * Lx4_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif2_csr_p, stif2_csr_j, stif2_csr_x, U_now, equ3_1); // dphidy * dphidy * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, U3t_now, equ3_2);  // phi    * phi    * U3t_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, U3_now, equ3_3);   // phi    * phi    * U3_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx3_now, equ3_4);  // phi    * phi    * Lx3_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx4_now, equ3_5);  // phi    * phi    * Lx4_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif2_csr_x, U_now, equ3_1); // dphidy * dphidy * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, U3t_now, equ3_2);  // phi    * phi    * U3t_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, U3_now, equ3_3);   // phi    * phi    * U3_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx3_now, equ3_4);  // phi    * phi    * Lx3_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx4_now, equ3_5);  // phi    * phi    * Lx4_now
         /********************************************************************************************************************************************
          Equation u4:
           mass * Lx1_new = - dt * c11 * mpml_dxx * phi * dphidx * U_now - dt * mpml_dx * phi * phi * Lx1_now + phi * phi * Lx1_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif5_csr_p, stif5_csr_j, stif5_csr_x, U_now, equ4_1); // phi    * dphidx * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx1_now, equ4_2);  // phi    * phi    * Lx1_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif5_csr_x, U_now, equ4_1); // phi    * dphidx * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx1_now, equ4_2);  // phi    * phi    * Lx1_now
         /********************************************************************************************************************************************
          Equation u5:
           mass * Lx2_new = - dt * c44 * mpml_dyy_pxy * phi * dphidx * W_now - dt * mpml_dy * phi * phi * Lx2_now + phi * phi * Lx2_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif5_csr_p, stif5_csr_j, stif5_csr_x, W_now, equ5_1); // phi    * dphidx * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx2_now, equ5_2);  // phi    * phi    * Lx2_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif5_csr_x, W_now, equ5_1); // phi    * dphidx * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx2_now, equ5_2);  // phi    * phi    * Lx2_now
         /********************************************************************************************************************************************
          Equation u6:
           mass * Lx3_new = - dt * c13 * mpml_dxx_pyx * phi * dphidy * W_now - dt * mpml_dx * phi * phi * Lx3_now + phi * phi * Lx3_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif6_csr_p, stif6_csr_j, stif6_csr_x, W_now, equ6_1); // phi    * dphidy * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx3_now, equ6_2);  // phi    * phi    * Lx3_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif6_csr_x, W_now, equ6_1); // phi    * dphidy * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx3_now, equ6_2);  // phi    * phi    * Lx3_now
         /********************************************************************************************************************************************
          Equation u7:
          mass * Lx4_new = - dt * c44 * mpml_dyy * phi * dphidy * U_now - dt * mpml_dy * phi * phi * Lx4_now + phi * phi * Lx4_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif6_csr_p, stif6_csr_j, stif6_csr_x, U_now, equ7_1); // phi    * dphidy * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx4_now, equ7_2);  // phi    * phi    * Lx4_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif6_csr_x, U_now, equ7_1); // phi    * dphidy * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Lx4_now, equ7_2);  // phi    * phi    * Lx4_now
 
         #pragma omp parallel for private(i)
         for (i = 0; i < node_num; i++)
         {
-            rhs_u1[i] = -c[0][i] * equ1_1[i] - 2.0 * mpml_dx[i] * equ1_2[i] - mpml_dx[i] * mpml_dx[i] * equ1_3[i] + equ1_4[i] + equ1_5[i] + (i == source_node) * point_source * sin(Angle_force * pi / 180.0);
+            rhs_u1[i] = -c[0][i] * equ1_1[i] - 2.0 * mpml_dx[i] * equ1_2[i] - mpml_dx[i] * mpml_dx[i] * equ1_3[i] + equ1_4[i] + equ1_5[i];
             rhs_u2[i] = -c[1][i] * equ2_1[i] - c[3][i] * equ2_2[i] - mpml_dx[i] * equ2_3[i] - mpml_dy[i] * equ2_3[i] - mpml_dx[i] * mpml_dy[i] * equ2_4[i];
             rhs_u3[i] = -c[3][i] * equ3_1[i] - 2.0 * mpml_dy[i] * equ3_2[i] - mpml_dy[i] * mpml_dy[i] * equ3_3[i] + equ3_4[i] + equ3_5[i];
             rhs_u4[i] = -dt * c[0][i] * mpml_dxx[i] * equ4_1[i] - dt * mpml_dx[i] * equ4_2[i] + equ4_2[i];
@@ -590,65 +350,89 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
             rhs_u6[i] = -dt * c[1][i] * mpml_dxx_pyx[i] * equ6_1[i] - dt * mpml_dx[i] * equ6_2[i] + equ6_2[i];
             rhs_u7[i] = -dt * c[3][i] * mpml_dyy[i] * equ7_1[i] - dt * mpml_dy[i] * equ7_2[i] + equ7_2[i];
         }
+        if (visco != NULL)
+        {
+            // memory variables of c11 * dphidx * dphidx * U, c13 * dphidx * dphidy * W, c44 * dphidy * dphidx * W, c44 * dphidy * dphidy * U
+            #pragma omp parallel for private(decay, half, z1, z2, z3, z4)
+            for (i = 0; i < node_num; i++)
+            {
+                decay = visco[0][i];
+                half = 0.5 * (1.0 - decay);
+                z1 = zeta[0][i] + half * equ1_1[i];
+                z2 = zeta[1][i] + half * equ2_1[i];
+                z3 = zeta[2][i] + half * equ2_2[i];
+                z4 = zeta[3][i] + half * equ3_1[i];
+                rhs_u1[i] += visco[1][i] * z1;
+                rhs_u2[i] += visco[3][i] * z2 + visco[4][i] * z3;
+                rhs_u3[i] += visco[4][i] * z4;
+                zeta[0][i] = decay * z1 + half * equ1_1[i];
+                zeta[1][i] = decay * z2 + half * equ2_1[i];
+                zeta[2][i] = decay * z3 + half * equ2_2[i];
+                zeta[3][i] = decay * z4 + half * equ3_1[i];
+            }
+        }
+        // Source_x, sparse: only the nodes in the injection list of the shot
+        for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+            rhs_u1[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot];
 
         /********************************************************************************************************************************************
          Equation w1:
           mass * W1tt_new = - c44 * dphidx * dphidx * W_now - 2.0 * mpml_dx * phi * phi * W1t_now - mpml_dx * mpml_dx * phi * phi * W1_now 
                             + phi * phi * Ly1_now + phi * phi * Ly2_now + Source_y
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif1_csr_p, stif1_csr_j, stif1_csr_x, W_now, equ1_1); // dphidx * dphidx * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, W1t_now, equ1_2);  // phi    * phi    * W1t_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, W1_now, equ1_3);   // phi    * phi    * W1_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly1_now, equ1_4);  // phi    * phi    * Ly1_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly2_now, equ1_5);  // phi    * phi    * Ly2_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif1_csr_x, W_now, equ1_1); // dphidx * dphidx * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, W1t_now, equ1_2);  // phi    * phi    * W1t_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, W1_now, equ1_3);   // phi    * phi    * W1_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly1_now, equ1_4);  // phi    * phi    * Ly1_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly2_now, equ1_5);  // phi    * phi    * Ly2_now
         /********************************************************************************************************************************************
          Equation w2:
           mass * W2tt_new = - c44 * dphidx * dphidy * U_now - c13 * dphidy * dphidx * U_now - mpml_dx * phi * phi * W2t_now 
                             - mpml_dy * phi * phi * W2t_now - mpml_dx * mpml_dy * phi * phi * W2_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif3_csr_p, stif3_csr_j, stif3_csr_x, U_now, equ2_1); // dphidx * dphidy * U_now
-        csr_matvec(csr_p_size, stif4_csr_p, stif4_csr_j, stif4_csr_x, U_now, equ2_2); // dphidy * dphidx * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, W2t_now, equ2_3);  // phi    * phi    * W2t_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, W2_now, equ2_4);   // phi    * phi    * W2_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif3_csr_x, U_now, equ2_1); // dphidx * dphidy * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif4_csr_x, U_now, equ2_2); // dphidy * dphidx * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, W2t_now, equ2_3);  // phi    * phi    * W2t_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, W2_now, equ2_4);   // phi    * phi    * W2_now
         /********************************************************************************************************************************************
          Equation w3:
           mass * W3tt_new = - c33 * dphidy * dphidy * W_now - 2.0 * mpml_dy * phi * phi * W3t_now - mpml_dy * mpml_dy * phi * phi * W3_now 
                             + phi * phi * Ly3_now + phi * phi * Ly4_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif2_csr_p, stif2_csr_j, stif2_csr_x, W_now, equ3_1); // dphidy * dphidy * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, W3t_now, equ3_2);  // phi    * phi    * W3t_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, W3_now, equ3_3);   // phi    * phi    * W3_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly3_now, equ3_4);  // phi    * phi    * Ly3_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly4_now, equ3_5);  // phi    * phi    * Ly4_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif2_csr_x, W_now, equ3_1); // dphidy * dphidy * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, W3t_now, equ3_2);  // phi    * phi    * W3t_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, W3_now, equ3_3);   // phi    * phi    * W3_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly3_now, equ3_4);  // phi    * phi    * Ly3_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly4_now, equ3_5);  // phi    * phi    * Ly4_now
         /********************************************************************************************************************************************
          Equation 4:
           mass * Ly1_new = - dt * c44 * mpml_dxx * phi * dphidx * W_now - dt * mpml_dx * phi * phi * Ly1_now + phi * phi * Ly1_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif5_csr_p, stif5_csr_j, stif5_csr_x, W_now, equ4_1); // phi    * dphidx * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly1_now, equ4_2);  // phi    * phi    * Ly1_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif5_csr_x, W_now, equ4_1); // phi    * dphidx * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly1_now, equ4_2);  // phi    * phi    * Ly1_now
         /********************************************************************************************************************************************
          Equation w5:
           mass * Ly2_new = - dt * c13 * mpml_dyy_pxy * phi * dphidx * U_now - dt * mpml_dy * phi * phi * Ly2_now + phi * phi * Ly2_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif5_csr_p, stif5_csr_j, stif5_csr_x, U_now, equ5_1); // phi    * dphidx * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly2_now, equ5_2);  // phi    * phi    * Ly2_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif5_csr_x, U_now, equ5_1); // phi    * dphidx * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly2_now, equ5_2);  // phi    * phi    * Ly2_now
         /********************************************************************************************************************************************
          Equation w6:
           mass * Ly3_new = - dt * c44 * mpml_dxx_pyx * phi * dphidy * U_now - dt * mpml_dx * phi * phi * Ly3_now + phi * phi * Ly3_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif6_csr_p, stif6_csr_j, stif6_csr_x, U_now, equ6_1); // phi    * dphidy * U_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly3_now, equ6_2);  // phi    * phi    * Ly3_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif6_csr_x, U_now, equ6_1); // phi    * dphidy * U_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly3_now, equ6_2);  // phi    * phi    * Ly3_now
         /********************************************************************************************************************************************
          Equation w7:
           mass * Ly4_new = - dt * c33 * mpml_dyy * phi * dphidy * W_now - dt * mpml_dy * phi * phi * Ly4_now + phi * phi * Ly4_now
         *********************************************************************************************************************************************/
-        csr_matvec(csr_p_size, stif6_csr_p, stif6_csr_j, stif6_csr_x, W_now, equ7_1); // phi    * dphidy * W_now
-        csr_matvec(csr_p_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly4_now, equ7_2);  // phi    * phi    * Ly4_now
+        csr_matvec(csr_p_size, csr_p, csr_j, stif6_csr_x, W_now, equ7_1); // phi    * dphidy * W_now
+        csr_matvec(csr_p_size, csr_p, csr_j, mass_csr_x, Ly4_now, equ7_2);  // phi    * phi    * Ly4_now
 
         #pragma omp parallel for private(i)
         for (i = 0; i < node_num; i++)
         {
-            rhs_w1[i] = -c[3][i] * equ1_1[i] - 2.0 * mpml_dx[i] * equ1_2[i] - mpml_dx[i] * mpml_dx[i] * equ1_3[i] + equ1_4[i] + equ1_5[i] + (i == source_node) * point_source * cos(Angle_force * pi / 180.0);
+            rhs_w1[i] = -c[3][i] * equ1_1[i] - 2.0 * mpml_dx[i] * equ1_2[i] - mpml_dx[i] * mpml_dx[i] * equ1_3[i] + equ1_4[i] + equ1_5[i];
             rhs_w2[i] = -c[3][i] * equ2_1[i] - c[1][i] * equ2_2[i] - mpml_dx[i] * equ2_3[i] - mpml_dy[i] * equ2_3[i] - mpml_dx[i] * mpml_dy[i] * equ2_4[i];
             rhs_w3[i] = -c[2][i] * equ3_1[i] - 2.0 * mpml_dy[i] * equ3_2[i] - mpml_dy[i] * mpml_dy[i] * equ3_3[i] + equ3_4[i] + equ3_5[i];
             rhs_w4[i] = -dt * c[3][i] * mpml_dxx[i] * equ4_1[i] - dt * mpml_dx[i] * equ4_2[i] + equ4_2[i];
@@ -656,6 +440,30 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
             rhs_w6[i] = -dt * c[3][i] * mpml_dxx_pyx[i] * equ6_1[i] - dt * mpml_dx[i] * equ6_2[i] + equ6_2[i];
             rhs_w7[i] = -dt * c[2][i] * mpml_dyy[i] * equ7_1[i] - dt * mpml_dy[i] * equ7_2[i] + equ7_2[i];
         }
+        if (visco != NULL)
+        {
+            // memory variables of c44 * dphidx * dphidx * W, c44 * dphidx * dphidy * U, c13 * dphidy * dphidx * U, c33 * dphidy * dphidy * W
+            #pragma omp parallel for private(decay, half, z1, z2, z3, z4)
+            for (i = 0; i < node_num; i++)
+            {
+                decay = visco[0][i];
+                half = 0.5 * (1.0 - decay);
+                z1 = zeta[4][i] + half * equ1_1[i];
+                z2 = zeta[5][i] + half * equ2_1[i];
+                z3 = zeta[6][i] + half * equ2_2[i];
+                z4 = zeta[7][i] + half * equ3_1[i];
+                rhs_w1[i] += visco[4][i] * z1;
+                rhs_w2[i] += visco[4][i] * z2 + visco[3][i] * z3;
+                rhs_w3[i] += visco[2][i] * z4;
+                zeta[4][i] = decay * z1 + half * equ1_1[i];
+                zeta[5][i] = decay * z2 + half * equ2_1[i];
+                zeta[6][i] = decay * z3 + half * equ2_2[i];
+                zeta[7][i] = decay * z4 + half * equ3_1[i];
+            }
+        }
+        // Source_y
+        for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+            rhs_w1[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot + 1];
 
         /***********************************
                  solve liner system
@@ -663,20 +471,20 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
           
           if (strcmp(solver, "pardiso") == 0)
           {
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u1, U1tt_new);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u2, U2tt_new);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u3, U3tt_new);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u4, Lx1_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u5, Lx2_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u6, Lx3_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_u7, Lx4_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w1, W1tt_new);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w2, W2tt_new);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w3, W3tt_new);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w4, Ly1_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w5, Ly2_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w6, Ly3_now);
-            pardiso_unsym(mass_csr_size, node_num, mass_csr_p, mass_csr_j, mass_csr_x, rhs_w7, Ly4_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u1, U1tt_new);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u2, U2tt_new);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u3, U3tt_new);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u4, Lx1_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u5, Lx2_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u6, Lx3_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_u7, Lx4_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w1, W1tt_new);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w2, W2tt_new);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w3, W3tt_new);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w4, Ly1_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w5, Ly2_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w6, Ly3_now);
+            pardiso_unsym(csr_size, node_num, csr_p, csr_j, mass_csr_x, rhs_w7, Ly4_now);
           }
           else if (strcmp(solver, "masslump") == 0)
             {
@@ -685,43 +493,20 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
                 {
                     if (mass_lump[i] != 0.0)
                     {
-                        
-                        if( Dirichlet_boundary_node_flag[i]==1 )
-                        {
-                            U1tt_new[i] = 0.0;
-                            U2tt_new[i] = 0.0;
-                            U3tt_new[i] = 0.0;
-                            Lx1_now[i] = 0.0;
-                            Lx2_now[i] = 0.0;
-                            Lx3_now[i] = 0.0;
-                            Lx4_now[i] = 0.0;
-                            W1tt_new[i] = 0.0;
-                            W2tt_new[i] = 0.0;
-                            W3tt_new[i] = 0.0;
-                            Ly1_now[i] = 0.0;
-                            Ly2_now[i] = 0.0;
-                            Ly3_now[i] = 0.0;
-                            Ly4_now[i] = 0.0;
-
-                        }
-                        else 
-                        {
-                            U1tt_new[i] = rhs_u1[i] / (1.0 * mass_lump[i]);
-                            U2tt_new[i] = rhs_u2[i] / (1.0 * mass_lump[i]);
-                            U3tt_new[i] = rhs_u3[i] / (1.0 * mass_lump[i]);
-                            Lx1_now[i] = rhs_u4[i] / (1.0 * mass_lump[i]);
-                            Lx2_now[i] = rhs_u5[i] / (1.0 * mass_lump[i]);
-                            Lx3_now[i] = rhs_u6[i] / (1.0 * mass_lump[i]);
-                            Lx4_now[i] = rhs_u7[i] / (1.0 * mass_lump[i]);
-                            W1tt_new[i] = rhs_w1[i] / (1.0 * mass_lump[i]);
-                            W2tt_new[i] = rhs_w2[i] / (1.0 * mass_lump[i]);
-                            W3tt_new[i] = rhs_w3[i] / (1.0 * mass_lump[i]);
-                            Ly1_now[i] = rhs_w4[i] / (1.0 * mass_lump[i]);
-                            Ly2_now[i] = rhs_w5[i] / (1.0 * mass_lump[i]);
-                            Ly3_now[i] = rhs_w6[i] / (1.0 * mass_lump[i]);
-                            Ly4_now[i] = rhs_w7[i] / (1.0 * mass_lump[i]);
-                        }
-
+                        U1tt_new[i] = rhs_u1[i] / (1.0 * mass_lump[i]);
+                        U2tt_new[i] = rhs_u2[i] / (1.0 * mass_lump[i]);
+                        U3tt_new[i] = rhs_u3[i] / (1.0 * mass_lump[i]);
+                        Lx1_now[i] = rhs_u4[i] / (1.0 * mass_lump[i]);
+                        Lx2_now[i] = rhs_u5[i] / (1.0 * mass_lump[i]);
+                        Lx3_now[i] = rhs_u6[i] / (1.0 * mass_lump[i]);
+                        Lx4_now[i] = rhs_u7[i] / (1.0 * mass_lump[i]);
+                        W1tt_new[i] = rhs_w1[i] / (1.0 * mass_lump[i]);
+                        W2tt_new[i] = rhs_w2[i] / (1.0 * mass_lump[i]);
+                        W3tt_new[i] = rhs_w3[i] / (1.0 * mass_lump[i]);
+                        Ly1_now[i] = rhs_w4[i] / (1.0 * mass_lump[i]);
+                        Ly2_now[i] = rhs_w5[i] / (1.0 * mass_lump[i]);
+                        Ly3_now[i] = rhs_w6[i] / (1.0 * mass_lump[i]);
+                        Ly4_now[i] = rhs_w7[i] / (1.0 * mass_lump[i]);
                     }
                     else
                         printf("ELASTIC_WAVE - Fatal Error: zero value in the mass_csr_lumped\n"); // in case zero value
@@ -729,20 +514,20 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
             }
             else if (strcmp(solver, "mgmres") == 0)
             {
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, U1tt_new, rhs_u1, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, U2tt_new, rhs_u2, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, U3tt_new, rhs_u3, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx1_now, rhs_u4, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx2_now, rhs_u5, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx3_now, rhs_u6, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Lx4_now, rhs_u7, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, W1tt_new, rhs_w1, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, W2tt_new, rhs_w2, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, W3tt_new, rhs_w3, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly1_now, rhs_w4, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly2_now, rhs_w5, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly3_now, rhs_w6, itr_max, mr, tol_abs, tol_rel);
-                pmgmres_ilu_cr(node_num, mass_csr_size, mass_csr_p, mass_csr_j, mass_csr_x, Ly4_now, rhs_w7, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, U1tt_new, rhs_u1, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, U2tt_new, rhs_u2, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, U3tt_new, rhs_u3, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Lx1_now, rhs_u4, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Lx2_now, rhs_u5, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Lx3_now, rhs_u6, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Lx4_now, rhs_u7, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, W1tt_new, rhs_w1, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, W2tt_new, rhs_w2, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, W3tt_new, rhs_w3, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Ly1_now, rhs_w4, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Ly2_now, rhs_w5, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Ly3_now, rhs_w6, itr_max, mr, tol_abs, tol_rel);
+                pmgmres_ilu_cr(node_num, csr_size, csr_p, csr_j, mass_csr_x, Ly4_now, rhs_w7, itr_max, mr, tol_abs, tol_rel);
             }
             else
             {
@@ -751,6 +536,26 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
                 fprintf(stderr, "  Solver type is not set = \"%s\".\n", solver);
                 exit(1);
             }
+            // boundary condition: zero on the Dirichlet list only
+            #pragma omp parallel for private(i)
+            for (k = 0; k < dirichlet_num; k++)
+            {
+                i = dirichlet_node[k];
+                U1tt_new[i] = 0.0;
+                U2tt_new[i] = 0.0;
+                U3tt_new[i] = 0.0;
+                Lx1_now[i] = 0.0;
+                Lx2_now[i] = 0.0;
+                Lx3_now[i] = 0.0;
+                Lx4_now[i] = 0.0;
+                W1tt_new[i] = 0.0;
+                W2tt_new[i] = 0.0;
+                W3tt_new[i] = 0.0;
+                Ly1_now[i] = 0.0;
+                Ly2_now[i] = 0.0;
+                Ly3_now[i] = 0.0;
+                Ly4_now[i] = 0.0;
+            }
             #pragma omp parallel for private(i)
             for (i = 0; i < node_num; i++)
             {
@@ -786,20 +591,32 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
             }
             for (i = 0; i < rec_num; i++)
             {
-                seismogram_u[i] = U_now[rec_node[i]];
-                seismogram_w[i] = W_now[rec_node[i]];
+                seismogram_u[i] = 0.0;
+                seismogram_w[i] = 0.0;
+                for (k = 0; k < point_order; k++)
+                {
+                    seismogram_u[i] += rec_weight[i * point_order + k] * U_now[rec_node[i * point_order + k]];
+                    seismogram_w[i] += rec_weight[i * point_order + k] * W_now[rec_node[i * point_order + k]];
+                }
                 fprintf(fp_seismogram_u, "%f   ", seismogram_u[i]);
                 fprintf(fp_seismogram_w, "%f   ", seismogram_w[i]);
+                if (seismogram_all != NULL)
+                {
+                    seismogram_all[((size_t)it * 2) * rec_num + i] = seismogram_u[i];
+                    seismogram_all[((size_t)it * 2 + 1) * rec_num + i] = seismogram_w[i];
+                }
             }
             fprintf(fp_seismogram_u, "\n");
             fprintf(fp_seismogram_w, "\n");
+            if (dft_freq_num > 0)
+                wavefield_dft(dft_freq_num, dft_freq, dft_num, dft_node, node_new, time, dt, U_now, W_now, dft);
 
             if ((it + 1) % 200 == 0)
             {
                 for (i = 0; i < node_num; i++)
                 {
-                    fprintf(fp_wavefield_u, "%f	", U_now[i]);
-                    fprintf(fp_wavefield_w, "%f	", W_now[i]);
+                    fprintf(fp_wavefield_u, "%f	", U_now[node_new[i]]);
+                    fprintf(fp_wavefield_w, "%f	", W_now[node_new[i]]);
                 }
                 fprintf(fp_wavefield_u, "\n");
                 fprintf(fp_wavefield_w, "\n");
@@ -810,59 +627,19 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
 
         printf("\nTime iteration end!\n");
         fclose(fp_wavefield_u);
-        fclose(fp_wavefield_u);
+        fclose(fp_wavefield_w);
        // fclose(fp_energy_u);
        // fclose(fp_energy_w);
         fclose(fp_seismogram_u);
         fclose(fp_seismogram_w);
+        if (seismogram_all != NULL)
+            reciprocity_write(shot, rec_num, step, seismogram_all);
+        if (dft_freq_num > 0)
+        {
+            sprintf(filename_dft, "./outputfile/dft_%s_%d.bin", shot_name, shot + 1);
+            wavefield_dft_write(filename_dft, dft_freq_num, dft_freq, dft_num, dft_node, dft);
+        }
     }
-    free(mass_coo_i);
-    free(mass_coo_j);
-    free(mass_coo_x);
-    free(stif_coo_i);
-    free(stif_coo_j);
-    free(stif_coo_x);
-    free(rho);
-    free(vp);
-    free(vs);
-    for (i = 0; i < 4; i++)
-        free(c[i]);
-    free(c);
-    free(mpml_dx);
-    free(mpml_dy);
-    free(mpml_dxx);
-    free(mpml_dyy);
-    free(mpml_dxx_pyx);
-    free(mpml_dyy_pxy);
-    free(mass_csr_j_temp);
-    free(mass_csr_x_temp);
-    free(stif_csr_j_temp);
-    free(stif_csr_x_temp);
-    free(mass_lump);
-    free(mass_csr_p);
-    free(mass_csr_j);
-    free(mass_csr_x);
-    free(mass_csc_p);
-    free(mass_csc_j);
-    free(mass_csc_x);
-    free(stif1_csr_p);
-    free(stif1_csr_j);
-    free(stif1_csr_x);
-    free(stif2_csr_p);
-    free(stif2_csr_j);
-    free(stif2_csr_x);
-    free(stif3_csr_p);
-    free(stif3_csr_j);
-    free(stif3_csr_x);
-    free(stif4_csr_p);
-    free(stif4_csr_j);
-    free(stif4_csr_x);
-    free(stif5_csr_p);
-    free(stif5_csr_j);
-    free(stif5_csr_x);
-    free(stif6_csr_p);
-    free(stif6_csr_j);
-    free(stif6_csr_x);
     free(seismogram_u);
     free(seismogram_w);
     free(Energy_u);
@@ -937,5 +714,8 @@ void elastic_wave(char *type, int node_num, int element_num, int element_order,
     free(rhs_w5);
     free(rhs_w6);
     free(rhs_w7);
+    for (k = 0; k < 8; k++)
+        free(zeta[k]);
+    free(dft);
     printf("\n Elastic_wave Normal End!\n");
 }
@@ -0,0 +1,231 @@
+void elastic_wave_aperture(int wave_type, char *type, int node_num, int element_num, int element_order, int *element_node, double **node_xy,
+                           int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x,
+                           double *vp, double **c, int pml_nx, int pml_ny, int *boundary_side, int dirichlet_mask,
+                           int step, double dt, double f0, double t0, double edge_size, double xmin, double xmax, double ymin, double ymax,
+                           int shot_num, int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *wavelet, double *shot_force, char *shot_name,
+                           int rec_num, int *rec_node, double *rec_weight, int point_order,
+                           double *seismogram_all, int *node_new, char *solver)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_wave_aperture runs every shot of elastic_wave on the part of the model it can see
+    in the recording time only (see aperture_window). For every shot:
+
+    1. the elements in the window and their nodes, see mesh_submesh;
+    2. the operator of the full model restricted to the sub nodes, see csr_restrict: the
+       mass, stif1-6, mass_lump and c of the sub-domain are gathered from the assembled
+       arrays of the full model, nothing is assembled again;
+    3. the boundary edges of the sub-domain (mesh_boundary_edge) tagged on its box by
+       mesh_boundary_tag: a side of the window on a side of the model keeps the rule of
+       boundary_side (see seisfem), a side cut in the model is absorbing. The Gmsh physical
+       groups of the model are not carried to the window;
+    4. the mpml profiles of abc_mpml on the box of the sub-domain and the nodes of the edges
+       in dirichlet_mask (mesh_boundary_node);
+    5. elastic_wave, or acoustic / acoustic_pml for wave_type = 1 / 2, for this shot with
+       the sources and receivers on the sub nodes. A receiver records zero unless all of its
+       point_order nodes with a weight are in the window.
+
+    The seismograms are those of the full model, the wavefield snapshots hold the sub nodes
+    only, in the order of the mesh files, listed in aperture_node_<shot_name>_<shot>.txt
+    (from 1).
+*/
+{
+  int i, j, k, shot, node_sub_num, element_sub_num, csr_size_sub, rec_out;
+  int edge_sub_num, dirichlet_sub_num;
+  int side_sub[5];
+  double vp_max, radius, margin;
+  double window[4], box[4];
+  int *node_sub = NULL;
+  int *node_sub_old = NULL;
+  int *node_new_sub = NULL;
+  int *element_node_sub = NULL;
+  int *csr_p_sub = NULL;
+  int *csr_j_sub = NULL;
+  int *csr_map = NULL;
+  int *edge_node_sub = NULL;
+  int *edge_element_sub = NULL;
+  int *edge_tag_sub = NULL;
+  int *dirichlet_sub = NULL;
+  int *inj_node_sub = NULL;
+  double *inj_weight_sub = NULL;
+  int *rec_node_sub = NULL;
+  double *rec_weight_sub = NULL;
+  double *mass_csr_x_sub = NULL;
+  double *mass_lump_sub = NULL;
+  double *stif_csr_x_sub[6];
+  double *node_xy_sub[2];
+  double *c_sub[4];
+  double *mpml_sub[6];
+  char filename_node[128];
+  FILE *fp_node;
+
+  vp_max = vp[0];
+  for (i = 0; i < node_num; i++)
+    vp_max = fmax(vp_max, vp[i]);
+  radius = vp_max * step * dt;
+  margin = fmax(pml_nx, pml_ny) * edge_size;
+
+  node_sub = (int *)malloc(node_num * sizeof(int));
+  node_sub_old = (int *)malloc(node_num * sizeof(int));
+  node_new_sub = (int *)malloc(node_num * sizeof(int));
+  element_node_sub = (int *)malloc((size_t)element_num * element_order * sizeof(int));
+  csr_p_sub = (int *)malloc((node_num + 1) * sizeof(int));
+  dirichlet_sub = (int *)malloc(node_num * sizeof(int));
+  inj_node_sub = (int *)malloc(shot_p[shot_num] * sizeof(int));
+  inj_weight_sub = (double *)malloc(shot_p[shot_num] * sizeof(double));
+  rec_node_sub = (int *)malloc(rec_num * point_order * sizeof(int));
+  rec_weight_sub = (double *)malloc(rec_num * point_order * sizeof(double));
+
+  for (shot = 0; shot < shot_num; shot++)
+  {
+    aperture_window(node_xy, shot, shot_p, inj_node, inj_weight, rec_num, rec_node, rec_weight, point_order,
+                    radius, margin, xmin, xmax, ymin, ymax, window);
+    node_sub_num = mesh_submesh(node_num, element_num, element_order, element_node, node_xy, window,
+                                node_sub, node_sub_old, &element_sub_num, element_node_sub);
+
+    /***************************************
+       sub-domain: nodes, model and operator
+       gathered from the full model
+    ****************************************/
+    for (i = 0; i < 2; i++)
+      node_xy_sub[i] = (double *)malloc(node_sub_num * sizeof(double));
+    for (i = 0; i < 4; i++)
+      c_sub[i] = (double *)malloc(node_sub_num * sizeof(double));
+    mass_lump_sub = (double *)malloc(node_sub_num * sizeof(double));
+    box[0] = xmax;
+    box[1] = xmin;
+    box[2] = ymax;
+    box[3] = ymin;
+    for (i = 0; i < node_sub_num; i++)
+    {
+      node_xy_sub[0][i] = node_xy[0][node_sub_old[i]];
+      node_xy_sub[1][i] = node_xy[1][node_sub_old[i]];
+      for (k = 0; k < 4; k++)
+        c_sub[k][i] = c[k][node_sub_old[i]];
+      mass_lump_sub[i] = mass_lump[node_sub_old[i]];
+      box[0] = fmin(box[0], node_xy_sub[0][i]);
+      box[1] = fmax(box[1], node_xy_sub[0][i]);
+      box[2] = fmin(box[2], node_xy_sub[1][i]);
+      box[3] = fmax(box[3], node_xy_sub[1][i]);
+    }
+
+    csr_j_sub = csr_restrict(csr_p, csr_j, node_sub, node_sub_num, node_sub_old, csr_p_sub, &csr_size_sub, &csr_map);
+    mass_csr_x_sub = (double *)malloc(csr_size_sub * sizeof(double));
+    for (i = 0; i < 6; i++)
+      stif_csr_x_sub[i] = (double *)malloc(csr_size_sub * sizeof(double));
+    #pragma omp parallel for private(i)
+    for (k = 0; k < csr_size_sub; k++)
+    {
+      mass_csr_x_sub[k] = mass_csr_x[csr_map[k]];
+      for (i = 0; i < 6; i++)
+        stif_csr_x_sub[i][k] = stif_csr_x[i][csr_map[k]];
+    }
+
+    /***************************************
+       boundary of the sub-domain: the sides of
+       the model keep their rule, the cut sides
+       are absorbing; mpml on its box
+    ****************************************/
+    side_sub[0] = (box[0] <= xmin + edge_size / 4.0) ? boundary_side[0] : 1;
+    side_sub[1] = (box[1] >= xmax - edge_size / 4.0) ? boundary_side[1] : 1;
+    side_sub[2] = (box[2] <= ymin + edge_size / 4.0) ? boundary_side[2] : 1;
+    side_sub[3] = (box[3] >= ymax - edge_size / 4.0) ? boundary_side[3] : 1;
+    side_sub[4] = boundary_side[4];
+    edge_sub_num = mesh_boundary_edge(type, element_sub_num, element_order, element_node_sub, &edge_node_sub, &edge_element_sub);
+    edge_tag_sub = (int *)malloc(edge_sub_num * sizeof(int));
+    mesh_boundary_tag(edge_sub_num, edge_node_sub, node_xy_sub, edge_size, box[0], box[1], box[2], box[3], side_sub, edge_tag_sub);
+    dirichlet_sub_num = mesh_boundary_node(node_sub_num, element_order, element_node_sub, node_xy_sub, edge_sub_num, edge_node_sub, edge_element_sub,
+                                           edge_tag_sub, dirichlet_mask, dirichlet_sub);
+    for (i = 0; i < 6; i++)
+      mpml_sub[i] = (double *)malloc(node_sub_num * sizeof(double));
+    abc_mpml(node_sub_num, element_sub_num, element_order, element_node_sub, node_xy_sub, pml_nx, pml_ny, edge_size, box[0], box[1], box[2], box[3], vp_max,
+             side_sub[0] == 1, side_sub[1] == 1, side_sub[2] == 1, side_sub[3] == 1, mpml_sub[0], mpml_sub[1], mpml_sub[2], mpml_sub[3], mpml_sub[4], mpml_sub[5]);
+
+    /***************************************
+       sources, receivers and snapshot order
+       on the sub nodes
+    ****************************************/
+    for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+    {
+      inj_node_sub[k] = (node_sub[inj_node[k]] >= 0) ? node_sub[inj_node[k]] : 0;
+      inj_weight_sub[k] = (node_sub[inj_node[k]] >= 0) ? inj_weight[k] : 0.0;
+    }
+    rec_out = 0;
+    for (i = 0; i < rec_num; i++)
+    {
+      // a receiver with a node out of the window records zero, not part of its sum
+      k = 0;
+      for (j = 0; j < point_order; j++)
+        k = k + (node_sub[rec_node[i * point_order + j]] < 0 && rec_weight[i * point_order + j] != 0.0);
+      for (j = 0; j < point_order; j++)
+      {
+        rec_node_sub[i * point_order + j] = (node_sub[rec_node[i * point_order + j]] >= 0) ? node_sub[rec_node[i * point_order + j]] : 0;
+        rec_weight_sub[i * point_order + j] = (k == 0 && node_sub[rec_node[i * point_order + j]] >= 0) ? rec_weight[i * point_order + j] : 0.0;
+      }
+      rec_out = rec_out + (k > 0);
+    }
+    sprintf(filename_node, "./outputfile/aperture_node_%s_%d.txt", shot_name, shot + 1);
+    if ((fp_node = fopen(filename_node, "w")) == NULL)
+      printf("\n %s file cannot open\n", filename_node);
+    k = 0;
+    for (i = 0; i < node_num; i++)
+    {
+      if (node_sub[node_new[i]] < 0)
+        continue;
+      node_new_sub[k] = node_sub[node_new[i]];
+      k++;
+      if (fp_node != NULL)
+        fprintf(fp_node, "%d\n", i + 1);
+    }
+    if (fp_node != NULL)
+      fclose(fp_node);
+
+    printf("\n aperture is         x %f to %f, y %f to %f m: %d of %d nodes, %d receivers out\n",
+           box[0], box[1], box[2], box[3], node_sub_num, node_num, rec_out);
+
+    if (wave_type == 1)
+      acoustic(node_sub_num, node_xy_sub, node_sub_num + 1, csr_size_sub, csr_p_sub, csr_j_sub, mass_csr_x_sub, mass_lump_sub, stif_csr_x_sub, c_sub,
+               step, dt, shot, shot + 1, shot_p, inj_node_sub, inj_weight_sub, inj_src, wavelet, shot_name,
+               rec_num, rec_node_sub, rec_weight_sub, point_order, node_new_sub, solver, dirichlet_sub_num, dirichlet_sub);
+    else if (wave_type == 2)
+      acoustic_pml(node_sub_num, node_xy_sub, node_sub_num + 1, csr_size_sub, csr_p_sub, csr_j_sub, mass_csr_x_sub, mass_lump_sub, stif_csr_x_sub,
+                   c_sub, mpml_sub[0], mpml_sub[1], mpml_sub[2], mpml_sub[3],
+                   step, dt, shot, shot + 1, shot_p, inj_node_sub, inj_weight_sub, inj_src, wavelet, shot_name,
+                   rec_num, rec_node_sub, rec_weight_sub, point_order, node_new_sub, solver, dirichlet_sub_num, dirichlet_sub);
+    else
+      elastic_wave(node_sub_num, node_xy_sub, node_sub_num + 1, csr_size_sub, csr_p_sub, csr_j_sub, mass_csr_x_sub, mass_lump_sub, stif_csr_x_sub,
+                   c_sub, mpml_sub[0], mpml_sub[1], mpml_sub[2], mpml_sub[3], mpml_sub[4], mpml_sub[5],
+                   step, dt, f0, t0, shot, shot + 1, shot_p, inj_node_sub, inj_weight_sub, inj_src, wavelet, shot_force, shot_name,
+                   rec_num, rec_node_sub, rec_weight_sub, point_order, seismogram_all, node_new_sub, solver, dirichlet_sub_num, dirichlet_sub, NULL,
+                   0, NULL, 0, NULL);
+
+    for (i = 0; i < 2; i++)
+      free(node_xy_sub[i]);
+    for (i = 0; i < 4; i++)
+      free(c_sub[i]);
+    for (i = 0; i < 6; i++)
+    {
+      free(stif_csr_x_sub[i]);
+      free(mpml_sub[i]);
+    }
+    free(mass_lump_sub);
+    free(mass_csr_x_sub);
+    free(csr_j_sub);
+    free(csr_map);
+    free(edge_node_sub);
+    free(edge_element_sub);
+    free(edge_tag_sub);
+  }
+
+  free(node_sub);
+  free(node_sub_old);
+  free(node_new_sub);
+  free(element_node_sub);
+  free(csr_p_sub);
+  free(dirichlet_sub);
+  free(inj_node_sub);
+  free(inj_weight_sub);
+  free(rec_node_sub);
+  free(rec_weight_sub);
+}
@@ -0,0 +1,213 @@
+void elastic_wave_cpml(int node_num, double **node_xy, int csr_p_size, int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x, \
+                       double **c, double *cpml_ax, double *cpml_bx, double *cpml_ay, double *cpml_by,                                                     \
+                       int step, double dt,                                                                                                                \
+                       int shot_first, int shot_num, int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *wavelet, double *shot_force, char *shot_name, \
+                       int rec_num, int *rec_node, double *rec_weight, int point_order,                                                                    \
+                       double *seismogram_all, int *node_new, char *solver, int dirichlet_num, int *dirichlet_node, \
+                       int dft_freq_num, double *dft_freq, int dft_num, int *dft_node)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_wave_cpml is elastic_wave with the c-pml of abc_cpml instead of the split mpml:
+    u and w are not split, only the stiffness terms are stretched. The terms of the u equation
+    are grouped by their derivatives,
+
+      A = - c11 * dphidx * dphidx * U                      (x x)
+      B = - c44 * dphidy * dphidy * U                      (y y)
+      C = - c13 * dphidx * dphidy * W - c44 * dphidy * dphidx * W   (x y)
+
+    and A / s_x^2 + B / s_y^2 + C / (s_x s_y) is applied node by node, every 1 / s by one
+    recursive convolution (see abc_cpml), the same for the w equation with c44, c33 and
+    c44, c13. That is 2 memory variables per group, 12 arrays over the pml nodes only,
+    in place of the 3 parts of u and w with their t and tt histories and the 8 Lx, Ly
+    arrays over all the nodes. The derivative of the profiles (mpml_dxx, mpml_dyy of the
+    mpml) is left out, the profile is taken as constant over an element.
+
+    mass * Utt_new = A' + B' + C' + Source_x, with the Newmark scheme of elastic_wave.
+
+    With the masslump solver every node is updated in a single parallel loop over the csr
+    rows: the 8 stiffness products are summed in one pass over csr_j, the convolutions,
+    the division by the lumped mass and the Newmark step follow in the same pass. U and W
+    are read across the rows, they are written to second arrays. The time step is
+    elastic_cpml_step.
+
+    The shots, sources, receivers, output files, seismogram_all, the Dirichlet list and the
+    wavefield dft are those of elastic_wave.
+*/
+{
+    /***************************************
+             time evolution parameters
+     ****************************************/
+    int i, k, it, shot, pml_num;
+    double time;
+    double *U_now = NULL, *W_now = NULL;
+    double *field[6]; // U, Ut, Utt, W, Wt, Wtt, see elastic_cpml_step
+    double *work[6] = {NULL, NULL, NULL, NULL, NULL, NULL};
+    double *source_u = NULL, *source_w = NULL;
+    double *seismogram_u = NULL, *seismogram_w = NULL;
+    /***************************************
+       c-pml memory variables, pml nodes only
+     ****************************************/
+    int *pml_index = NULL;
+    double *psi[12];
+    double *dft = NULL;
+    size_t d, dft_size = (size_t)dft_freq_num * 4 * dft_num; // u, w of every frequency, real and imaginary
+    /***************************************
+                  file pointers
+     ****************************************/
+    FILE *fp_wavefield_u,  *fp_wavefield_w;
+    FILE *fp_seismogram_u, *fp_seismogram_w;
+    char filename_wavefield_u[128],  filename_wavefield_w[128];
+    char filename_seismogram_u[128], filename_seismogram_w[128];
+    char filename_dft[128];
+
+    pml_index = (int *)malloc(node_num * sizeof(int));
+    pml_num = 0;
+    for (i = 0; i < node_num; i++)
+    {
+        if (cpml_ax[i] != 0.0 || cpml_ay[i] != 0.0)
+        {
+            pml_index[i] = pml_num;
+            pml_num++;
+        }
+        else
+            pml_index[i] = -1;
+    }
+    for (k = 0; k < 12; k++)
+        psi[k] = (double *)malloc(pml_num * sizeof(double));
+    printf("\n c-pml nodes is      %d of %d\n", pml_num, node_num);
+
+    seismogram_u = (double *)malloc(rec_num * sizeof(double));
+    seismogram_w = (double *)malloc(rec_num * sizeof(double));
+    for (k = 0; k < 6; k++)
+        field[k] = (double *)malloc(node_num * sizeof(double));
+    work[0] = (double *)malloc(node_num * sizeof(double));
+    work[1] = (double *)malloc(node_num * sizeof(double));
+    source_u = (double *)calloc(node_num, sizeof(double));
+    source_w = (double *)calloc(node_num, sizeof(double));
+    if (strcmp(solver, "masslump") != 0)
+    {
+        for (k = 2; k < 6; k++)
+            work[k] = (double *)calloc(node_num, sizeof(double));
+    }
+    if (dft_freq_num > 0)
+        dft = (double *)malloc(dft_size * sizeof(double));
+
+    for (shot = shot_first; shot < shot_num; shot++)
+    {
+        printf("\n ######## Shot num: %d ########\n", shot + 1);
+
+        sprintf(filename_wavefield_u, "./outputfile/wavefield_u_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_wavefield_w, "./outputfile/wavefield_w_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_u, "./outputfile/seismogram_u_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_w, "./outputfile/seismogram_w_%s_%d.txt", shot_name, shot + 1);
+        fp_wavefield_u = fopen(filename_wavefield_u, "w");
+        fp_wavefield_w = fopen(filename_wavefield_w, "w");
+        fp_seismogram_u = fopen(filename_seismogram_u, "w");
+        fp_seismogram_w = fopen(filename_seismogram_w, "w");
+
+        for (k = 0; k < 6; k++)
+        {
+            #pragma omp parallel for
+            for (i = 0; i < node_num; i++)
+                field[k][i] = 0.0;
+        }
+        U_now = field[0];
+        W_now = field[3];
+        for (k = 0; k < 12; k++)
+        {
+            for (i = 0; i < pml_num; i++)
+                psi[k][i] = 0.0;
+        }
+        for (d = 0; d < dft_size; d++)
+            dft[d] = 0.0;
+        for (i = 0; i < node_num; i++)
+        {
+            fprintf(fp_wavefield_u, "%f	", U_now[i]);
+            fprintf(fp_wavefield_w, "%f	", W_now[i]);
+        }
+        fprintf(fp_wavefield_u, "\n");
+        fprintf(fp_wavefield_w, "\n");
+
+        // begin iteration: from 0 to step-1, time = (step + 1) * dt
+        printf("\n****Time iteration begin:\n");
+        for (it = 2; it < step; it++)
+        {
+            time = (it + 1) * dt;
+            if ((it + 1) % 100 == 0)
+                printf("\n ****Iteration step: %-d, time: %-f s\n ", it + 1, time);
+
+            // Source_x and Source_y, sparse: only the nodes in the injection list of the shot
+            for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+            {
+                source_u[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot];
+                source_w[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot + 1];
+            }
+
+            elastic_cpml_step(node_num, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, cpml_ax, cpml_bx, cpml_ay, cpml_by,
+                              pml_index, psi, dt, 0, field, work, source_u, source_w, solver, dirichlet_num, dirichlet_node);
+            U_now = field[0];
+            W_now = field[3];
+
+            for (i = 0; i < rec_num; i++)
+            {
+                seismogram_u[i] = 0.0;
+                seismogram_w[i] = 0.0;
+                for (k = 0; k < point_order; k++)
+                {
+                    seismogram_u[i] += rec_weight[i * point_order + k] * U_now[rec_node[i * point_order + k]];
+                    seismogram_w[i] += rec_weight[i * point_order + k] * W_now[rec_node[i * point_order + k]];
+                }
+                fprintf(fp_seismogram_u, "%f   ", seismogram_u[i]);
+                fprintf(fp_seismogram_w, "%f   ", seismogram_w[i]);
+                if (seismogram_all != NULL)
+                {
+                    seismogram_all[((size_t)it * 2) * rec_num + i] = seismogram_u[i];
+                    seismogram_all[((size_t)it * 2 + 1) * rec_num + i] = seismogram_w[i];
+                }
+            }
+            fprintf(fp_seismogram_u, "\n");
+            fprintf(fp_seismogram_w, "\n");
+            if (dft_freq_num > 0)
+                wavefield_dft(dft_freq_num, dft_freq, dft_num, dft_node, node_new, time, dt, U_now, W_now, dft);
+
+            if ((it + 1) % 200 == 0)
+            {
+                for (i = 0; i < node_num; i++)
+                {
+                    fprintf(fp_wavefield_u, "%f	", U_now[node_new[i]]);
+                    fprintf(fp_wavefield_w, "%f	", W_now[node_new[i]]);
+                }
+                fprintf(fp_wavefield_u, "\n");
+                fprintf(fp_wavefield_w, "\n");
+            }
+        }
+
+        printf("\nTime iteration end!\n");
+        fclose(fp_wavefield_u);
+        fclose(fp_wavefield_w);
+        fclose(fp_seismogram_u);
+        fclose(fp_seismogram_w);
+        if (seismogram_all != NULL)
+            reciprocity_write(shot, rec_num, step, seismogram_all);
+        if (dft_freq_num > 0)
+        {
+            sprintf(filename_dft, "./outputfile/dft_%s_%d.bin", shot_name, shot + 1);
+            wavefield_dft_write(filename_dft, dft_freq_num, dft_freq, dft_num, dft_node, dft);
+        }
+    }
+    free(seismogram_u);
+    free(seismogram_w);
+    for (k = 0; k < 6; k++)
+    {
+        free(field[k]);
+        free(work[k]);
+    }
+    free(source_u);
+    free(source_w);
+    free(pml_index);
+    for (k = 0; k < 12; k++)
+        free(psi[k]);
+    free(dft);
+}
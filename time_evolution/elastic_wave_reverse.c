@@ -0,0 +1,533 @@
+void elastic_wave_reverse(int node_num, int csr_size, int *csr_p, int *csr_j, double *mass_csr_x, double *mass_lump, double **stif_csr_x, double **c, \
+                          double *cpml_ax, double *cpml_bx, double *cpml_ay, double *cpml_by,                                                       \
+                          int step, double dt,                                                                                                      \
+                          int shot_num, int *shot_p, int *inj_node, double *inj_weight, int *inj_src, double *wavelet, double *shot_force, char *shot_name, \
+                          int rec_num, int *rec_node, double *rec_weight, int point_order,                                                          \
+                          int *node_new, char *solver, int dirichlet_num, int *dirichlet_node, int reverse, double checkpoint_memory, int checkpoint_disk, \
+                          int adjoint, char *observed, double *rho)
+/******************************************************************************/
+/*
+  Purpose:
+
+    elastic_wave_reverse runs every shot of elastic_wave_cpml forward and then goes back over
+    its states, from the last time step to the first, as the adjoint of a gradient or a
+    reverse time migration needs them. The states are not all kept: the state of a time step
+    (U, Ut, Utt, W, Wt, Wtt and the 12 psi of the pml nodes, see elastic_cpml_step) is stored
+    in as many checkpoints as checkpoint_memory (MB) holds, in memory or with
+    checkpoint_disk = 1 in the files of checkpoint_copy (removed at the end), and the steps between two
+    checkpoints are run again when they are needed, in the order of the binomial schedule of
+    revolve (the least forward steps for that number of checkpoints). The number of forward
+    steps, against step - 2 for the forward run alone, is written for every shot.
+
+    With reverse = 2 (lumped mass only) the shot is run forward once and the states are
+    rebuilt on the way back by elastic_boundary_step, the time step backward inside the
+    pml: only U and W of the nodes next to the pml are saved at every step, in memory or with
+    checkpoint_disk = 1 in ./outputfile/boundary.bin (boundary_copy, removed at the end),
+    a stream of the size of a side of the model instead of all the model. The states going
+    back are then U, W off the pml nodes and Utt, Wtt off the pml nodes and the nodes next to
+    it, zero on them: the illumination, image and gradients are zero on the pml nodes.
+
+    The seismograms are written when a step is reached for the first time, as in
+    elastic_wave_cpml. On the way back the source illumination, the sum of (u^2 + w^2) * dt
+    over the time steps, is summed at every node and written at the end of the shot to
+    illumination_shot_1.bin, ..., node_num double in the node order of the mesh files.
+
+    With adjoint = 1 or 2 (lumped mass) the adjoint wave lambda is run on the way back with
+    elastic_cpml_step (transpose = 1), from the last time step, with the receiver data of
+    the step as a source at rec_node (rec_weight times the value times dt): the seismograms of
+    the directory observed (seismogram_u_shot_1.txt, ... as elastic_wave_cpml writes them) for
+    a reverse time migration, adjoint = 1, or the residuals synthetic - observed of the misfit
+    0.5 * sum (synthetic - observed)^2 * dt, adjoint = 2. lambda before the step of state n is
+    the adjoint of state n, after it the adjoint of the step that ended in state n, so that
+
+      adjoint = 1: image = sum (U lambda_u + W lambda_w) * dt
+      adjoint = 2: rho gradient = - sum (lambda_u Utt + lambda_w Wtt) * mass_lump / rho
+                   c11, c13, c33, c44 gradients, see elastic_gradient
+
+    are summed at the nodes over the time steps and the shots (mass_lump / rho leaves out the
+    scaling of the lumped mass by the whole model, see mass_sparse_update). Only the sums are
+    written at the end, to ./outputfile/image.bin (node_num double) or gradient.bin (rho, c11,
+    c13, c33, c44, node_num double each), in the node order of the mesh files.
+*/
+{
+    /***************************************
+             time evolution parameters
+     ****************************************/
+    int i, k, a, it, shot, pml_num, ring_num, state_num, snap_num, action_num, current, reached;
+    long long forward_num;
+    double state_size, stream_size;
+    double *field[6]; // U, Ut, Utt, W, Wt, Wtt, see elastic_cpml_step
+    double *work[6] = {NULL, NULL, NULL, NULL, NULL, NULL};
+    double *source_u = NULL, *source_w = NULL;
+    double *seismogram_u = NULL, *seismogram_w = NULL;
+    double *illumination = NULL;
+    /***************************************
+       adjoint wave, its pml and work arrays,
+       the data of the receivers at every state
+     ****************************************/
+    double *lambda[6], *lambda_work[6] = {NULL, NULL, NULL, NULL, NULL, NULL}, *lambda_psi[12];
+    double *synthetic_u = NULL, *synthetic_w = NULL;
+    double *observed_u = NULL, *observed_w = NULL;
+    double *image = NULL;
+    double *gradient[5];
+    double residual_u, residual_w, misfit, misfit_sum;
+    /***************************************
+       c-pml memory variables, pml nodes only
+     ****************************************/
+    int *pml_index = NULL;
+    double *psi[12];
+    /***************************************
+       checkpoints: the 18 arrays of a state,
+       the schedule of revolve
+     ****************************************/
+    int array_size[18];
+    double *array[18];
+    double *memory = NULL;
+    int *slot_state = NULL;
+    int *action = NULL;
+    int *action_arg = NULL;
+    /***************************************
+       boundary stream of reverse = 2: the
+       nodes next to the pml, u and w of a step
+     ****************************************/
+    int *ring_index = NULL;
+    int *ring_node = NULL;
+    double *ring_value = NULL;
+    FILE *fp_boundary = NULL;
+    /***************************************
+                  file pointers
+     ****************************************/
+    FILE *fp_seismogram_u, *fp_seismogram_w, *fp_illumination, *fp_adjoint;
+    char filename_seismogram_u[128], filename_seismogram_w[128], filename_illumination[128];
+
+    pml_index = (int *)malloc(node_num * sizeof(int));
+    pml_num = 0;
+    for (i = 0; i < node_num; i++)
+    {
+        if (cpml_ax[i] != 0.0 || cpml_ay[i] != 0.0)
+        {
+            pml_index[i] = pml_num;
+            pml_num++;
+        }
+        else
+            pml_index[i] = -1;
+    }
+    for (k = 0; k < 12; k++)
+        psi[k] = (double *)malloc(pml_num * sizeof(double));
+    for (k = 0; k < 6; k++)
+    {
+        field[k] = (double *)malloc(node_num * sizeof(double));
+        array_size[k] = node_num;
+    }
+    for (k = 0; k < 12; k++)
+    {
+        array[6 + k] = psi[k];
+        array_size[6 + k] = pml_num;
+    }
+    work[0] = (double *)malloc(node_num * sizeof(double));
+    work[1] = (double *)malloc(node_num * sizeof(double));
+    if (strcmp(solver, "masslump") != 0)
+    {
+        for (k = 2; k < 6; k++)
+            work[k] = (double *)calloc(node_num, sizeof(double));
+    }
+    source_u = (double *)calloc(node_num, sizeof(double));
+    source_w = (double *)calloc(node_num, sizeof(double));
+    seismogram_u = (double *)malloc(rec_num * sizeof(double));
+    seismogram_w = (double *)malloc(rec_num * sizeof(double));
+    illumination = (double *)malloc(node_num * sizeof(double));
+
+    // states 0 (zero) to step - 2, the last one of the time loop of elastic_wave_cpml
+    state_num = step - 1;
+    state_size = (6.0 * node_num + 12.0 * pml_num) * sizeof(double) / 1048576.0;
+    ring_num = 0;
+    action = (int *)malloc(4 * state_num * sizeof(int));
+    action_arg = (int *)malloc(4 * state_num * sizeof(int));
+    printf("\n c-pml nodes is      %d of %d\n", pml_num, node_num);
+    if (reverse == 2)
+    {
+        // the nodes out of the pml with a csr neighbour in it
+        ring_index = (int *)malloc(node_num * sizeof(int));
+        ring_node = (int *)malloc(node_num * sizeof(int));
+        for (i = 0; i < node_num; i++)
+        {
+            ring_index[i] = (pml_index[i] >= 0) ? -2 : -1;
+            for (k = csr_p[i]; k < csr_p[i + 1] && pml_index[i] < 0; k++)
+            {
+                if (pml_index[csr_j[k]] >= 0)
+                {
+                    ring_index[i] = ring_num;
+                    ring_node[ring_num] = i;
+                    ring_num++;
+                    break;
+                }
+            }
+        }
+        ring_value = (double *)calloc(2 * ring_num, sizeof(double));
+        snap_num = 0;
+        stream_size = 2.0 * ring_num * state_num * sizeof(double) / 1048576.0;
+        if (stream_size > checkpoint_memory)
+        {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "ELASTIC_WAVE_REVERSE - Fatal error!\n");
+            fprintf(stderr, "  checkpoint_memory = %f MB does not hold the boundary stream of %f MB.\n", checkpoint_memory, stream_size);
+            exit(1);
+        }
+        if (checkpoint_disk != 1)
+            memory = (double *)malloc((size_t)state_num * 2 * ring_num * sizeof(double));
+        else if ((fp_boundary = fopen("./outputfile/boundary.bin", "wb+")) == NULL)
+        {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "ELASTIC_WAVE_REVERSE - Fatal error!\n");
+            fprintf(stderr, "  Could not open the boundary file \"./outputfile/boundary.bin\".\n");
+            exit(1);
+        }
+        // forward to the last state, then back one state at a time
+        action[0] = 1;
+        action_arg[0] = state_num - 1;
+        action_num = 1;
+        for (k = state_num - 1; k >= 0; k--)
+        {
+            action[action_num] = 4;
+            action_arg[action_num] = k;
+            action_num++;
+            if (k == 0)
+                break;
+            action[action_num] = 5;
+            action_arg[action_num] = k - 1;
+            action_num++;
+        }
+        printf("\n boundary nodes is   %d, %f MB in %s (%f MB for all the states)\n", ring_num, stream_size,
+               (checkpoint_disk == 1) ? "./outputfile" : "memory", state_size * state_num);
+    }
+    else
+    {
+        snap_num = (int)fmin(checkpoint_memory / state_size, (double)state_num);
+        if (snap_num < 1)
+        {
+            fprintf(stderr, "\n");
+            fprintf(stderr, "ELASTIC_WAVE_REVERSE - Fatal error!\n");
+            fprintf(stderr, "  checkpoint_memory = %f MB does not hold one state of %f MB.\n", checkpoint_memory, state_size);
+            exit(1);
+        }
+        if (checkpoint_disk != 1)
+            memory = (double *)malloc((size_t)snap_num * (6 * (size_t)node_num + 12 * (size_t)pml_num) * sizeof(double));
+        slot_state = (int *)malloc(snap_num * sizeof(int));
+        action_num = revolve(0, state_num, 0, snap_num, 0, action, action_arg);
+        printf("\n checkpoints is      %d of %f MB in %s\n", snap_num, state_size, (checkpoint_disk == 1) ? "./outputfile" : "memory");
+    }
+
+    if (adjoint != 0)
+    {
+        for (k = 0; k < 6; k++)
+            lambda[k] = (double *)malloc(node_num * sizeof(double));
+        for (k = 0; k < 12; k++)
+            lambda_psi[k] = (double *)malloc(pml_num * sizeof(double));
+        lambda_work[0] = (double *)malloc(node_num * sizeof(double));
+        lambda_work[1] = (double *)malloc(node_num * sizeof(double));
+        synthetic_u = (double *)calloc((size_t)state_num * rec_num, sizeof(double));
+        synthetic_w = (double *)calloc((size_t)state_num * rec_num, sizeof(double));
+        observed_u = (double *)calloc((size_t)state_num * rec_num, sizeof(double));
+        observed_w = (double *)calloc((size_t)state_num * rec_num, sizeof(double));
+        if (adjoint == 1)
+            image = (double *)calloc(node_num, sizeof(double));
+        for (k = 0; k < 5 && adjoint == 2; k++)
+            gradient[k] = (double *)calloc(node_num, sizeof(double));
+        printf("\n adjoint is          %s of the data in %s\n", (adjoint == 1) ? "image" : "gradients", observed);
+    }
+    misfit_sum = 0.0;
+
+    for (shot = 0; shot < shot_num; shot++)
+    {
+        printf("\n ######## Shot num: %d ########\n", shot + 1);
+
+        sprintf(filename_seismogram_u, "./outputfile/seismogram_u_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_seismogram_w, "./outputfile/seismogram_w_%s_%d.txt", shot_name, shot + 1);
+        sprintf(filename_illumination, "./outputfile/illumination_%s_%d.bin", shot_name, shot + 1);
+        fp_seismogram_u = fopen(filename_seismogram_u, "w");
+        fp_seismogram_w = fopen(filename_seismogram_w, "w");
+
+        for (k = 0; k < 6; k++)
+        {
+            #pragma omp parallel for
+            for (i = 0; i < node_num; i++)
+                field[k][i] = 0.0;
+        }
+        for (k = 0; k < 12; k++)
+        {
+            for (i = 0; i < pml_num; i++)
+                psi[k][i] = 0.0;
+        }
+        for (i = 0; i < node_num; i++)
+            illumination[i] = 0.0;
+        if (reverse == 2)
+        {
+            for (i = 0; i < 2 * ring_num; i++)
+                ring_value[i] = 0.0;
+            boundary_copy(0, 0, 2 * ring_num, ring_value, memory, fp_boundary);
+        }
+        else
+        {
+            for (k = 0; k < 6; k++)
+                array[k] = field[k];
+            checkpoint_copy(0, 0, 18, array_size, array, memory);
+            slot_state[0] = 0;
+        }
+        if (adjoint != 0)
+        {
+            // the data of state n in row n - 1 of the files
+            sprintf(filename_seismogram_u, "%s/seismogram_u_%s_%d.txt", observed, shot_name, shot + 1);
+            sprintf(filename_seismogram_w, "%s/seismogram_w_%s_%d.txt", observed, shot_name, shot + 1);
+            text_read_table(filename_seismogram_u, rec_num, state_num - 1, NULL, observed_u + rec_num);
+            text_read_table(filename_seismogram_w, rec_num, state_num - 1, NULL, observed_w + rec_num);
+            for (k = 0; k < 6; k++)
+            {
+                #pragma omp parallel for
+                for (i = 0; i < node_num; i++)
+                    lambda[k][i] = 0.0;
+            }
+            for (k = 0; k < 12; k++)
+            {
+                for (i = 0; i < pml_num; i++)
+                    lambda_psi[k][i] = 0.0;
+            }
+        }
+        misfit = 0.0;
+        current = 0;
+        reached = 0;
+        forward_num = 0;
+
+        printf("\n****Time iteration begin:\n");
+        for (a = 0; a < action_num; a++)
+        {
+            if (action[a] == 1)
+            {
+                // forward steps up to state action_arg, the time loop of elastic_wave_cpml
+                for (; current < action_arg[a]; current++)
+                {
+                    it = current + 2;
+                    for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+                    {
+                        source_u[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot];
+                        source_w[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot + 1];
+                    }
+                    elastic_cpml_step(node_num, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, cpml_ax, cpml_bx, cpml_ay, cpml_by,
+                                      pml_index, psi, dt, 0, field, work, source_u, source_w, solver, dirichlet_num, dirichlet_node);
+                    forward_num++;
+                    if (reverse == 2)
+                    {
+                        for (i = 0; i < ring_num; i++)
+                        {
+                            ring_value[2 * i] = field[0][ring_node[i]];
+                            ring_value[2 * i + 1] = field[3][ring_node[i]];
+                        }
+                        boundary_copy(0, current + 1, 2 * ring_num, ring_value, memory, fp_boundary);
+                    }
+                    if (current + 1 <= reached)
+                        continue;
+                    reached = current + 1;
+                    if ((it + 1) % 100 == 0)
+                        printf("\n ****Iteration step: %-d, time: %-f s\n ", it + 1, (it + 1) * dt);
+                    for (i = 0; i < rec_num; i++)
+                    {
+                        seismogram_u[i] = 0.0;
+                        seismogram_w[i] = 0.0;
+                        for (k = 0; k < point_order; k++)
+                        {
+                            seismogram_u[i] += rec_weight[i * point_order + k] * field[0][rec_node[i * point_order + k]];
+                            seismogram_w[i] += rec_weight[i * point_order + k] * field[3][rec_node[i * point_order + k]];
+                        }
+                        fprintf(fp_seismogram_u, "%f   ", seismogram_u[i]);
+                        fprintf(fp_seismogram_w, "%f   ", seismogram_w[i]);
+                        if (adjoint != 0)
+                        {
+                            synthetic_u[(size_t)reached * rec_num + i] = seismogram_u[i];
+                            synthetic_w[(size_t)reached * rec_num + i] = seismogram_w[i];
+                        }
+                    }
+                    fprintf(fp_seismogram_u, "\n");
+                    fprintf(fp_seismogram_w, "\n");
+                }
+            }
+            else if (action[a] == 2 || action[a] == 3)
+            {
+                for (k = 0; k < 6; k++)
+                    array[k] = field[k];
+                checkpoint_copy(action[a] - 2, action_arg[a], 18, array_size, array, memory);
+                if (action[a] == 2)
+                    slot_state[action_arg[a]] = current;
+                else
+                    current = slot_state[action_arg[a]];
+            }
+            else if (action[a] == 5)
+            {
+                // back to state action_arg from the boundary stream, state 0 is zero
+                current = action_arg[a];
+                if (current == 0)
+                {
+                    for (k = 0; k < 6; k++)
+                    {
+                        #pragma omp parallel for
+                        for (i = 0; i < node_num; i++)
+                            field[k][i] = 0.0;
+                    }
+                    continue;
+                }
+                it = current + 1;
+                for (k = shot_p[shot]; k < shot_p[shot + 1]; k++)
+                {
+                    source_u[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot];
+                    source_w[inj_node[k]] += inj_weight[k] * wavelet[(size_t)inj_src[k] * step + it] * shot_force[2 * shot + 1];
+                }
+                boundary_copy(1, current - 1, 2 * ring_num, ring_value, memory, fp_boundary);
+                elastic_boundary_step(node_num, csr_p, csr_j, mass_lump, stif_csr_x, c, ring_index, ring_value, dt, field, work,
+                                      source_u, source_w, dirichlet_num, dirichlet_node);
+            }
+            else
+            {
+                // state current, on the way back
+                if (current % 100 == 0)
+                    printf("\n ****Reverse step: %-d\n ", current + 1);
+                if (reverse == 2)
+                {
+                    // the last two states still hold the pml of the forward run
+                    #pragma omp parallel for
+                    for (i = 0; i < node_num; i++)
+                    {
+                        if (pml_index[i] < 0)
+                            continue;
+                        field[0][i] = 0.0;
+                        field[2][i] = 0.0;
+                        field[3][i] = 0.0;
+                        field[5][i] = 0.0;
+                    }
+                }
+                #pragma omp parallel for
+                for (i = 0; i < node_num; i++)
+                    illumination[i] += (field[0][i] * field[0][i] + field[3][i] * field[3][i]) * dt;
+                if (adjoint == 0 || current == 0)
+                    continue;
+
+                // the adjoint of state current, one step with the data of current
+                if (adjoint == 1)
+                {
+                    #pragma omp parallel for
+                    for (i = 0; i < node_num; i++)
+                        image[i] += (field[0][i] * lambda[0][i] + field[3][i] * lambda[3][i]) * dt;
+                }
+                else
+                    elastic_gradient(node_num, csr_p, csr_j, stif_csr_x, field[0], field[3], lambda[0], lambda[3], gradient + 1);
+                for (i = 0; i < rec_num; i++)
+                {
+                    residual_u = observed_u[(size_t)current * rec_num + i];
+                    residual_w = observed_w[(size_t)current * rec_num + i];
+                    if (adjoint == 2)
+                    {
+                        residual_u = synthetic_u[(size_t)current * rec_num + i] - residual_u;
+                        residual_w = synthetic_w[(size_t)current * rec_num + i] - residual_w;
+                        misfit += 0.5 * (residual_u * residual_u + residual_w * residual_w) * dt;
+                    }
+                    for (k = 0; k < point_order; k++)
+                    {
+                        source_u[rec_node[i * point_order + k]] += rec_weight[i * point_order + k] * residual_u * dt;
+                        source_w[rec_node[i * point_order + k]] += rec_weight[i * point_order + k] * residual_w * dt;
+                    }
+                }
+                elastic_cpml_step(node_num, csr_size, csr_p, csr_j, mass_csr_x, mass_lump, stif_csr_x, c, cpml_ax, cpml_bx, cpml_ay, cpml_by,
+                                  pml_index, lambda_psi, dt, 1, lambda, lambda_work, source_u, source_w, solver, dirichlet_num, dirichlet_node);
+                if (adjoint == 2)
+                {
+                    #pragma omp parallel for
+                    for (i = 0; i < node_num; i++)
+                        gradient[0][i] -= (lambda[0][i] * field[2][i] + lambda[3][i] * field[5][i]) * mass_lump[i] / rho[i];
+                }
+            }
+        }
+        printf("\nTime iteration end! %lld forward steps for %d (%f times)\n", forward_num, state_num - 1,
+               (double)forward_num / (state_num - 1));
+        if (adjoint == 2)
+        {
+            printf("\n misfit is           %.12e\n", misfit);
+            misfit_sum += misfit;
+        }
+        fclose(fp_seismogram_u);
+        fclose(fp_seismogram_w);
+
+        if ((fp_illumination = fopen(filename_illumination, "wb")) != NULL)
+        {
+            for (i = 0; i < node_num; i++)
+                fwrite(&illumination[node_new[i]], sizeof(double), 1, fp_illumination);
+            fclose(fp_illumination);
+        }
+    }
+    if (adjoint != 0)
+    {
+        // with reverse = 2 the stiffness of elastic_gradient carries the nodes next to the pml into it
+        for (k = 1; k < 5 && adjoint == 2 && reverse == 2; k++)
+        {
+            for (i = 0; i < node_num; i++)
+            {
+                if (pml_index[i] >= 0)
+                    gradient[k][i] = 0.0;
+            }
+        }
+        sprintf(filename_illumination, "./outputfile/%s.bin", (adjoint == 1) ? "image" : "gradient");
+        if ((fp_adjoint = fopen(filename_illumination, "wb")) != NULL)
+        {
+            for (k = 0; k < ((adjoint == 1) ? 1 : 5); k++)
+            {
+                for (i = 0; i < node_num; i++)
+                    fwrite((adjoint == 1) ? &image[node_new[i]] : &gradient[k][node_new[i]], sizeof(double), 1, fp_adjoint);
+            }
+            fclose(fp_adjoint);
+        }
+        else
+            printf("\n %s could not be written\n", filename_illumination);
+        if (adjoint == 2)
+            printf("\n misfit of the shots is %.12e\n", misfit_sum);
+        for (k = 0; k < 6; k++)
+        {
+            free(lambda[k]);
+            free(lambda_work[k]);
+        }
+        for (k = 0; k < 12; k++)
+            free(lambda_psi[k]);
+        for (k = 0; k < 5 && adjoint == 2; k++)
+            free(gradient[k]);
+        free(synthetic_u);
+        free(synthetic_w);
+        free(observed_u);
+        free(observed_w);
+        free(image);
+    }
+    for (k = 0; k < snap_num && checkpoint_disk == 1; k++)
+    {
+        sprintf(filename_illumination, "./outputfile/checkpoint_%d.bin", k);
+        remove(filename_illumination);
+    }
+    if (fp_boundary != NULL)
+    {
+        fclose(fp_boundary);
+        remove("./outputfile/boundary.bin");
+    }
+    for (k = 0; k < 6; k++)
+    {
+        free(field[k]);
+        free(work[k]);
+    }
+    for (k = 0; k < 12; k++)
+        free(psi[k]);
+    free(pml_index);
+    free(source_u);
+    free(source_w);
+    free(seismogram_u);
+    free(seismogram_w);
+    free(illumination);
+    free(memory);
+    free(slot_state);
+    free(action);
+    free(action_arg);
+    free(ring_index);
+    free(ring_node);
+    free(ring_value);
+}
@@ -0,0 +1,93 @@
+int revolve(int first, int last, int slot, int snap_num, int action_num, int *action, int *action_arg)
+/******************************************************************************/
+/*
+  Purpose:
+
+    revolve appends to action the binomial checkpointing schedule (revolve, Griewank and
+    Walther, 2000) that makes the states first, ..., last - 1 of a time loop current in
+    reverse order, last - 1 first. The state first is current and kept in checkpoint slot,
+    the slots slot + 1 to snap_num - 1 are free. The actions are
+
+      1: advance the current state to state action_arg
+      2: copy the current state to checkpoint action_arg
+      3: make checkpoint action_arg the current state
+      4: the current state is state action_arg, the next one of the reverse sweep
+
+    With c = snap_num - slot checkpoints and r the smallest integer with beta(c, r) >= l, l =
+    last - first, the schedule advances r * l - beta(c + 1, r - 1) steps, the least of any
+    schedule: every range is split at the state the checkpoint of revolve goes to, the end
+    is reversed with one checkpoint less, then the beginning from the restored slot. Called
+    with first = 0 and slot = 0 after the initial state is stored in slot 0, e.g.
+
+      action_num = revolve(0, step_num, 0, snap_num, 0, action, action_arg)
+
+    needs at most 4 * step_num actions.
+
+  Output:
+    action[], action_arg[] from action_num on;
+    the function returns the new number of actions.
+*/
+{
+  int c, r, l, j, split;
+  long long range, bino1, bino2, bino3, bino4, bino5;
+
+  l = last - first;
+  if (l == 1)
+  {
+    action[action_num] = 4;
+    action_arg[action_num] = first;
+    return action_num + 1;
+  }
+  if (slot + 1 >= snap_num)
+  {
+    // no free checkpoint: every state again from the slot
+    for (j = last - 1; j >= first; j--)
+    {
+      if (j < last - 1)
+      {
+        action[action_num] = 3;
+        action_arg[action_num] = slot;
+        action_num++;
+      }
+      if (j > first)
+      {
+        action[action_num] = 1;
+        action_arg[action_num] = j;
+        action_num++;
+      }
+      action[action_num] = 4;
+      action_arg[action_num] = j;
+      action_num++;
+    }
+    return action_num;
+  }
+
+  // split of revolve: beta(c, r - 1), beta(c - 1, r - 1), beta(c - 2, r - 1), beta(c, r - 2), beta(c - 3, r)
+  c = snap_num - slot;
+  r = 0;
+  while (revolve_beta(c, r) < l)
+    r++;
+  range = revolve_beta(c, r);
+  bino1 = revolve_beta(c, r - 1);
+  bino2 = revolve_beta(c - 1, r - 1);
+  bino3 = revolve_beta(c - 2, r - 1);
+  bino4 = revolve_beta(c, r - 2);
+  bino5 = revolve_beta(c - 3, r);
+  if (l <= bino1 + bino3)
+    split = (int)bino4;
+  else if (l >= range - bino5)
+    split = (int)bino1;
+  else
+    split = l - (int)(bino2 + bino3);
+  if (split < 1)
+    split = 1;
+
+  action[action_num] = 1;
+  action_arg[action_num] = first + split;
+  action[action_num + 1] = 2;
+  action_arg[action_num + 1] = slot + 1;
+  action_num = revolve(first + split, last, slot + 1, snap_num, action_num + 2, action, action_arg);
+  action[action_num] = 3;
+  action_arg[action_num] = slot;
+  return revolve(first, first + split, slot, snap_num, action_num + 1, action, action_arg);
+}
@@ -0,0 +1,20 @@
+long long revolve_beta(int c, int r)
+/******************************************************************************/
+/*
+  Purpose:
+
+    revolve_beta is beta(c, r) = (c + r)! / (c! r!), the number of time steps that c
+    checkpoints can reverse with at most r forward sweeps over every step (Griewank, 1992),
+    0 for c < 0 or r < 0.
+*/
+{
+  int k;
+  long long beta;
+
+  if (c < 0 || r < 0)
+    return 0;
+  beta = 1;
+  for (k = 1; k <= r; k++)
+    beta = beta * (c + k) / k;
+  return beta;
+}
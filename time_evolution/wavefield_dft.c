@@ -0,0 +1,40 @@
+void wavefield_dft(int freq_num, double *freq, int dft_num, int *dft_node, int *node_new, double time, double dt, double *U_now, double *W_now,
+                   double *dft)
+/******************************************************************************/
+/*
+  Purpose:
+
+    wavefield_dft adds one time step to the running Fourier transform of u and w,
+
+      U(f) += U_now * exp(-i 2 pi f time) * dt
+
+    at the dft_num nodes of dft_node, numbered as in the mesh files (from 0), for the
+    freq_num frequencies of freq. Called after every update of the time loop, it gives at the
+    end of the shot the monochromatic fields without writing the snapshots.
+
+  Output:
+    dft[((f * 2 + 0 or 1) * dft_num + j) * 2 + 0 or 1]: real and imaginary parts of u (0) and
+    w (1) at node dft_node[j], frequency freq[f].
+*/
+{
+  int f, j, node;
+  double phase_re, phase_im;
+  double *dft_u, *dft_w;
+
+  for (f = 0; f < freq_num; f++)
+  {
+    phase_re = cos(2.0 * 3.1415926535898 * freq[f] * time) * dt;
+    phase_im = -sin(2.0 * 3.1415926535898 * freq[f] * time) * dt;
+    dft_u = dft + (size_t)f * 4 * dft_num;
+    dft_w = dft_u + 2 * (size_t)dft_num;
+    #pragma omp parallel for private(node)
+    for (j = 0; j < dft_num; j++)
+    {
+      node = node_new[dft_node[j]];
+      dft_u[2 * j] += U_now[node] * phase_re;
+      dft_u[2 * j + 1] += U_now[node] * phase_im;
+      dft_w[2 * j] += W_now[node] * phase_re;
+      dft_w[2 * j + 1] += W_now[node] * phase_im;
+    }
+  }
+}
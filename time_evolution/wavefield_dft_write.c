@@ -0,0 +1,33 @@
+void wavefield_dft_write(char *filename, int freq_num, double *freq, int dft_num, int *dft_node, double *dft)
+/******************************************************************************/
+/*
+  Purpose:
+
+    wavefield_dft_write writes the fields of wavefield_dft in binary, native byte order:
+
+      int    freq_num, dft_num
+      double freq[freq_num]
+      int    node[dft_num]                           nodes of the mesh files, from 1
+      double field[freq_num][2][dft_num][2]          u then w of every frequency, complex
+                                                     as real, imaginary
+*/
+{
+  int j, node;
+  FILE *fp_dft;
+
+  if ((fp_dft = fopen(filename, "wb")) == NULL)
+  {
+    printf("\n wavefield dft %s cannot open, the fields are not written\n", filename);
+    return;
+  }
+  fwrite(&freq_num, sizeof(int), 1, fp_dft);
+  fwrite(&dft_num, sizeof(int), 1, fp_dft);
+  fwrite(freq, sizeof(double), freq_num, fp_dft);
+  for (j = 0; j < dft_num; j++)
+  {
+    node = dft_node[j] + 1;
+    fwrite(&node, sizeof(int), 1, fp_dft);
+  }
+  fwrite(dft, sizeof(double), (size_t)freq_num * 4 * dft_num, fp_dft);
+  fclose(fp_dft);
+}
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "../mesh/element_type.c"
+#include "../mesh/mesh_element_order.c"
+#include "../mesh/mesh_binary_layout.c"
+#include "../mesh/mesh_binary_write.c"
+#include "../mesh/text_parse_double.c"
+#include "../mesh/text_read_table.c"
+
+int main(int argc, char *argv[])
+/******************************************************************************/
+/*
+  Purpose:
+
+    mesh_text2bin converts the text mesh of an exterior mesh run (use_exterior_mesh = 1)
+    into the binary mesh read with use_exterior_mesh = 2:
+
+      mesh_dir/element_and_node_num.txt
+      mesh_dir/element_node.txt              ->   mesh_dir/mesh.bin
+      mesh_dir/node_xy.txt
+      mesh_dir/velocity_and_density.txt
+
+    The bounding box is found as seisfem does for text meshes, so both runs are the same.
+    Without element_and_node_num.txt the numbers are counted from the mesh files.
+
+  Usage:
+
+    gcc -O2 -fopenmp -o mesh_text2bin mesh_text2bin.c
+    ./mesh_text2bin type_code [mesh_dir]          mesh_dir = ./mesh by default
+*/
+{
+  int i, j;
+  int type_code;
+  int node_num = 0;
+  int element_num = 0;
+  int element_order;
+  char *type;
+  char *mesh_dir = "./mesh";
+  char filename[256];
+  int *element_node = NULL;
+  double *node_xy[2];
+  double *rho, *vp, *vs, *c[4];
+  double *table = NULL;
+  double xmin = 0.0, xmax = 0.0, ymin = 0.0, ymax = 0.0;
+  FILE *fp;
+
+  if (argc < 2)
+  {
+    printf("\n usage: mesh_text2bin type_code [mesh_dir]\n");
+    return 1;
+  }
+  type_code = atoi(argv[1]);
+  if (argc > 2)
+    mesh_dir = argv[2];
+  type = element_type(type_code);
+  element_order = mesh_element_order(type);
+
+  sprintf(filename, "%s/element_and_node_num.txt", mesh_dir);
+  if ((fp = fopen(filename, "r")) != NULL)
+  {
+    fscanf(fp, "element_num = %d\n", &element_num);
+    fscanf(fp, "node_num = %d\n", &node_num);
+    fclose(fp);
+  }
+  else
+  {
+    sprintf(filename, "%s/element_node.txt", mesh_dir);
+    element_num = text_read_table(filename, element_order, 0, NULL, NULL);
+    sprintf(filename, "%s/node_xy.txt", mesh_dir);
+    node_num = text_read_table(filename, 2, 0, NULL, NULL);
+  }
+
+  element_node = (int *)malloc((size_t)element_num * element_order * sizeof(int));
+  node_xy[0] = (double *)malloc(node_num * sizeof(double));
+  node_xy[1] = (double *)malloc(node_num * sizeof(double));
+  rho = (double *)malloc(node_num * sizeof(double));
+  vp = (double *)malloc(node_num * sizeof(double));
+  vs = (double *)malloc(node_num * sizeof(double));
+  for (i = 0; i < 4; i++)
+    c[i] = (double *)malloc(node_num * sizeof(double));
+
+  table = (double *)malloc(7 * (size_t)node_num * sizeof(double));
+  sprintf(filename, "%s/element_node.txt", mesh_dir);
+  text_read_table(filename, element_order, element_num, element_node, NULL);
+
+  sprintf(filename, "%s/node_xy.txt", mesh_dir);
+  text_read_table(filename, 2, node_num, NULL, table);
+  for (i = 0; i < node_num; i++)
+  {
+    node_xy[0][i] = table[2 * i];
+    node_xy[1][i] = table[2 * i + 1];
+    // same bounding box as seisfem for text meshes, starting from the first node
+    if (i == 0)
+    {
+      xmin = xmax = node_xy[0][0];
+      ymin = ymax = node_xy[1][0];
+    }
+    if (node_xy[0][i] < xmin)
+      xmin = node_xy[0][i];
+    if (node_xy[0][i] > xmax)
+      xmax = node_xy[0][i];
+    if (node_xy[1][i] < ymin)
+      ymin = node_xy[1][i];
+    if (node_xy[1][i] > ymax)
+      ymax = node_xy[1][i];
+  }
+
+  sprintf(filename, "%s/velocity_and_density.txt", mesh_dir);
+  text_read_table(filename, 7, node_num, NULL, table);
+  for (i = 0; i < node_num; i++)
+  {
+    rho[i] = table[7 * i];
+    vp[i] = table[7 * i + 1];
+    vs[i] = table[7 * i + 2];
+    for (j = 0; j < 4; j++)
+      c[j][i] = table[7 * i + 3 + j];
+  }
+  free(table);
+
+  sprintf(filename, "%s/mesh.bin", mesh_dir);
+  if (mesh_binary_write(filename, type_code, node_num, element_num, element_order, element_node, node_xy, xmin, xmax, ymin, ymax, rho, vp, vs, c) == 0)
+    return 1;
+  printf("\n %s: %s, %d elements, %d nodes\n", filename, type, element_num, node_num);
+
+  free(type);
+  free(element_node);
+  free(node_xy[0]);
+  free(node_xy[1]);
+  free(rho);
+  free(vp);
+  free(vs);
+  for (i = 0; i < 4; i++)
+    free(c[i]);
+  return 0;
+}
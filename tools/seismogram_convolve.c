@@ -0,0 +1,195 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include "../mesh/text_parse_double.c"
+#include "../mesh/text_read_table.c"
+#include "../source_receiver/seismic_source.c"
+#include "../source_receiver/source_time_function.c"
+#include "../source_receiver/fft_radix2.c"
+
+int main(int argc, char *argv[])
+/******************************************************************************/
+/*
+  Purpose:
+
+    seismogram_convolve gives the seismograms of a new wavelet from those of a run, without
+    a new simulation. The run fired the reference wavelet s (outputfile/source_wavelet.txt),
+    so its traces are y = g * s; the new traces are g * w, computed for every receiver as
+
+      Y W conj(S) / (|S|^2 + water_level max |S|^2)
+
+    with FFTs of twice the trace length (no wrap around). The best reference is the band-limited
+    impulse of an impulse response run (source_type = 1 in par.txt) with f0 above the band of
+    the new wavelets, but the Ricker wavelet of any run can be replaced inside its band too.
+
+  Usage:
+
+    gcc -O2 -fopenmp -o seismogram_convolve seismogram_convolve.c -lm
+    ./seismogram_convolve seismogram.txt source_wavelet.txt out.txt ricker f0 t0 [water_level]
+    ./seismogram_convolve seismogram.txt source_wavelet.txt out.txt file wavelet.txt [water_level]
+
+    ricker : Ricker wavelet of f0 and t0 with the magnitude seisfem uses, so out.txt is the
+             seismogram of a run with these f0 and t0;
+    file   : wavelet.txt as source_wavelet.txt, time and value on the rows of the seismograms;
+    water_level = 1.0e-6 by default.
+*/
+{
+  int i, k, row_num, rec_num, nfft;
+  double f0, t0, water_level = 1.0e-6;
+  double s_max, s_abs, denominator, temp;
+  double *reference = NULL;
+  double *wavelet = NULL;
+  double *trace = NULL;
+  double *filter_re = NULL, *filter_im = NULL;
+  double *s_re = NULL, *s_im = NULL, *w_re = NULL, *w_im = NULL;
+  char *line = NULL;
+  size_t line_size = 0;
+  char *p;
+  FILE *fp;
+
+  if (argc < 6 || (strcmp(argv[4], "ricker") == 0 && argc < 7))
+  {
+    printf("\n usage: seismogram_convolve seismogram.txt source_wavelet.txt out.txt ricker f0 t0 [water_level]\n");
+    printf("        seismogram_convolve seismogram.txt source_wavelet.txt out.txt file wavelet.txt [water_level]\n");
+    return 1;
+  }
+
+  // reference wavelet: time, value on every row of the seismograms
+  row_num = text_read_table(argv[2], 2, 0, NULL, NULL);
+  reference = (double *)malloc(2 * (size_t)row_num * sizeof(double));
+  text_read_table(argv[2], 2, row_num, NULL, reference);
+
+  // new wavelet on the same times
+  wavelet = (double *)malloc(2 * (size_t)row_num * sizeof(double));
+  if (strcmp(argv[4], "ricker") == 0)
+  {
+    f0 = atof(argv[5]);
+    t0 = atof(argv[6]);
+    if (argc > 7)
+      water_level = atof(argv[7]);
+    for (i = 0; i < row_num; i++)
+      wavelet[2 * i + 1] = source_time_function(0, f0, t0, 1.0e10, reference[2 * i]);
+  }
+  else if (strcmp(argv[4], "file") == 0)
+  {
+    if (argc > 6)
+      water_level = atof(argv[6]);
+    text_read_table(argv[5], 2, row_num, NULL, wavelet);
+  }
+  else
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISMOGRAM_CONVOLVE - Fatal error!\n");
+    fprintf(stderr, "  Unknown wavelet \"%s\", use ricker or file.\n", argv[4]);
+    exit(1);
+  }
+
+  // receivers: the numbers on the first line of the seismogram
+  if ((fp = fopen(argv[1], "r")) == NULL || getline(&line, &line_size, fp) < 0)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISMOGRAM_CONVOLVE - Fatal error!\n");
+    fprintf(stderr, "  Can not read %s.\n", argv[1]);
+    exit(1);
+  }
+  fclose(fp);
+  rec_num = 0;
+  for (p = strtok(line, " \t\r\n"); p != NULL; p = strtok(NULL, " \t\r\n"))
+    rec_num++;
+  free(line);
+  trace = (double *)malloc((size_t)row_num * rec_num * sizeof(double));
+  text_read_table(argv[1], rec_num, row_num, NULL, trace);
+
+  // filter W conj(S) / (|S|^2 + water_level max |S|^2)
+  nfft = 1;
+  while (nfft < 2 * row_num)
+    nfft = 2 * nfft;
+  s_re = (double *)calloc(nfft, sizeof(double));
+  s_im = (double *)calloc(nfft, sizeof(double));
+  w_re = (double *)calloc(nfft, sizeof(double));
+  w_im = (double *)calloc(nfft, sizeof(double));
+  filter_re = (double *)malloc(nfft * sizeof(double));
+  filter_im = (double *)malloc(nfft * sizeof(double));
+  for (i = 0; i < row_num; i++)
+  {
+    s_re[i] = reference[2 * i + 1];
+    w_re[i] = wavelet[2 * i + 1];
+  }
+  fft_radix2(nfft, s_re, s_im, -1);
+  fft_radix2(nfft, w_re, w_im, -1);
+  s_max = 0.0;
+  for (k = 0; k < nfft; k++)
+  {
+    s_abs = s_re[k] * s_re[k] + s_im[k] * s_im[k];
+    if (s_abs > s_max)
+      s_max = s_abs;
+  }
+  for (k = 0; k < nfft; k++)
+  {
+    denominator = (s_re[k] * s_re[k] + s_im[k] * s_im[k] + water_level * s_max) * nfft;
+    filter_re[k] = (w_re[k] * s_re[k] + w_im[k] * s_im[k]) / denominator;
+    filter_im[k] = (w_im[k] * s_re[k] - w_re[k] * s_im[k]) / denominator;
+  }
+
+  #pragma omp parallel private(i, k, temp)
+  {
+    double *y_re = (double *)malloc(nfft * sizeof(double));
+    double *y_im = (double *)malloc(nfft * sizeof(double));
+    int rec;
+
+    #pragma omp for
+    for (rec = 0; rec < rec_num; rec++)
+    {
+      for (i = 0; i < nfft; i++)
+      {
+        y_re[i] = (i < row_num) ? trace[(size_t)i * rec_num + rec] : 0.0;
+        y_im[i] = 0.0;
+      }
+      fft_radix2(nfft, y_re, y_im, -1);
+      for (k = 0; k < nfft; k++)
+      {
+        temp = y_re[k] * filter_re[k] - y_im[k] * filter_im[k];
+        y_im[k] = y_re[k] * filter_im[k] + y_im[k] * filter_re[k];
+        y_re[k] = temp;
+      }
+      fft_radix2(nfft, y_re, y_im, 1);
+      for (i = 0; i < row_num; i++)
+        trace[(size_t)i * rec_num + rec] = y_re[i];
+    }
+    free(y_re);
+    free(y_im);
+  }
+
+  if ((fp = fopen(argv[3], "w")) == NULL)
+  {
+    fprintf(stderr, "\n");
+    fprintf(stderr, "SEISMOGRAM_CONVOLVE - Fatal error!\n");
+    fprintf(stderr, "  Can not open %s.\n", argv[3]);
+    exit(1);
+  }
+  for (i = 0; i < row_num; i++)
+  {
+    for (k = 0; k < rec_num; k++)
+      fprintf(fp, "%f   ", trace[(size_t)i * rec_num + k]);
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+  printf("\n %s: %d receivers, %d samples, fft size %d\n", argv[3], rec_num, row_num, nfft);
+
+  free(reference);
+  free(wavelet);
+  free(trace);
+  free(s_re);
+  free(s_im);
+  free(w_re);
+  free(w_im);
+  free(filter_re);
+  free(filter_im);
+  return 0;
+}